@@ -11,3 +11,4 @@ option(NO_EXAMPLES "Don't configure examples" Off)
 option(NO_TESTS "Don't configure tests." Off)
 
 option(WITH_CLANG_TIDY "Configure with clang-tidy checks." Off)
+option(WITH_ALLOCATION_STACKS "Capture sampled allocation stack traces." Off)
@@ -0,0 +1,105 @@
+/// @example eagine/flat_map_benchmark.cpp
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+import eagine.core;
+import std;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+constexpr const std::size_t lookup_count{1'000'000U};
+//------------------------------------------------------------------------------
+// Measures the time of looking up random keys, about half of which are
+// present in the map. The found values are summed so that the lookups
+// cannot be optimized out.
+template <typename Find>
+auto lookups(const std::vector<identifier_t>& keys, Find find)
+  -> std::tuple<std::chrono::duration<float>, std::uint64_t> {
+    std::minstd_rand rng{std::uint_fast32_t(keys.size())};
+    std::vector<identifier_t> probes;
+    probes.reserve(lookup_count);
+    for(std::size_t i = 0; i < lookup_count; ++i) {
+        const auto key{keys[rng() % keys.size()]};
+        probes.push_back((rng() % 2U) ? key : key + 1U);
+    }
+
+    std::uint64_t sum{0U};
+    const auto start{std::chrono::steady_clock::now()};
+    for(const auto key : probes) {
+        sum += find(key);
+    }
+    return {std::chrono::steady_clock::now() - start, sum};
+}
+//------------------------------------------------------------------------------
+void report(
+  const console& cio,
+  const string_view kind,
+  std::size_t size,
+  std::tuple<std::chrono::duration<float>, std::uint64_t> result) {
+    const auto [time, sum] = result;
+    cio.print("map", "${kind} with ${size} keys: ${ns} ns/lookup (${sum})")
+      .arg("kind", kind)
+      .arg("size", size)
+      .arg("ns", time.count() * 1e9F / float(lookup_count))
+      .arg("sum", sum);
+}
+//------------------------------------------------------------------------------
+auto main(main_ctx& ctx) -> int {
+    const auto& cio{ctx.cio()};
+    std::mt19937_64 rng{12345U};
+
+    for(const std::size_t size : {8U, 64U, 512U, 4'096U, 32'768U, 262'144U}) {
+        // even keys, so that key + 1 is never in the maps
+        std::vector<identifier_t> keys;
+        keys.reserve(size);
+        std::vector<std::pair<identifier_t, std::uint64_t>> elements;
+        elements.reserve(size);
+        for(std::size_t i = 0; i < size; ++i) {
+            keys.push_back(rng() & ~identifier_t(1U));
+            elements.emplace_back(keys.back(), i + 1U);
+        }
+
+        {
+            const std::vector<std::pair<const identifier_t, std::uint64_t>>
+              init{elements.begin(), elements.end()};
+            const flat_map<identifier_t, std::uint64_t> m{init};
+            report(cio, "flat_map", size, lookups(keys, [&](auto key) {
+                       const auto pos{m.find(key)};
+                       return pos != m.end() ? pos->second : 0U;
+                   }));
+        }
+        {
+            const eytzinger_map<identifier_t, std::uint64_t> m{elements};
+            report(cio, "eytzinger_map", size, lookups(keys, [&](auto key) {
+                       return m.find(key).value_or(0U);
+                   }));
+        }
+        {
+            const std::map<identifier_t, std::uint64_t> m{
+              elements.begin(), elements.end()};
+            report(cio, "std::map", size, lookups(keys, [&](auto key) {
+                       const auto pos{m.find(key)};
+                       return pos != m.end() ? pos->second : 0U;
+                   }));
+        }
+        {
+            const std::unordered_map<identifier_t, std::uint64_t> m{
+              elements.begin(), elements.end()};
+            report(
+              cio, "std::unordered_map", size, lookups(keys, [&](auto key) {
+                  const auto pos{m.find(key)};
+                  return pos != m.end() ? pos->second : 0U;
+              }));
+        }
+    }
+    return 0;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
+
+auto main(int argc, const char** argv) -> int {
+    return eagine::default_main(argc, argv, eagine::main);
+}
@@ -0,0 +1,109 @@
+/// @example eagine/object_pool_benchmark.cpp
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+import eagine.core;
+import std;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+constexpr const std::size_t churn_count{100'000U};
+//------------------------------------------------------------------------------
+struct pooled_thing {
+    std::array<std::uint64_t, 4> data{};
+
+    pooled_thing(std::uint64_t value) noexcept {
+        data.fill(value);
+    }
+};
+//------------------------------------------------------------------------------
+// Fills the pool with the specified number of live objects and then measures
+// the time of replacing randomly chosen live objects (one eat and one make).
+template <typename Make, typename Eat>
+auto churn(std::size_t live_count, Make make, Eat eat)
+  -> std::chrono::duration<float> {
+    std::vector<pooled_thing*> live;
+    live.reserve(live_count);
+    std::minstd_rand rng{std::uint_fast32_t(live_count)};
+
+    for(std::size_t i = 0; i < live_count; ++i) {
+        live.push_back(&make(i));
+    }
+    const auto start{std::chrono::steady_clock::now()};
+    for(std::size_t i = 0; i < churn_count; ++i) {
+        auto& slot{live[rng() % live_count]};
+        eat(*slot);
+        slot = &make(i);
+    }
+    const auto time{std::chrono::steady_clock::now() - start};
+    for(auto* thing : live) {
+        eat(*thing);
+    }
+    return time;
+}
+//------------------------------------------------------------------------------
+void report(
+  const console& cio,
+  const string_view kind,
+  std::size_t live_count,
+  std::chrono::duration<float> time) {
+    cio.print("pool", "${kind} with ${count} live: ${ns} ns/replace")
+      .arg("kind", kind)
+      .arg("count", live_count)
+      .arg("ns", time.count() * 1e9F / float(churn_count));
+}
+//------------------------------------------------------------------------------
+auto main(main_ctx& ctx) -> int {
+    const auto& cio{ctx.cio()};
+
+    for(const std::size_t live_count : {10'000U, 100'000U, 1'000'000U}) {
+        // the original pool does linear searches on make and eat,
+        // filling it with a million objects takes too long
+        if(live_count <= 100'000U) {
+            object_pool<pooled_thing, 256> pool;
+            report(
+              cio,
+              "object_pool",
+              live_count,
+              churn(
+                live_count,
+                [&](std::size_t i) -> pooled_thing& { return pool.make(i); },
+                [&](const pooled_thing& t) { pool.eat(t); }));
+        }
+        {
+            slab_object_pool<pooled_thing, 256> pool;
+            report(
+              cio,
+              "slab_object_pool",
+              live_count,
+              churn(
+                live_count,
+                [&](std::size_t i) -> pooled_thing& { return pool.make(i); },
+                [&](const pooled_thing& t) { pool.eat(t); }));
+        }
+        {
+            slab_object_pool<pooled_thing, 256, true> pool;
+            decltype(pool)::front_cache cache{pool};
+            report(
+              cio,
+              "slab_object_pool+cache",
+              live_count,
+              churn(
+                live_count,
+                [&](std::size_t i) -> pooled_thing& {
+                    return pool.make(cache, i);
+                },
+                [&](const pooled_thing& t) { pool.eat(cache, t); }));
+        }
+    }
+    return 0;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
+
+auto main(int argc, const char** argv) -> int {
+    return eagine::default_main(argc, argv, eagine::main);
+}
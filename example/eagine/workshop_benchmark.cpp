@@ -0,0 +1,135 @@
+/// @example eagine/workshop_benchmark.cpp
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+import eagine.core;
+import std;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+constexpr const std::size_t unit_count{100'000U};
+constexpr const unsigned unit_steps{500U};
+//------------------------------------------------------------------------------
+// Fine-grained work unit, optionally splitting the range of units assigned
+// to it in halves and enqueuing the second half as a new unit.
+struct benchmark_unit : latched_work_unit {
+    benchmark_unit(
+      workshop& w,
+      std::latch& l,
+      std::vector<benchmark_unit>& units,
+      std::size_t index,
+      std::size_t end) noexcept
+      : latched_work_unit{l}
+      , _workshop{&w}
+      , _units{&units}
+      , _index{index}
+      , _end{end} {}
+
+    auto do_it() noexcept -> bool final {
+        while(_end - _index > 1U) {
+            const auto middle{_index + (_end - _index) / 2U};
+            _workshop->enqueue((*_units)[middle].split(_end));
+            _end = middle;
+        }
+        std::uint64_t state{_index};
+        for(unsigned i = 0; i < unit_steps; ++i) {
+            state = state * 6364136223846793005U + 1442695040888963407U;
+        }
+        result = state;
+        return true;
+    }
+
+    auto split(std::size_t end) noexcept -> benchmark_unit& {
+        _end = end;
+        return *this;
+    }
+
+    std::uint64_t result{0U};
+
+private:
+    workshop* _workshop;
+    std::vector<benchmark_unit>* _units;
+    std::size_t _index;
+    std::size_t _end;
+};
+//------------------------------------------------------------------------------
+// Returns the best time of a few runs of all units.
+auto measure(workshop_scheduling scheduling, span_size_t workers, bool forked)
+  -> std::chrono::duration<float> {
+    workshop ws{scheduling};
+    ws.ensure_workers(workers);
+
+    std::chrono::duration<float> best{std::numeric_limits<float>::max()};
+    for(int run = 0; run < 5; ++run) {
+        std::latch completed{limit_cast<std::ptrdiff_t>(unit_count)};
+        std::vector<benchmark_unit> units;
+        units.reserve(unit_count);
+        for(std::size_t i = 0; i < unit_count; ++i) {
+            units.emplace_back(ws, completed, units, i, i + 1U);
+        }
+
+        const auto start{std::chrono::steady_clock::now()};
+        if(forked) {
+            ws.enqueue(units.front().split(unit_count));
+        } else {
+            for(auto& unit : units) {
+                ws.enqueue(unit);
+            }
+        }
+        completed.wait();
+        best = std::min(best, std::chrono::duration<float>{
+                                std::chrono::steady_clock::now() - start});
+    }
+    return best;
+}
+//------------------------------------------------------------------------------
+auto main(main_ctx& ctx) -> int {
+    const auto& cio{ctx.cio()};
+
+    std::vector<span_size_t> worker_counts;
+    const auto max_workers{span_size(std::thread::hardware_concurrency())};
+    for(span_size_t n = 1; n < max_workers; n *= 2) {
+        worker_counts.push_back(n);
+    }
+    worker_counts.push_back(std::max(max_workers, span_size(1)));
+
+    for(const bool forked : {false, true}) {
+        for(const auto scheduling :
+            {workshop_scheduling::shared_queue,
+             workshop_scheduling::work_stealing}) {
+            const auto kind{
+              scheduling == workshop_scheduling::work_stealing
+                ? string_view{"work-stealing"}
+                : string_view{"shared-queue"}};
+            std::chrono::duration<float> single{};
+            for(const auto workers : worker_counts) {
+                const auto time{measure(scheduling, workers, forked)};
+                if(workers == 1) {
+                    single = time;
+                }
+                cio
+                  .print(
+                    "workshop",
+                    "${kind}/${mode} with ${workers} workers: "
+                    "${rate} units/s, speedup ${speedup}")
+                  .arg("kind", kind)
+                  .arg(
+                    "mode",
+                    forked ? string_view{"forked"} : string_view{"external"})
+                  .arg("workers", workers)
+                  .arg("rate", float(unit_count) / time.count())
+                  .arg("speedup", single / time);
+            }
+        }
+    }
+    return 0;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
+
+auto main(int argc, const char** argv) -> int {
+    return eagine::default_main(argc, argv, eagine::main);
+}
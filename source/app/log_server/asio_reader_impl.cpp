@@ -11,6 +11,7 @@ module;
 #include <asio/ip/tcp.hpp>
 #include <asio/local/stream_protocol.hpp>
 #include <asio/signal_set.hpp>
+#include <asio/strand.hpp>
 
 module eagine.core.log_server;
 
@@ -38,12 +39,17 @@ public:
     void start();
 
 private:
+    static constexpr const span_size_t _min_chunk_size{4 * 1024};
+    static constexpr const span_size_t _max_chunk_size{1024 * 1024};
+
     void _read();
+    void _adapt_chunk_size(const span_size_t) noexcept;
 
     asio_reader_base<Acceptor, Socket>& _parent;
     Socket _socket;
     parser_input _sink;
-    std::array<char, 1024> _chunk{};
+    memory::buffer _chunk;
+    span_size_t _short_reads{0};
 };
 //------------------------------------------------------------------------------
 // Acceptor base
@@ -63,22 +69,29 @@ public:
 
     void on_read(std::size_t) noexcept;
 
+    auto get_buffer(const span_size_t size) noexcept -> memory::buffer;
+    void eat_buffer(memory::buffer) noexcept;
+
 protected:
     void _accept();
     void _update_later();
     void _notify_later();
+    auto _run_single() -> bool;
+    auto _run_pool() -> bool;
+    void _run_worker() noexcept;
 
     watched_process_lifetime _alive;
     shared_holder<stream_sink_factory> _factory;
-    asio::io_context _io{};
+    const span_size_t _thread_count;
+    asio::io_context _io{int(_thread_count)};
     asio::signal_set _signals{_io, SIGINT, SIGTERM};
     asio::steady_timer _update_timer{_io};
     asio::steady_timer _alive_timer{_io};
     Acceptor _acceptor;
-    Socket _socket{_io};
     resetting_timeout _should_heartbeat{std::chrono::minutes{1}};
-    std::size_t _batch_count{0U};
-    std::size_t _batch_read{0U};
+    std::atomic<std::size_t> _total_read{0U};
+    std::mutex _buffers_mutex;
+    memory::buffer_pool _buffers;
 };
 //------------------------------------------------------------------------------
 template <typename Acceptor, typename Socket>
@@ -87,15 +100,45 @@ void asio_reader_stream<Acceptor, Socket>::start() {
 }
 //------------------------------------------------------------------------------
 template <typename Acceptor, typename Socket>
+void asio_reader_stream<Acceptor, Socket>::_adapt_chunk_size(
+  const span_size_t size) noexcept {
+    // grow quickly when the reads fill the whole chunk and shrink slowly
+    // after a longer run of reads using only a small part of it
+    auto new_size{_chunk.size()};
+    if(size == _chunk.size()) {
+        new_size = std::min(_chunk.size() * 2, _max_chunk_size);
+        _short_reads = 0;
+    } else if(size < _chunk.size() / 4) {
+        if(++_short_reads >= 16) {
+            new_size = std::max(_chunk.size() / 2, _min_chunk_size);
+            _short_reads = 0;
+        }
+    } else {
+        _short_reads = 0;
+    }
+    if(new_size != _chunk.size()) {
+        _parent.eat_buffer(std::move(_chunk));
+        _chunk = _parent.get_buffer(new_size);
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Acceptor, typename Socket>
 void asio_reader_stream<Acceptor, Socket>::_read() {
     auto self{this->shared_from_this()};
     _socket.async_read_some(
-      asio::buffer(_chunk.data(), _chunk.size()),
+      asio::buffer(_chunk.data(), std_size(_chunk.size())),
       [this, self](std::error_code error, std::size_t size) {
           if(not error) {
-              _sink.consume_text(head(view(_chunk), span_size(size)));
+              // the parser consumes the received data in-place
+              const bool parsed{
+                _sink.consume_data(head(view(_chunk), span_size(size)))};
               _parent.on_read(size);
-              _read();
+              // stop reading a stream that cannot be parsed, the stream
+              // sink is finished when the last reference goes away
+              if(parsed) {
+                  _adapt_chunk_size(span_size(size));
+                  _read();
+              }
           }
       });
 }
@@ -107,21 +150,26 @@ asio_reader_stream<Acceptor, Socket>::asio_reader_stream(
   parser_input sink) noexcept
   : _parent{parent}
   , _socket{std::move(socket)}
-  , _sink{std::move(sink)} {}
+  , _sink{std::move(sink)}
+  , _chunk{_parent.get_buffer(_min_chunk_size)} {}
 //------------------------------------------------------------------------------
 template <typename Acceptor, typename Socket>
 asio_reader_stream<Acceptor, Socket>::~asio_reader_stream() noexcept {
     _sink.finish();
+    _parent.eat_buffer(std::move(_chunk));
 }
 //------------------------------------------------------------------------------
 template <typename Acceptor, typename Socket>
 void asio_reader_base<Acceptor, Socket>::_accept() {
-    _acceptor.async_accept(_socket, [this](std::error_code error) {
+    // each stream gets its own strand, so reading and parsing of a single
+    // stream is serialized while different streams run on the whole pool
+    auto socket{std::make_shared<Socket>(asio::make_strand(_io))};
+    _acceptor.async_accept(*socket, [this, socket](std::error_code error) {
         if(not error) {
             log_info("starting new log stream");
             std::make_shared<asio_reader_stream<Acceptor, Socket>>(
               *this,
-              std::move(_socket),
+              std::move(*socket),
               make_data_parser(main_context(), _factory->make_stream()))
               ->start();
             _factory->update();
@@ -164,6 +212,7 @@ asio_reader_base<Acceptor, Socket>::asio_reader_base(
   : main_ctx_object{id, ctx}
   , _alive{ctx.watchdog().start_watch()}
   , _factory{std::move(factory)}
+  , _thread_count{reader_thread_count(ctx)}
   , _acceptor{_io, std::move(endpoint)} {
 
     _signals.async_wait([&](auto, auto) { _io.stop(); });
@@ -176,26 +225,76 @@ template <typename Acceptor, typename Socket>
 void asio_reader_base<Acceptor, Socket>::on_read(std::size_t size) noexcept {
     const std::size_t batch{1024U * 1024U * 1024U};
 
-    _batch_read += size;
-    if(_batch_read > batch) {
-        _batch_read -= batch;
-        ++_batch_count;
+    const auto total{_total_read.fetch_add(size) + size};
+    if((total - size) / batch < total / batch) {
         log_stat("read ${count} * ${batch} of log data")
           .tag("readBytes")
-          .arg("count", _batch_count)
+          .arg("count", total / batch)
           .arg("batch", "ByteSize", batch);
     }
     _factory->update();
 }
 //------------------------------------------------------------------------------
 template <typename Acceptor, typename Socket>
+auto asio_reader_base<Acceptor, Socket>::get_buffer(
+  const span_size_t size) noexcept -> memory::buffer {
+    const std::lock_guard<std::mutex> lock{_buffers_mutex};
+    return _buffers.get(size);
+}
+//------------------------------------------------------------------------------
+template <typename Acceptor, typename Socket>
+void asio_reader_base<Acceptor, Socket>::eat_buffer(
+  memory::buffer used) noexcept {
+    const std::lock_guard<std::mutex> lock{_buffers_mutex};
+    _buffers.eat(std::move(used));
+}
+//------------------------------------------------------------------------------
+template <typename Acceptor, typename Socket>
+auto asio_reader_base<Acceptor, Socket>::_run_single() -> bool {
+    while(not _io.stopped()) {
+        _io.run_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+template <typename Acceptor, typename Socket>
+void asio_reader_base<Acceptor, Socket>::_run_worker() noexcept {
+    while(not _io.stopped()) {
+        try {
+            _io.run();
+        } catch(std::exception& error) {
+            log_error("ASIO reader worker error: ${what}")
+              .arg("what", error.what());
+        }
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Acceptor, typename Socket>
+auto asio_reader_base<Acceptor, Socket>::_run_pool() -> bool {
+    log_info("running reader on ${count} threads")
+      .tag("thrdCount")
+      .arg("count", _thread_count);
+
+    std::vector<std::thread> workers;
+    workers.reserve(std_size(_thread_count - 1));
+    for(span_size_t i = 1; i < _thread_count; ++i) {
+        workers.emplace_back([this] { _run_worker(); });
+    }
+    _run_worker();
+    for(auto& worker : workers) {
+        worker.join();
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+template <typename Acceptor, typename Socket>
 auto asio_reader_base<Acceptor, Socket>::run() noexcept -> bool {
     try {
-        while(not _io.stopped()) {
-            _io.run_one();
-            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        if(_thread_count > 1) {
+            return _run_pool();
         }
-        return true;
+        return _run_single();
     } catch(std::exception& error) {
         log_error("ASIO reader error: ${what}").arg("what", error.what());
         return false;
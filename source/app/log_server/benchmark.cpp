@@ -0,0 +1,776 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/read.hpp>
+#include <asio/read_until.hpp>
+#include <asio/streambuf.hpp>
+#include <asio/write.hpp>
+
+import std;
+import eagine.core;
+import eagine.core.log_server;
+
+//------------------------------------------------------------------------------
+// allocation counting
+//------------------------------------------------------------------------------
+// only the allocations done by the ingesting thread are counted, so that
+// the helper threads (like the null HTTP endpoint) do not skew the results
+static thread_local std::size_t allocation_count{0U};
+
+auto operator new(std::size_t size) -> void* {
+    ++allocation_count;
+    if(void* ptr{std::malloc(size ? size : 1U)}) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace eagine::logs {
+//------------------------------------------------------------------------------
+// synthetic log stream
+//------------------------------------------------------------------------------
+static auto make_synthetic_log(const span_size_t message_count) -> std::string {
+    static constexpr const std::array<string_view, 5> sources{
+      "LogSrvBnch", "Renderer", "MsgBus", "Resources", "AppMain"};
+
+    std::string result;
+    result.reserve(std_size(message_count) * 224U);
+    auto out{std::back_inserter(result)};
+
+    result.append(
+      R"([{"t":"begin","time":"2024-01-01 00:00:00",)"
+      R"("session":"benchmark","identity":"LogSrvBnch"})");
+
+    for(span_size_t i = 0; i < message_count; ++i) {
+        const float ts{float(i) * 0.0001F};
+        const auto iid{1000 + (i % 7)};
+        const auto src{sources[std_size(i) % sources.size()]};
+
+        if(i % 1024 == 0) {
+            std::format_to(out, "\n,{{\"t\":\"hb\",\"ts\":{}}}", ts);
+        }
+        if(i % 64 == 0) {
+            std::format_to(
+              out,
+              "\n,{{\"t\":\"i\",\"iid\":{},\"tag\":\"frameTime\",\"tns\":{}}}",
+              iid,
+              16000000 + (i % 997) * 1000);
+        }
+
+        switch(i % 4) {
+            case 0:
+                std::format_to(
+                  out,
+                  "\n,{{\"t\":\"m\",\"lvl\":\"info\",\"src\":\"{}\","
+                  "\"tag\":\"itemCount\",\"iid\":{},\"ts\":{},"
+                  "\"f\":\"processed ${{count}} items of ${{name}}\","
+                  "\"a\":[null,{{\"n\":\"count\",\"t\":\"int\",\"v\":{}}},"
+                  "{{\"n\":\"name\",\"t\":\"str\",\"v\":\"item-{}\"}}]}}",
+                  src,
+                  iid,
+                  ts,
+                  i,
+                  i % 97);
+                break;
+            case 1:
+                std::format_to(
+                  out,
+                  "\n,{{\"t\":\"m\",\"lvl\":\"stat\",\"src\":\"{}\","
+                  "\"tag\":\"progress\",\"iid\":{},\"ts\":{},"
+                  "\"f\":\"loading ${{progress}}\","
+                  "\"a\":[null,{{\"n\":\"progress\",\"t\":\"Progress\","
+                  "\"v\":{},\"min\":0,\"max\":1}}]}}",
+                  src,
+                  iid,
+                  ts,
+                  float(i % 100) / 100.F);
+                break;
+            case 2:
+                std::format_to(
+                  out,
+                  "\n,{{\"t\":\"m\",\"lvl\":\"debug\",\"src\":\"{}\","
+                  "\"tag\":\"taskDone\",\"iid\":{},\"ts\":{},"
+                  "\"f\":\"task finished in ${{elapsed}} (${{done}})\","
+                  "\"a\":[null,{{\"n\":\"elapsed\",\"t\":\"duration\","
+                  "\"u\":\"s\",\"v\":{}}},"
+                  "{{\"n\":\"done\",\"t\":\"bool\",\"v\":{}}}]}}",
+                  src,
+                  iid,
+                  ts,
+                  float(i % 13) * 0.01F,
+                  i % 3 != 0);
+                break;
+            default:
+                std::format_to(
+                  out,
+                  "\n,{{\"t\":\"m\",\"lvl\":\"warning\",\"src\":\"{}\","
+                  "\"tag\":\"stateChng\",\"iid\":{},\"ts\":{},"
+                  "\"f\":\"state ${{state}} after ${{count}} events\","
+                  "\"a\":[null,{{\"n\":\"state\",\"t\":\"Identifier\","
+                  "\"v\":\"running\"}},"
+                  "{{\"n\":\"count\",\"t\":\"uint\",\"v\":{}}}]}}",
+                  src,
+                  iid,
+                  ts,
+                  std::uint64_t(i) * 17U);
+                break;
+        }
+    }
+    std::format_to(
+      out,
+      "\n,{{\"t\":\"end\",\"ts\":{}}}]",
+      float(message_count) * 0.0001F);
+    return result;
+}
+//------------------------------------------------------------------------------
+// null text output
+//------------------------------------------------------------------------------
+class null_text_output final : public text_output {
+public:
+    void write(const string_view) noexcept final {}
+    void flush() noexcept final {}
+};
+//------------------------------------------------------------------------------
+// null stream sink
+//------------------------------------------------------------------------------
+class null_stream_sink final : public stream_sink {
+public:
+    void consume(const begin_info&) noexcept final {}
+    void consume(const description_info&) noexcept final {}
+    void consume(const declare_state_info&) noexcept final {}
+    void consume(const active_state_info&) noexcept final {}
+    void consume(const message_info&) noexcept final {}
+    void consume(const interval_info&) noexcept final {}
+    void consume(const chart_info&) noexcept final {}
+    void consume(const heartbeat_info&) noexcept final {}
+    void consume(const finish_info&) noexcept final {}
+};
+//------------------------------------------------------------------------------
+class null_stream_sink_factory final : public stream_sink_factory {
+public:
+    auto make_stream() noexcept -> unique_holder<stream_sink> final {
+        return {hold<null_stream_sink>};
+    }
+
+    void update() noexcept final {}
+};
+//------------------------------------------------------------------------------
+// libpq stand-in sink
+//------------------------------------------------------------------------------
+// Formats the entries into text statement parameters and collects them in
+// batches like the batched libpq sink does, but discards the batches instead
+// of sending them to a database server.
+class libpq_standin_sink final : public stream_sink {
+public:
+    libpq_standin_sink(const span_size_t batch_size) noexcept
+      : _batch_size{batch_size} {}
+
+    void consume(const begin_info& info) noexcept final {
+        _row(string_view{info.session}, string_view{info.identity});
+    }
+
+    void consume(const description_info& info) noexcept final {
+        _row(
+          info.source,
+          info.instance,
+          string_view{info.display_name},
+          string_view{info.description});
+    }
+
+    void consume(const declare_state_info& info) noexcept final {
+        _row(
+          info.source,
+          info.instance,
+          info.state_tag,
+          info.begin_tag,
+          info.end_tag);
+    }
+
+    void consume(const active_state_info& info) noexcept final {
+        _row(info.source, info.instance, info.tag);
+    }
+
+    void consume(const message_info& info) noexcept final {
+        _row(
+          info.source,
+          info.instance,
+          enumerator_name(info.severity),
+          info.tag,
+          info.format,
+          info.offset);
+        for(const auto& arg : info.args) {
+            std::visit(
+              [&](const auto& value) { _row(arg.name, arg.tag, value); },
+              arg.value);
+            if(arg.min and arg.max) {
+                _row(arg.name, *arg.min, *arg.max);
+            }
+        }
+    }
+
+    void consume(const interval_info& info) noexcept final {
+        _row(info.tag, info.instance, info.duration.count());
+    }
+
+    void consume(const chart_info&) noexcept final {}
+
+    void consume(const heartbeat_info& info) noexcept final {
+        _row(info.offset);
+    }
+
+    void consume(const finish_info& info) noexcept final {
+        _row(info.offset, info.clean);
+        _flush();
+    }
+
+private:
+    template <typename... Args>
+    void _row(const Args&... args) noexcept {
+        (_param(args), ...);
+        if(++_rows >= _batch_size) {
+            _flush();
+        }
+    }
+
+    void _flush() noexcept {
+        _data.clear();
+        _rows = 0;
+    }
+
+    void _param(const auto& arg) noexcept {
+        append_sql_param(arg, _data).push_back('\0');
+    }
+
+    const span_size_t _batch_size;
+    span_size_t _rows{0};
+    std::string _data;
+};
+//------------------------------------------------------------------------------
+class libpq_standin_sink_factory final : public stream_sink_factory {
+public:
+    libpq_standin_sink_factory(main_ctx& ctx) noexcept {
+        ctx.config().fetch("log_server.libpq.batch.size", _batch_size);
+        _batch_size = std::max(_batch_size, span_size_t(1));
+    }
+
+    auto make_stream() noexcept -> unique_holder<stream_sink> final {
+        return {hold<libpq_standin_sink>, _batch_size};
+    }
+
+    void update() noexcept final {}
+
+private:
+    span_size_t _batch_size{256};
+};
+//------------------------------------------------------------------------------
+// null HTTP endpoint
+//------------------------------------------------------------------------------
+class null_http_connection
+  : public std::enable_shared_from_this<null_http_connection> {
+public:
+    null_http_connection(
+      asio::ip::tcp::socket socket,
+      std::atomic<span_size_t>& requests) noexcept
+      : _socket{std::move(socket)}
+      , _requests{requests} {}
+
+    void start() {
+        _read_header();
+    }
+
+private:
+    static auto _content_length(const string_view header) -> std::size_t;
+    static auto _expects_continue(const string_view header) noexcept -> bool;
+
+    void _read_header();
+    void _handle_header(std::size_t size);
+    void _respond();
+
+    asio::ip::tcp::socket _socket;
+    asio::streambuf _input;
+    std::atomic<span_size_t>& _requests;
+};
+//------------------------------------------------------------------------------
+auto null_http_connection::_content_length(const string_view header)
+  -> std::size_t {
+    static constexpr const string_view name{"content-length:"};
+    std::string lower{header};
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) {
+        return char(std::tolower(c));
+    });
+    if(const auto pos{lower.find(name)}; pos != std::string::npos) {
+        std::size_t result{0U};
+        auto str{string_view{lower}.substr(pos + name.size())};
+        while(not str.empty() and str.front() == ' ') {
+            str.remove_prefix(1);
+        }
+        std::from_chars(str.data(), str.data() + str.size(), result);
+        return result;
+    }
+    return 0U;
+}
+//------------------------------------------------------------------------------
+auto null_http_connection::_expects_continue(const string_view header) noexcept
+  -> bool {
+    return header.find("100-continue") != string_view::npos;
+}
+//------------------------------------------------------------------------------
+void null_http_connection::_read_header() {
+    auto self{shared_from_this()};
+    asio::async_read_until(
+      _socket,
+      _input,
+      "\r\n\r\n",
+      [this, self](std::error_code error, std::size_t size) {
+          if(not error) {
+              _handle_header(size);
+          }
+      });
+}
+//------------------------------------------------------------------------------
+void null_http_connection::_handle_header(std::size_t size) {
+    const std::string header{
+      asio::buffers_begin(_input.data()),
+      asio::buffers_begin(_input.data()) + std::ptrdiff_t(size)};
+    _input.consume(size);
+
+    if(_expects_continue(header)) {
+        asio::write(_socket, asio::buffer("HTTP/1.1 100 Continue\r\n\r\n", 25));
+    }
+
+    const auto length{_content_length(header)};
+    if(_input.size() >= length) {
+        _input.consume(length);
+        _respond();
+    } else {
+        auto self{shared_from_this()};
+        asio::async_read(
+          _socket,
+          _input,
+          asio::transfer_exactly(length - _input.size()),
+          [this, self, length](std::error_code error, std::size_t) {
+              if(not error) {
+                  _input.consume(length);
+                  _respond();
+              }
+          });
+    }
+}
+//------------------------------------------------------------------------------
+void null_http_connection::_respond() {
+    static constexpr const string_view response{
+      "HTTP/1.1 204 No Content\r\nContent-Length: 0\r\n\r\n"};
+    _requests.fetch_add(1);
+    auto self{shared_from_this()};
+    asio::async_write(
+      _socket,
+      asio::buffer(response.data(), response.size()),
+      [this, self](std::error_code error, std::size_t) {
+          if(not error) {
+              _read_header();
+          }
+      });
+}
+//------------------------------------------------------------------------------
+class null_http_endpoint {
+public:
+    null_http_endpoint();
+    null_http_endpoint(null_http_endpoint&&) = delete;
+    null_http_endpoint(const null_http_endpoint&) = delete;
+    auto operator=(null_http_endpoint&&) = delete;
+    auto operator=(const null_http_endpoint&) = delete;
+    ~null_http_endpoint() noexcept;
+
+    auto url() const -> std::string;
+
+    auto request_count() const noexcept -> span_size_t {
+        return _requests.load();
+    }
+
+private:
+    void _accept();
+
+    asio::io_context _io{1};
+    asio::ip::tcp::acceptor _acceptor;
+    std::atomic<span_size_t> _requests{0};
+    std::thread _thread;
+};
+//------------------------------------------------------------------------------
+null_http_endpoint::null_http_endpoint()
+  : _acceptor{
+      _io,
+      asio::ip::tcp::endpoint{asio::ip::make_address("127.0.0.1"), 0}} {
+    _accept();
+    _thread = std::thread{[this] { _io.run(); }};
+}
+//------------------------------------------------------------------------------
+null_http_endpoint::~null_http_endpoint() noexcept {
+    _io.stop();
+    if(_thread.joinable()) {
+        _thread.join();
+    }
+}
+//------------------------------------------------------------------------------
+auto null_http_endpoint::url() const -> std::string {
+    return std::format(
+      "http://127.0.0.1:{}/api/v2?org=benchmark&bucket=benchmark&token=none",
+      _acceptor.local_endpoint().port());
+}
+//------------------------------------------------------------------------------
+void null_http_endpoint::_accept() {
+    _acceptor.async_accept(
+      [this](std::error_code error, asio::ip::tcp::socket socket) {
+          if(not error) {
+              std::make_shared<null_http_connection>(
+                std::move(socket), _requests)
+                ->start();
+          }
+          _accept();
+      });
+}
+//------------------------------------------------------------------------------
+// measuring sink
+//------------------------------------------------------------------------------
+struct ingestion_stats {
+    using clock_type = std::chrono::steady_clock;
+
+    ingestion_stats(const span_size_t max_samples) {
+        latencies.resize(std_size(std::max(max_samples, span_size_t(1))));
+    }
+
+    // marks the end of the processing of a chunk or of a non-message entry
+    void mark(const clock_type::time_point now) noexcept {
+        last_mark = now;
+    }
+
+    // records the time since the last mark as the latency of one message
+    void record(const clock_type::time_point now) noexcept {
+        // the samples are kept in a ring, so replays of large recordings
+        // do not allocate while measuring
+        latencies[std_size(message_count) % latencies.size()] =
+          now - last_mark;
+        last_mark = now;
+        ++message_count;
+    }
+
+    auto samples() const noexcept -> span_size_t {
+        return std::min(message_count, span_size(latencies.size()));
+    }
+
+    clock_type::time_point last_mark{};
+    std::vector<std::chrono::nanoseconds> latencies;
+    span_size_t message_count{0};
+    span_size_t entry_count{0};
+};
+//------------------------------------------------------------------------------
+class measuring_stream_sink final : public stream_sink {
+public:
+    measuring_stream_sink(
+      ingestion_stats& stats,
+      unique_holder<stream_sink> sink) noexcept
+      : _stats{stats}
+      , _sink{std::move(sink)} {}
+
+    void consume(const begin_info& info) noexcept final {
+        _forward(info);
+    }
+
+    void consume(const description_info& info) noexcept final {
+        _forward(info);
+    }
+
+    void consume(const declare_state_info& info) noexcept final {
+        _forward(info);
+    }
+
+    void consume(const active_state_info& info) noexcept final {
+        _forward(info);
+    }
+
+    void consume(const message_info& info) noexcept final {
+        _forward(info);
+        _stats.record(ingestion_stats::clock_type::now());
+    }
+
+    void consume(const interval_info& info) noexcept final {
+        _forward(info);
+    }
+
+    void consume(const chart_info& info) noexcept final {
+        _forward(info);
+    }
+
+    void consume(const heartbeat_info& info) noexcept final {
+        _forward(info);
+    }
+
+    void consume(const finish_info& info) noexcept final {
+        _forward(info);
+    }
+
+private:
+    void _forward(const auto& info) noexcept {
+        _sink->consume(info);
+        ++_stats.entry_count;
+        if constexpr(not std::is_same_v<decltype(info), const message_info&>) {
+            _stats.mark(ingestion_stats::clock_type::now());
+        }
+    }
+
+    ingestion_stats& _stats;
+    unique_holder<stream_sink> _sink;
+};
+//------------------------------------------------------------------------------
+// benchmark
+//------------------------------------------------------------------------------
+class ingestion_benchmark : public main_ctx_object {
+public:
+    ingestion_benchmark(main_ctx& ctx);
+
+    auto run() noexcept -> int;
+
+private:
+    using parser_maker =
+      auto (*)(main_ctx&, shared_holder<stream_sink>) noexcept
+      -> valtree::value_tree_stream_input;
+
+    auto _input() const noexcept -> memory::const_block;
+    auto _is_json_input() const noexcept -> bool;
+    auto _run(
+      string_view target,
+      shared_holder<stream_sink_factory>,
+      parser_maker make_parser = &make_data_parser) noexcept -> bool;
+
+    span_size_t _message_count{100000};
+    span_size_t _chunk_size{64 * 1024};
+    span_size_t _repeats{3};
+    file_contents _recorded;
+    std::string _synthetic;
+};
+//------------------------------------------------------------------------------
+ingestion_benchmark::ingestion_benchmark(main_ctx& ctx)
+  : main_ctx_object{"LogSrvBnch", ctx} {
+    ctx.config().fetch("log_server.benchmark.messages", _message_count);
+    ctx.config().fetch("log_server.benchmark.chunk_size", _chunk_size);
+    ctx.config().fetch("log_server.benchmark.repeats", _repeats);
+    _chunk_size = std::max(_chunk_size, span_size_t(256));
+    _repeats = std::max(_repeats, span_size_t(1));
+
+    if(const auto arg{ctx.args().find("--input")}) {
+        _recorded = file_contents{arg.next().get()};
+        if(not _recorded) {
+            log_error("failed to load recorded log from ${path}")
+              .arg("path", "FsPath", arg.next().get());
+        }
+    } else {
+        _synthetic = make_synthetic_log(_message_count);
+    }
+}
+//------------------------------------------------------------------------------
+auto ingestion_benchmark::_input() const noexcept -> memory::const_block {
+    if(_recorded) {
+        return _recorded.block();
+    }
+    return as_bytes(string_view{_synthetic});
+}
+//------------------------------------------------------------------------------
+auto ingestion_benchmark::_is_json_input() const noexcept -> bool {
+    const auto input{_input()};
+    return not input.empty() and
+           input.front() != byte(log_binary_stream_magic.front());
+}
+//------------------------------------------------------------------------------
+auto ingestion_benchmark::_run(
+  string_view target,
+  shared_holder<stream_sink_factory> factory,
+  parser_maker make_parser) noexcept -> bool {
+    if(not factory) {
+        log_error("failed to create the ${target} sink").arg("target", target);
+        return false;
+    }
+    const auto input{_input()};
+    using clock_type = ingestion_stats::clock_type;
+
+    for(span_size_t r = 0; r < _repeats; ++r) {
+        ingestion_stats stats{
+          _recorded ? span_size_t(1024 * 1024) : _message_count};
+
+        const auto allocs_before{allocation_count};
+        const auto start{clock_type::now()};
+        {
+            auto parser{make_parser(
+              main_context(),
+              shared_holder<stream_sink>{
+                hold<measuring_stream_sink>, stats, factory->make_stream()})};
+            factory->update();
+
+            for(span_size_t offs = 0; offs < input.size();
+                offs += _chunk_size) {
+                stats.mark(clock_type::now());
+                if(not parser.consume_data(
+                     head(skip(input, offs), _chunk_size))) {
+                    break;
+                }
+                factory->update();
+            }
+            parser.finish();
+        }
+        factory->update();
+        const auto elapsed{
+          std::chrono::duration<float>(clock_type::now() - start)};
+        const auto allocs{allocation_count - allocs_before};
+
+        std::vector<std::chrono::nanoseconds> sorted{
+          stats.latencies.begin(),
+          stats.latencies.begin() + std::ptrdiff_t(stats.samples())};
+        std::sort(sorted.begin(), sorted.end());
+        const auto percentile{[&](std::size_t p) {
+            if(sorted.empty()) {
+                return std::chrono::duration<float, std::micro>{};
+            }
+            return std::chrono::duration<float, std::micro>{
+              sorted[(sorted.size() - 1U) * p / 100U]};
+        }};
+        const auto messages{std::max(stats.message_count, span_size_t(1))};
+        const auto seconds{std::max(elapsed.count(), 1e-9F)};
+
+        cio_print(
+          "${target}[${repeat}]: ${messages} messages in ${time}s, "
+          "${msgRate} msg/s, ${entryRate} entries/s, ${byteRate} B/s, "
+          "latency p50 ${p50}us "
+          "p99 ${p99}us, ${allocs} allocations per message")
+          .arg("target", target)
+          .arg("repeat", r)
+          .arg("messages", stats.message_count)
+          .arg("time", elapsed.count())
+          .arg("msgRate", float(stats.message_count) / seconds)
+          .arg("entryRate", float(stats.entry_count) / seconds)
+          .arg("byteRate", float(input.size()) / seconds)
+          .arg("p50", percentile(50).count())
+          .arg("p99", percentile(99).count())
+          .arg("allocs", float(allocs) / float(messages));
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+auto ingestion_benchmark::run() noexcept -> int {
+    try {
+        if(_input().empty()) {
+            log_error("no log data to ingest");
+            return 1;
+        }
+        log_info("ingesting ${size} of log data in ${chunk} chunks")
+          .arg("size", "ByteSize", _input().size())
+          .arg("chunk", "ByteSize", _chunk_size);
+
+        auto& ctx{main_context()};
+        const auto explicit_target{
+          ctx.args().find("--text-tree") or ctx.args().find("--libpq") or
+          ctx.args().find("--influxdb")};
+        const auto param_of{[&](string_view name) -> string_view {
+            if(const auto arg{ctx.args().find(name)}) {
+                if(not arg.next().starts_with("-")) {
+                    return arg.next().get();
+                }
+            }
+            return {};
+        }};
+        bool result{true};
+
+        if(not explicit_target or ctx.args().find("--text-tree")) {
+            result = _run(
+                       "text-tree",
+                       make_text_tree_sink_factory(
+                         ctx, unique_holder<text_output>{
+                                hold<null_text_output>}})) and
+                     result;
+        }
+        if(ctx.args().find("--libpq")) {
+            result = _run(
+                       "libpq",
+                       make_libpq_sink_factory(ctx, param_of("--libpq"))) and
+                     result;
+        } else if(not explicit_target) {
+            // without a database server the stand-in measures the work done
+            // by the batched database sink before sending the statements
+            result = _run(
+                       "libpq-standin",
+                       shared_holder<stream_sink_factory>{
+                         hold<libpq_standin_sink_factory>, ctx}) and
+                     result;
+            // only the parsing and dispatch overhead
+            result = _run(
+                       "null-sink",
+                       shared_holder<stream_sink_factory>{
+                         hold<null_stream_sink_factory>}) and
+                     result;
+            if(_is_json_input()) {
+                // the same with the generic value tree based JSON parser
+                result = _run(
+                           "null-sink/generic-json",
+                           shared_holder<stream_sink_factory>{
+                             hold<null_stream_sink_factory>},
+                           &make_generic_json_parser) and
+                         result;
+            }
+        }
+        if(const auto params{param_of("--influxdb")}; not params.empty()) {
+            result =
+              _run("influxdb", make_influxdb_sink_factory(ctx, params)) and
+              result;
+        } else if(not explicit_target or ctx.args().find("--influxdb")) {
+            null_http_endpoint endpoint;
+            const auto url{endpoint.url()};
+            result =
+              _run("influxdb", make_influxdb_sink_factory(ctx, url)) and result;
+            log_info("null HTTP endpoint served ${count} requests")
+              .arg("count", endpoint.request_count());
+        }
+        return result ? 0 : 1;
+    } catch(std::exception& error) {
+        log_error("benchmark error: ${what}").arg("what", error.what());
+    }
+    return 1;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine::logs
+
+namespace eagine {
+//------------------------------------------------------------------------------
+// entry point
+//------------------------------------------------------------------------------
+auto main(main_ctx& ctx) -> int {
+    if(const auto exit_code{handle_common_special_args(ctx)}) {
+        return *exit_code;
+    }
+    try {
+        return logs::ingestion_benchmark{ctx}.run();
+    } catch(std::exception& error) {
+        ctx.log().error("benchmark error: ${what}").arg("what", error.what());
+    }
+    return 1;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagine::main_ctx_options options;
+    options.app_id = "LogSrvBnch";
+    return eagine::main_impl(argc, argv, options, eagine::main);
+}
+//------------------------------------------------------------------------------
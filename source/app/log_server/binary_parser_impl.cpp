@@ -0,0 +1,526 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module eagine.core.log_server;
+
+import std;
+import eagine.core;
+
+import :interfaces;
+import :utilities;
+
+namespace eagine::logs {
+//------------------------------------------------------------------------------
+// binary entry reader
+//------------------------------------------------------------------------------
+class binary_entry_reader {
+public:
+    binary_entry_reader(memory::const_block data) noexcept
+      : _data{data} {}
+
+    auto is_valid() const noexcept -> bool {
+        return _valid;
+    }
+
+    auto at_end() const noexcept -> bool {
+        return _pos >= _data.size();
+    }
+
+    template <std::integral T>
+    auto get(T& value) noexcept -> binary_entry_reader& {
+        if(_take(span_size(sizeof(T)))) {
+            std::memcpy(&value, _data.data() + _pos - sizeof(T), sizeof(T));
+            if constexpr(std::endian::native == std::endian::big) {
+                value = std::byteswap(value);
+            }
+        }
+        return *this;
+    }
+
+    auto get(float& value) noexcept -> binary_entry_reader& {
+        std::uint32_t bits{0U};
+        get(bits);
+        value = std::bit_cast<float>(bits);
+        return *this;
+    }
+
+    auto get(float_seconds& value) noexcept -> binary_entry_reader& {
+        float count{0.F};
+        get(count);
+        value = float_seconds{count};
+        return *this;
+    }
+
+    auto get(identifier& value) noexcept -> binary_entry_reader& {
+        identifier_t id{0U};
+        get(id);
+        value = identifier{id};
+        return *this;
+    }
+
+    auto get(memory::const_block& value) noexcept -> binary_entry_reader& {
+        std::uint32_t size{0U};
+        if(get(size)._take(span_size(size))) {
+            value = head(skip(_data, _pos - span_size(size)), span_size(size));
+        }
+        return *this;
+    }
+
+    auto get(string_view& value) noexcept -> binary_entry_reader& {
+        memory::const_block block;
+        if(get(block).is_valid()) {
+            const auto chars{as_chars(block)};
+            value = {chars.data(), chars.size()};
+        }
+        return *this;
+    }
+
+    auto get(std::string& value) noexcept -> binary_entry_reader& {
+        memory::const_block block;
+        if(get(block).is_valid()) {
+            assign_to(as_chars(block), value);
+        }
+        return *this;
+    }
+
+private:
+    auto _take(const span_size_t size) noexcept -> bool {
+        if(_valid and (_data.size() - _pos >= size)) {
+            _pos += size;
+            return true;
+        }
+        _valid = false;
+        return false;
+    }
+
+    memory::const_block _data;
+    span_size_t _pos{0};
+    bool _valid{true};
+};
+//------------------------------------------------------------------------------
+// binary data parser
+//------------------------------------------------------------------------------
+class binary_data_parser final : public valtree::value_tree_stream_parser {
+public:
+    binary_data_parser(shared_holder<stream_sink> stream) noexcept
+      : _stream{std::move(stream)} {}
+
+    auto begin() noexcept -> bool final;
+    auto parse_data(memory::const_block data) noexcept -> bool final;
+    auto finish() noexcept -> bool final;
+
+private:
+    auto _parse_entry(memory::const_block) noexcept -> bool;
+    auto _parse_begin(binary_entry_reader&) noexcept -> bool;
+    auto _parse_description(binary_entry_reader&) noexcept -> bool;
+    auto _parse_declare_state(binary_entry_reader&) noexcept -> bool;
+    auto _parse_active_state(binary_entry_reader&) noexcept -> bool;
+    auto _parse_message(binary_entry_reader&) noexcept -> bool;
+    auto _parse_arg(binary_entry_reader&, message_info::arg_info&) noexcept
+      -> bool;
+    auto _parse_interval(binary_entry_reader&) noexcept -> bool;
+    auto _parse_chart_sample(binary_entry_reader&) noexcept -> bool;
+    auto _parse_heartbeat(binary_entry_reader&) noexcept -> bool;
+    auto _parse_finish(binary_entry_reader&) noexcept -> bool;
+
+    shared_holder<stream_sink> _stream;
+    std::vector<byte> _pending;
+    span_size_t _header_size{0};
+    message_info _message{};
+    std::string _encoded;
+    arg_value_translator _arg_translator;
+    bool _clean_finish{false};
+};
+//------------------------------------------------------------------------------
+auto binary_data_parser::begin() noexcept -> bool {
+    _pending.clear();
+    _header_size = 0;
+    _clean_finish = false;
+    return true;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::parse_data(memory::const_block data) noexcept
+  -> bool {
+    try {
+        _pending.insert(_pending.end(), data.begin(), data.end());
+        memory::const_block pending{view(_pending)};
+
+        const auto magic{as_bytes(log_binary_stream_magic)};
+        if(_header_size < magic.size()) {
+            const auto size{std::min(pending.size(), magic.size())};
+            if(not std::ranges::equal(head(pending, size), head(magic, size))) {
+                return false;
+            }
+            if(size < magic.size()) {
+                return true;
+            }
+            pending = skip(pending, magic.size());
+            _header_size = magic.size();
+        }
+
+        // only complete entries are parsed, the rest is kept for later
+        const auto length_size{span_size(sizeof(std::uint32_t))};
+        while(pending.size() >= length_size) {
+            std::uint32_t length{0U};
+            binary_entry_reader{pending}.get(length);
+            if(pending.size() - length_size < span_size(length)) {
+                break;
+            }
+            if(not _parse_entry(head(skip(pending, length_size), length))) {
+                return false;
+            }
+            pending = skip(pending, length_size + span_size(length));
+        }
+        const auto consumed{_pending.size() - std_size(pending.size())};
+        _pending.erase(_pending.begin(), _pending.begin() + consumed);
+        return true;
+    } catch(...) {
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::finish() noexcept -> bool {
+    if(not _clean_finish) {
+        _stream->consume(finish_info{});
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::_parse_entry(memory::const_block data) noexcept
+  -> bool {
+    binary_entry_reader reader{data};
+    std::uint8_t type{0U};
+    if(reader.get(type).is_valid()) {
+        switch(log_binary_entry(type)) {
+            case log_binary_entry::begin:
+                return _parse_begin(reader);
+            case log_binary_entry::description:
+                return _parse_description(reader);
+            case log_binary_entry::declare_state:
+                return _parse_declare_state(reader);
+            case log_binary_entry::active_state:
+                return _parse_active_state(reader);
+            case log_binary_entry::message:
+                return _parse_message(reader);
+            case log_binary_entry::interval:
+                return _parse_interval(reader);
+            case log_binary_entry::heartbeat:
+                return _parse_heartbeat(reader);
+            case log_binary_entry::finish:
+                return _parse_finish(reader);
+            case log_binary_entry::chart_sample:
+                return _parse_chart_sample(reader);
+        }
+        // skip entries added by newer versions of the format
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::_parse_begin(binary_entry_reader& reader) noexcept
+  -> bool {
+    std::int64_t start{0};
+    begin_info info;
+    if(reader.get(start).get(info.session).get(info.identity).is_valid()) {
+        info.start = std::chrono::system_clock::time_point{
+          std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::microseconds{start})};
+        _stream->consume(info);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::_parse_description(
+  binary_entry_reader& reader) noexcept -> bool {
+    description_info info;
+    if(reader.get(info.offset)
+         .get(info.source)
+         .get(info.instance)
+         .get(info.display_name)
+         .get(info.description)
+         .is_valid()) {
+        _stream->consume(info);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::_parse_declare_state(
+  binary_entry_reader& reader) noexcept -> bool {
+    declare_state_info info;
+    if(reader.get(info.offset)
+         .get(info.source)
+         .get(info.state_tag)
+         .get(info.begin_tag)
+         .get(info.end_tag)
+         .is_valid()) {
+        _stream->consume(info);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::_parse_active_state(
+  binary_entry_reader& reader) noexcept -> bool {
+    active_state_info info;
+    if(reader.get(info.offset).get(info.source).get(info.tag).is_valid()) {
+        _stream->consume(info);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::_parse_message(binary_entry_reader& reader) noexcept
+  -> bool {
+    std::uint8_t severity{0U};
+    // the format and string arguments view the entry data in the pending
+    // buffer, which is kept until the message is consumed
+    _message.clear();
+    if(reader.get(severity)
+         .get(_message.source)
+         .get(_message.tag)
+         .get(_message.instance)
+         .get(_message.offset)
+         .get(_message.format)
+         .is_valid()) {
+        _message.severity = static_cast<log_event_severity>(severity);
+        while(not reader.at_end()) {
+            if(not _parse_arg(reader, _message.args.emplace_back())) {
+                return false;
+            }
+        }
+        for(auto& arg : _message.args) {
+            _arg_translator.translate(_message, arg);
+        }
+        _stream->consume(_message);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::_parse_arg(
+  binary_entry_reader& reader,
+  message_info::arg_info& arg) noexcept -> bool {
+    std::uint8_t type{0U};
+    if(not reader.get(type).get(arg.name).get(arg.tag).is_valid()) {
+        return false;
+    }
+    switch(log_binary_arg(type)) {
+        case log_binary_arg::nothing:
+            break;
+        case log_binary_arg::identifier: {
+            identifier value;
+            reader.get(value);
+            arg.value = value;
+            break;
+        }
+        case log_binary_arg::message_id: {
+            identifier class_id;
+            identifier method_id;
+            reader.get(class_id).get(method_id);
+            std::array<char, 24> temp{};
+            const auto result{std::format_to_n(
+              temp.data(),
+              std::ssize(temp),
+              "{}.{}",
+              std::string_view{class_id.name()},
+              std::string_view{method_id.name()})};
+            arg.value = _message.store(
+              {temp.data(), span_size(result.out - temp.data())});
+            break;
+        }
+        case log_binary_arg::boolean: {
+            std::uint8_t value{0U};
+            reader.get(value);
+            arg.value = value != 0U;
+            break;
+        }
+        case log_binary_arg::integer: {
+            std::int64_t value{0};
+            reader.get(value);
+            arg.value = value;
+            break;
+        }
+        case log_binary_arg::unsigned_integer: {
+            std::uint64_t value{0U};
+            reader.get(value);
+            arg.value = value;
+            break;
+        }
+        case log_binary_arg::floating: {
+            float value{0.F};
+            reader.get(value);
+            arg.value = value;
+            break;
+        }
+        case log_binary_arg::float_range: {
+            float min{0.F};
+            float value{0.F};
+            float max{0.F};
+            reader.get(min).get(value).get(max);
+            arg.value = value;
+            arg.min = min;
+            arg.max = max;
+            break;
+        }
+        case log_binary_arg::duration: {
+            float_seconds value{};
+            reader.get(value);
+            arg.value = value;
+            break;
+        }
+        case log_binary_arg::string: {
+            string_view value;
+            reader.get(value);
+            arg.value = value;
+            break;
+        }
+        case log_binary_arg::blob: {
+            // keep the same representation as the JSON format
+            memory::const_block value;
+            reader.get(value);
+            base64_encode(value, _encoded);
+            arg.value = _message.store(_encoded);
+            break;
+        }
+        default:
+            return false;
+    }
+    return reader.is_valid();
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::_parse_interval(binary_entry_reader& reader) noexcept
+  -> bool {
+    std::int64_t duration{0};
+    interval_info info;
+    if(reader.get(info.tag).get(info.instance).get(duration).is_valid()) {
+        info.duration = std::chrono::nanoseconds{duration};
+        if(not reader.at_end()) {
+            std::int64_t p50{0}, p90{0}, p99{0}, max{0};
+            if(not reader.get(info.count)
+                     .get(p50)
+                     .get(p90)
+                     .get(p99)
+                     .get(max)
+                     .is_valid()) {
+                return false;
+            }
+            info.p50 = std::chrono::nanoseconds{p50};
+            info.p90 = std::chrono::nanoseconds{p90};
+            info.p99 = std::chrono::nanoseconds{p99};
+            info.max = std::chrono::nanoseconds{max};
+        }
+        _stream->consume(info);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::_parse_chart_sample(
+  binary_entry_reader& reader) noexcept -> bool {
+    chart_info info;
+    if(reader.get(info.offset)
+         .get(info.source)
+         .get(info.instance)
+         .get(info.series)
+         .get(info.value)
+         .is_valid()) {
+        info.min = info.value;
+        info.max = info.value;
+        if(not reader.at_end()) {
+            if(not reader.get(info.count)
+                     .get(info.min)
+                     .get(info.max)
+                     .is_valid()) {
+                return false;
+            }
+        }
+        _stream->consume(info);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::_parse_heartbeat(binary_entry_reader& reader) noexcept
+  -> bool {
+    heartbeat_info info;
+    if(reader.get(info.offset).is_valid()) {
+        _stream->consume(info);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto binary_data_parser::_parse_finish(binary_entry_reader& reader) noexcept
+  -> bool {
+    finish_info info{.clean = true};
+    if(reader.get(info.offset).is_valid()) {
+        _stream->consume(info);
+        _clean_finish = true;
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+// format detecting parser
+//------------------------------------------------------------------------------
+class format_detecting_parser final : public valtree::value_tree_stream_parser {
+public:
+    format_detecting_parser(
+      main_ctx& ctx,
+      shared_holder<stream_sink> stream) noexcept
+      : _ctx{ctx}
+      , _stream{std::move(stream)} {}
+
+    auto begin() noexcept -> bool final {
+        return true;
+    }
+
+    auto parse_data(memory::const_block data) noexcept -> bool final;
+
+    auto finish() noexcept -> bool final {
+        _parser.reset();
+        return true;
+    }
+
+private:
+    main_ctx& _ctx;
+    shared_holder<stream_sink> _stream;
+    std::optional<parser_input> _parser;
+};
+//------------------------------------------------------------------------------
+auto format_detecting_parser::parse_data(memory::const_block data) noexcept
+  -> bool {
+    if(not _parser) {
+        if(data.empty()) {
+            return true;
+        }
+        // the first byte of the binary magic can never start a JSON document
+        if(data.front() == byte(log_binary_stream_magic.front())) {
+            _parser.emplace(make_binary_parser(_ctx, std::move(_stream)));
+        } else {
+            _parser.emplace(make_json_parser(_ctx, std::move(_stream)));
+        }
+    }
+    return _parser->consume_data(data);
+}
+//------------------------------------------------------------------------------
+// make parsers
+//------------------------------------------------------------------------------
+auto make_binary_parser(main_ctx&, shared_holder<stream_sink> stream) noexcept
+  -> parser_input {
+    return {{hold<binary_data_parser>, std::move(stream)}};
+}
+//------------------------------------------------------------------------------
+auto make_format_detecting_parser(
+  main_ctx& ctx,
+  shared_holder<stream_sink> stream) noexcept -> parser_input {
+    return {{hold<format_detecting_parser>, ctx, std::move(stream)}};
+}
+//------------------------------------------------------------------------------
+} // namespace eagine::logs
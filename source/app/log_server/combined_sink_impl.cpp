@@ -27,6 +27,7 @@ public:
     void consume(const active_state_info&) noexcept final;
     void consume(const message_info&) noexcept final;
     void consume(const interval_info&) noexcept final;
+    void consume(const chart_info&) noexcept final;
     void consume(const heartbeat_info&) noexcept final;
     void consume(const finish_info&) noexcept final;
 
@@ -70,6 +71,10 @@ void combined_sink::consume(const interval_info& info) noexcept {
     _consume(info);
 }
 //------------------------------------------------------------------------------
+void combined_sink::consume(const chart_info& info) noexcept {
+    _consume(info);
+}
+//------------------------------------------------------------------------------
 void combined_sink::consume(const heartbeat_info& info) noexcept {
     _consume(info);
 }
@@ -97,14 +97,99 @@ auto message_info::arg_info::value_duration() const noexcept
 //------------------------------------------------------------------------------
 auto message_info::arg_info::value_string() const noexcept
   -> optionally_valid<string_view> {
-    if(const auto val{get_if<std::string>(value)}) {
-        return string_view{*val};
+    if(const auto val{get_if<string_view>(value)}) {
+        return *val;
     }
     return {};
 }
 //------------------------------------------------------------------------------
 // message info
 //------------------------------------------------------------------------------
+message_info::message_info(message_info&& temp) noexcept
+  : offset{temp.offset}
+  , format{std::exchange(temp.format, {})}
+  , severity{temp.severity}
+  , source{temp.source}
+  , tag{temp.tag}
+  , instance{temp.instance}
+  , args{std::move(temp.args)}
+  , _blocks{std::move(temp._blocks)}
+  , _current{std::exchange(temp._current, 0U)}
+  , _used{std::exchange(temp._used, 0)} {}
+//------------------------------------------------------------------------------
+message_info::message_info(const message_info& that) {
+    _copy_from(that);
+}
+//------------------------------------------------------------------------------
+auto message_info::operator=(message_info&& temp) noexcept -> message_info& {
+    if(this != &temp) {
+        offset = temp.offset;
+        format = std::exchange(temp.format, {});
+        severity = temp.severity;
+        source = temp.source;
+        tag = temp.tag;
+        instance = temp.instance;
+        args = std::move(temp.args);
+        _blocks = std::move(temp._blocks);
+        _current = std::exchange(temp._current, 0U);
+        _used = std::exchange(temp._used, 0);
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+auto message_info::operator=(const message_info& that) -> message_info& {
+    if(this != &that) {
+        clear();
+        _copy_from(that);
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+void message_info::_copy_from(const message_info& that) {
+    offset = that.offset;
+    format = store(that.format);
+    severity = that.severity;
+    source = that.source;
+    tag = that.tag;
+    instance = that.instance;
+    args = that.args;
+    for(auto& arg : args) {
+        if(const auto str{get_if<string_view>(arg.value)}) {
+            arg.value = store(*str);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+auto message_info::store(const string_view str) -> string_view {
+    if(str.empty()) {
+        return {};
+    }
+    // the blocks are never reallocated, only appended, so that the views
+    // of the previously stored strings remain valid
+    while(true) {
+        if(_current < _blocks.size()) {
+            auto& blk{_blocks[_current]};
+            if(blk.size() - _used >= str.size()) {
+                const auto dst{
+                  memory::copy(as_bytes(str), skip(cover(blk), _used))};
+                _used += dst.size();
+                return {as_chars(dst).data(), dst.size()};
+            }
+            ++_current;
+            _used = 0;
+        } else {
+            _blocks.emplace_back().resize(std::max(str.size(), _block_size));
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void message_info::clear() noexcept {
+    format = {};
+    args.clear();
+    _current = 0U;
+    _used = 0;
+}
+//------------------------------------------------------------------------------
 auto message_info::find_arg(identifier name) const noexcept
   -> optional_reference<const arg_info> {
     for(auto& arg : args) {
@@ -118,15 +203,31 @@ auto message_info::find_arg(identifier name) const noexcept
 // aggregate interval info
 //------------------------------------------------------------------------------
 void aggregate_interval_info::update(const interval_info& i) noexcept {
-    _duration_sum += i.duration;
+    const auto hits{math::maximum(i.count, std::uint64_t(1U))};
+    const auto max{i.count > 0U ? i.max : i.duration};
+    _duration_sum += i.duration * std::int64_t(hits);
     if(_count == 0) {
         _duration_min = i.duration;
+        _duration_max = max;
     } else {
         _duration_min = math::minimum(_duration_min, i.duration);
+        _duration_max = math::maximum(_duration_max, max);
     }
-    _duration_max = math::maximum(_duration_max, i.duration);
 
-    _count++;
+    if(i.count > 0U) {
+        // only the percentiles are sent, so the distribution is approximated
+        const auto p90_hits{i.count * 40U / 100U};
+        const auto p99_hits{i.count * 9U / 100U};
+        const auto max_hits{i.count / 100U};
+        _histogram.add(i.p90, p90_hits);
+        _histogram.add(i.p99, p99_hits);
+        _histogram.add(i.max, max_hits);
+        _histogram.add(i.p50, i.count - p90_hits - p99_hits - max_hits);
+    } else {
+        _histogram.add(i.duration);
+    }
+
+    _count += span_size(hits);
 }
 //------------------------------------------------------------------------------
 auto aggregate_interval_info::should_consume() noexcept -> bool {
@@ -137,6 +238,7 @@ void aggregate_interval_info::reset() noexcept {
     _should_consume.reset();
     _duration_sum = {};
     _count = 0;
+    _histogram.reset();
 }
 //------------------------------------------------------------------------------
 auto aggregate_interval_info::hit_interval() const noexcept
@@ -172,6 +274,21 @@ auto aggregate_interval_info::avg_duration() const noexcept
     return {};
 }
 //------------------------------------------------------------------------------
+auto aggregate_interval_info::p50_duration() const noexcept
+  -> std::chrono::nanoseconds {
+    return _histogram.percentile(0.50F);
+}
+//------------------------------------------------------------------------------
+auto aggregate_interval_info::p90_duration() const noexcept
+  -> std::chrono::nanoseconds {
+    return _histogram.percentile(0.90F);
+}
+//------------------------------------------------------------------------------
+auto aggregate_interval_info::p99_duration() const noexcept
+  -> std::chrono::nanoseconds {
+    return _histogram.percentile(0.99F);
+}
+//------------------------------------------------------------------------------
 // aggregate intervals
 //------------------------------------------------------------------------------
 aggregate_intervals::aggregate_intervals(std::chrono::seconds period) noexcept
@@ -231,26 +348,55 @@ auto make_text_output(main_ctx& ctx) -> unique_holder<text_output> {
     return make_combined_text_output(std::move(outputs));
 }
 //------------------------------------------------------------------------------
+auto reader_thread_count(main_ctx& ctx) noexcept -> span_size_t {
+    span_size_t count{1};
+    ctx.config().fetch("log_server.reader.threads", count);
+    return std::max(count, span_size_t(1));
+}
+//------------------------------------------------------------------------------
 auto make_sink_factory(main_ctx& ctx) noexcept
   -> shared_holder<stream_sink_factory> {
+    const auto thread_count{reader_thread_count(ctx)};
+    // with multiple reader threads each database sink gets one independent
+    // factory (and connection) per thread and the streams are distributed
+    // between them, the shared text output is only synchronized
+    const auto make_sharded{[&](auto make_factory) {
+        if(thread_count == 1) {
+            return make_factory();
+        }
+        std::vector<shared_holder<stream_sink_factory>> shards;
+        for(span_size_t i = 0; i < thread_count; ++i) {
+            shards.emplace_back(make_factory());
+        }
+        return make_sharded_sink_factory(ctx, std::move(shards));
+    }};
+
     std::vector<shared_holder<stream_sink_factory>> factories;
     if(const auto arg{ctx.args().find("--influxdb")}) {
         string_view address;
         if(not arg.next().starts_with("-")) {
             address = arg.next().get();
         }
-        factories.emplace_back(make_influxdb_sink_factory(ctx, address));
+        factories.emplace_back(make_sharded([&] {
+            return make_influxdb_sink_factory(ctx, address);
+        }));
     }
     if(const auto arg{ctx.args().find("--libpq")}) {
         string_view address;
         if(not arg.next().starts_with("-")) {
             address = arg.next().get();
         }
-        factories.emplace_back(make_libpq_sink_factory(ctx, address));
+        factories.emplace_back(
+          make_sharded([&] { return make_libpq_sink_factory(ctx, address); }));
     }
     if(ctx.args().find("--text-tree") or factories.empty()) {
-        factories.emplace_back(
-          make_text_tree_sink_factory(ctx, make_text_output(ctx)));
+        auto factory{make_text_tree_sink_factory(ctx, make_text_output(ctx))};
+        if(thread_count > 1) {
+            std::vector<shared_holder<stream_sink_factory>> shards;
+            shards.emplace_back(std::move(factory));
+            factory = make_sharded_sink_factory(ctx, std::move(shards));
+        }
+        factories.emplace_back(std::move(factory));
     }
     if(factories.size() == 1) {
         return std::move(factories.front());
@@ -260,7 +406,7 @@ auto make_sink_factory(main_ctx& ctx) noexcept
 //------------------------------------------------------------------------------
 auto make_data_parser(main_ctx& ctx, shared_holder<stream_sink> sink) noexcept
   -> parser_input {
-    return make_json_parser(ctx, std::move(sink));
+    return make_format_detecting_parser(ctx, std::move(sink));
 }
 //------------------------------------------------------------------------------
 auto make_reader(
@@ -99,11 +99,23 @@ public:
         return *this;
     }
 
+    auto set_timeout(std::chrono::milliseconds timeout) noexcept
+      -> connection& {
+        ::curl_easy_setopt(get(), CURLOPT_TIMEOUT_MS, long(timeout.count()));
+        return *this;
+    }
+
     auto perform() noexcept -> bool {
         ::curl_easy_setopt(get(), CURLOPT_HTTPHEADER, _headers.get());
         return ::curl_easy_perform(get()) == CURLE_OK;
     }
 
+    auto response_code() const noexcept -> long {
+        long result{0};
+        ::curl_easy_getinfo(get(), CURLINFO_RESPONSE_CODE, &result);
+        return result;
+    }
+
 private:
     shared_holder<lib_init> _lib;
     string_list _headers;
@@ -126,7 +138,8 @@ private:
 class influxdb_stream_sink;
 class influxdb_stream_sink_factory final
   : public std::enable_shared_from_this<influxdb_stream_sink_factory>
-  , public stream_sink_factory {
+  , public stream_sink_factory
+  , public main_ctx_object {
 public:
     influxdb_stream_sink_factory(
       main_ctx&,
@@ -147,6 +160,7 @@ public:
     auto consume(influxdb_stream_sink&, const message_info&) noexcept -> bool;
     auto consume(influxdb_stream_sink&, const aggregate_interval_info&) noexcept
       -> bool;
+    auto consume(influxdb_stream_sink&, const chart_info&) noexcept -> bool;
     auto consume(influxdb_stream_sink&, const heartbeat_info&) noexcept -> bool;
     auto consume(const influxdb_stream_sink&, const finish_info&) noexcept
       -> bool;
@@ -164,7 +178,12 @@ private:
       const message_info&,
       const message_info::arg_info&) noexcept;
 
+    void _batch_appended() noexcept;
     auto _write_arg_data() noexcept -> bool;
+    auto _post(memory::const_block payload) noexcept -> bool;
+    auto _retry_pending() noexcept -> bool;
+    void _enqueue_retry(memory::const_block payload) noexcept;
+    void _report_stats() noexcept;
 
     auto _make_write_url() noexcept -> std::string;
     auto _make_auth_hdr() noexcept -> std::string;
@@ -176,10 +195,32 @@ private:
     curl::library _lib_curl;
     curl::connection _conn;
     std::string _entry_arg_batch;
-    std::string _entry_arg_buffer;
-    std::string _interval_buffer;
     stream_id_t _id_seq{0};
 
+    memory::buffer_pool _buffers;
+    data_compressor _compressor{_buffers};
+    memory::buffer _compressed;
+    std::deque<memory::buffer> _retry_queue;
+    span_size_t _retry_bytes{0};
+    span_size_t _max_retry_bytes{16 * 1024 * 1024};
+    span_size_t _batch_size{64 * 1024};
+    std::chrono::milliseconds _post_timeout{5000};
+    timeout _should_flush{std::chrono::seconds{1}};
+    timeout _should_report{std::chrono::seconds{60}};
+    backing_off_timeout _should_retry{
+      std::chrono::seconds{1},
+      std::chrono::minutes{1}};
+    bool _use_gzip{true};
+
+    struct _post_stats {
+        span_size_t batches{0};
+        span_size_t raw_bytes{0};
+        span_size_t sent_bytes{0};
+        span_size_t failed{0};
+        span_size_t rejected{0};
+        span_size_t dropped{0};
+    } _stats;
+
     flat_map<stream_id_t, flat_map<string_view, std::string, str_view_less>>
       _stream_metadata;
 };
@@ -205,6 +246,7 @@ public:
     void consume(const active_state_info&) noexcept final;
     void consume(const message_info&) noexcept final;
     void consume(const interval_info&) noexcept final;
+    void consume(const chart_info&) noexcept final;
     void consume(const heartbeat_info&) noexcept final;
     void consume(const finish_info&) noexcept final;
 
@@ -223,6 +265,7 @@ private:
       active_state_info,
       message_info,
       aggregate_interval_info,
+      chart_info,
       heartbeat_info,
       finish_info>>
       _backlog;
@@ -319,6 +362,10 @@ void influxdb_stream_sink::consume(const interval_info& info) noexcept {
     }
 }
 //------------------------------------------------------------------------------
+void influxdb_stream_sink::consume(const chart_info& info) noexcept {
+    _dispatch(info);
+}
+//------------------------------------------------------------------------------
 void influxdb_stream_sink::consume(const heartbeat_info& info) noexcept {
     _dispatch(info);
 }
@@ -330,10 +377,25 @@ void influxdb_stream_sink::consume(const finish_info& info) noexcept {
 //
 //------------------------------------------------------------------------------
 influxdb_stream_sink_factory::influxdb_stream_sink_factory(
-  main_ctx&,
+  main_ctx& ctx,
   const string_view conn_params) noexcept
-  : _conn_params{to_string(conn_params)}
-  , _conn{_lib_curl.connect()} {}
+  : main_ctx_object{"InfluxSink", ctx}
+  , _conn_params{to_string(conn_params)}
+  , _conn{_lib_curl.connect()}
+  , _compressed{_buffers.get()} {
+    auto& config{ctx.config()};
+    config.fetch("log_server.influxdb.batch.size", _batch_size);
+    config.fetch("log_server.influxdb.retry.max_size", _max_retry_bytes);
+    config.fetch("log_server.influxdb.timeout", _post_timeout);
+    config.fetch("log_server.influxdb.gzip", _use_gzip);
+    std::chrono::duration<float> max_age{};
+    if(config.fetch("log_server.influxdb.batch.max_age", max_age)) {
+        _should_flush.set_duration(max_age);
+    }
+    _use_gzip = _use_gzip and _compressor.supported_methods().has(
+                                data_compression_method::gzip);
+    _entry_arg_batch.reserve(std_size(_batch_size));
+}
 //------------------------------------------------------------------------------
 auto influxdb_stream_sink_factory::_make_write_url() noexcept -> std::string {
     const auto& q{_conn_params.query()};
@@ -366,7 +428,17 @@ auto influxdb_stream_sink_factory::make_stream() noexcept
     return {hold<influxdb_stream_sink>, _get_stream_id(), shared_from_this()};
 }
 //------------------------------------------------------------------------------
-void influxdb_stream_sink_factory::update() noexcept {}
+void influxdb_stream_sink_factory::update() noexcept {
+    if(_should_flush.is_expired()) {
+        _write_arg_data();
+        _should_flush.reset();
+    }
+    _retry_pending();
+    if(_should_report.is_expired()) {
+        _report_stats();
+        _should_report.reset();
+    }
+}
 //------------------------------------------------------------------------------
 auto influxdb_stream_sink_factory::consume(
   influxdb_stream_sink&,
@@ -416,56 +488,138 @@ void influxdb_stream_sink_factory::_append_data(
   const message_info& msg,
   const message_info::arg_info& arg) noexcept {
     if(const auto val{arg.value_float()}) {
-        append_to(
-          std::format(
-            "arg,stream={},app={},source={},msg_tag={},name={},arg_tag={}",
-            stream.id(),
-            std::string_view{stream.root().name()},
-            std::string_view{msg.source.name()},
-            std::string_view{msg.tag.name()},
-            std::string_view{arg.name.name()},
-            std::string_view{arg.tag.name()}),
-          _entry_arg_batch);
+        // the lines are formatted directly into the reused batch buffer
+        auto out{std::back_inserter(_entry_arg_batch)};
+        std::format_to(
+          out,
+          "arg,stream={},app={},source={},msg_tag={},name={},arg_tag={}",
+          stream.id(),
+          std::string_view{stream.root().name()},
+          std::string_view{msg.source.name()},
+          std::string_view{msg.tag.name()},
+          std::string_view{arg.name.name()},
+          std::string_view{arg.tag.name()});
 
         for(const auto& [name, value] : _stream_metadata[stream.id()]) {
-            _entry_arg_batch.append(",");
-            append_to(name, _entry_arg_batch);
-            _entry_arg_batch.append("=");
-            append_to(value, _entry_arg_batch);
+            std::format_to(
+              out, ",{}={}", std::string_view{name}, std::string_view{value});
         }
 
-        append_to(std::format(",instance={} ", msg.instance), _entry_arg_batch);
+        std::format_to(out, ",instance={} ", msg.instance);
 
         if(arg.min and arg.max) {
-            append_to(
-              std::format(
-                "value={},min={},max={}", *val, *(arg.min), *(arg.max)),
-              _entry_arg_batch);
+            std::format_to(
+              out, "value={},min={},max={}", *val, *(arg.min), *(arg.max));
         } else {
-            append_to(std::format("value={}", *val), _entry_arg_batch);
+            std::format_to(out, "value={}", *val);
         }
-        append_to(
-          std::format(" {}\n", stream.time_since_start(msg).count()),
-          _entry_arg_batch);
+        std::format_to(out, " {}\n", stream.time_since_start(msg).count());
     }
 }
 //------------------------------------------------------------------------------
-auto influxdb_stream_sink_factory::_write_arg_data() noexcept -> bool {
-    if(not _entry_arg_buffer.empty()) {
-        if(not _conn.reinit()
-                 .set_url(_write_url)
-                 .add_header(_auth_hdr)
-                 .post_data(_entry_arg_buffer)
-                 .perform()) {
+void influxdb_stream_sink_factory::_batch_appended() noexcept {
+    if(span_size(_entry_arg_batch.size()) >= _batch_size) {
+        _write_arg_data();
+    }
+}
+//------------------------------------------------------------------------------
+auto influxdb_stream_sink_factory::_post(memory::const_block payload) noexcept
+  -> bool {
+    _conn.reinit()
+      .set_url(_write_url)
+      .set_timeout(_post_timeout)
+      .add_header(_auth_hdr);
+    if(_use_gzip) {
+        _conn.add_header("Content-Encoding: gzip");
+    }
+    if(_conn.post_data(payload).perform()) {
+        const auto code{_conn.response_code()};
+        if((code >= 200) and (code < 300)) {
+            ++_stats.batches;
+            _stats.sent_bytes += payload.size();
+            return true;
+        }
+        if((code >= 400) and (code < 500) and (code != 429)) {
+            // the data was rejected, retrying would not help
+            ++_stats.rejected;
+            return true;
+        }
+    }
+    ++_stats.failed;
+    return false;
+}
+//------------------------------------------------------------------------------
+auto influxdb_stream_sink_factory::_retry_pending() noexcept -> bool {
+    while(not _retry_queue.empty()) {
+        if(not _should_retry.is_expired()) {
             return false;
         }
-        _entry_arg_buffer.clear();
+        if(not _post(view(_retry_queue.front()))) {
+            _should_retry.extend();
+            return false;
+        }
+        _should_retry.rewind();
+        _retry_bytes -= _retry_queue.front().size();
+        _buffers.eat(std::move(_retry_queue.front()));
+        _retry_queue.pop_front();
     }
-    append_to(_entry_arg_batch, _entry_arg_buffer);
-    _entry_arg_batch.clear();
     return true;
 }
 //------------------------------------------------------------------------------
+void influxdb_stream_sink_factory::_enqueue_retry(
+  memory::const_block payload) noexcept {
+    if(_retry_queue.empty()) {
+        _should_retry.rewind();
+    }
+    auto& queued{_retry_queue.emplace_back(_buffers.get(payload.size()))};
+    memory::copy_into(payload, queued);
+    _retry_bytes += queued.size();
+    // if the endpoint does not keep up, the oldest data is dropped
+    while((_retry_bytes > _max_retry_bytes) and (_retry_queue.size() > 1U)) {
+        ++_stats.dropped;
+        _retry_bytes -= _retry_queue.front().size();
+        _buffers.eat(std::move(_retry_queue.front()));
+        _retry_queue.pop_front();
+    }
+}
+//------------------------------------------------------------------------------
+auto influxdb_stream_sink_factory::_write_arg_data() noexcept -> bool {
+    if(_entry_arg_batch.empty()) {
+        return true;
+    }
+    auto payload{as_bytes(string_view{_entry_arg_batch})};
+    _stats.raw_bytes += payload.size();
+    if(_use_gzip) {
+        payload = _compressor.compress(
+          data_compression_method::gzip,
+          payload,
+          _compressed.clear(),
+          data_compression_level::lowest);
+    }
+    const bool posted{_retry_pending() and _post(payload)};
+    if(not posted) {
+        _enqueue_retry(payload);
+    }
+    _entry_arg_batch.clear();
+    _should_flush.reset();
+    return posted;
+}
+//------------------------------------------------------------------------------
+void influxdb_stream_sink_factory::_report_stats() noexcept {
+    if((_stats.batches > 0) or (_stats.failed > 0)) {
+        log_stat("posted ${batches} batches, ${sentBytes} bytes")
+          .tag("influxStat")
+          .arg("batches", _stats.batches)
+          .arg("rawBytes", "ByteSize", _stats.raw_bytes)
+          .arg("sentBytes", "ByteSize", _stats.sent_bytes)
+          .arg("failed", _stats.failed)
+          .arg("rejected", _stats.rejected)
+          .arg("dropped", _stats.dropped)
+          .arg("queued", "ByteSize", _retry_bytes);
+    }
+    _stats = {};
+}
+//------------------------------------------------------------------------------
 auto influxdb_stream_sink_factory::consume(
   influxdb_stream_sink& stream,
   const message_info& info) noexcept -> bool {
@@ -473,7 +627,7 @@ auto influxdb_stream_sink_factory::consume(
         _handle_special_arg(stream.id(), info, arg);
         _append_data(stream, info, arg);
     }
-    _write_arg_data();
+    _batch_appended();
     return true;
 }
 //------------------------------------------------------------------------------
@@ -488,29 +642,46 @@ auto influxdb_stream_sink_factory::consume(
     const auto to_ms{[](auto d) {
         return duration_cast<duration<float, std::milli>>(d).count();
     }};
-    _interval_buffer.clear();
-    append_to(
-      std::format(
-        "interval,stream={},app={},tag={},instance={} "
-        "hit_count={},hit_interval={},min={},avg={},max={} {}\n",
-        stream.id(),
-        std::string_view{stream.root().name()},
-        std::string_view{info.tag.name()},
-        info.instance,
-        info.hit_count(),
-        to_s(info.hit_interval()),
-        to_ms(info.min_duration()),
-        to_ms(info.avg_duration()),
-        to_ms(info.max_duration()),
-        stream.time_since_start().count()),
-      _interval_buffer);
-    if(not _conn.reinit()
-             .set_url(_write_url)
-             .add_header(_auth_hdr)
-             .post_data(_interval_buffer)
-             .perform()) {
-        return false;
-    }
+    std::format_to(
+      std::back_inserter(_entry_arg_batch),
+      "interval,stream={},app={},tag={},instance={} "
+      "hit_count={},hit_interval={},min={},avg={},max={},"
+      "p50={},p90={},p99={} {}\n",
+      stream.id(),
+      std::string_view{stream.root().name()},
+      std::string_view{info.tag.name()},
+      info.instance,
+      info.hit_count(),
+      to_s(info.hit_interval()),
+      to_ms(info.min_duration()),
+      to_ms(info.avg_duration()),
+      to_ms(info.max_duration()),
+      to_ms(info.p50_duration()),
+      to_ms(info.p90_duration()),
+      to_ms(info.p99_duration()),
+      stream.time_since_start().count());
+    _batch_appended();
+    return true;
+}
+//------------------------------------------------------------------------------
+auto influxdb_stream_sink_factory::consume(
+  influxdb_stream_sink& stream,
+  const chart_info& info) noexcept -> bool {
+    std::format_to(
+      std::back_inserter(_entry_arg_batch),
+      "chart,stream={},app={},source={},series={},instance={} "
+      "value={},min={},max={},count={} {}\n",
+      stream.id(),
+      std::string_view{stream.root().name()},
+      std::string_view{info.source.name()},
+      std::string_view{info.series.name()},
+      info.instance,
+      info.value,
+      info.min,
+      info.max,
+      info.count,
+      stream.time_since_start(info).count());
+    _batch_appended();
     return true;
 }
 //------------------------------------------------------------------------------
@@ -523,6 +694,7 @@ auto influxdb_stream_sink_factory::consume(
 auto influxdb_stream_sink_factory::consume(
   const influxdb_stream_sink&,
   const finish_info&) noexcept -> bool {
+    _write_arg_data();
     return true;
 }
 //------------------------------------------------------------------------------
@@ -18,14 +18,14 @@ using float_seconds = std::chrono::duration<float>;
 //------------------------------------------------------------------------------
 // parsed items
 //------------------------------------------------------------------------------
-struct begin_info {
+export struct begin_info {
     std::chrono::system_clock::time_point start{
       std::chrono::system_clock::now()};
     std::string session;
     std::string identity;
 };
 //------------------------------------------------------------------------------
-struct description_info {
+export struct description_info {
     float_seconds offset;
     identifier source;
     std::string display_name;
@@ -33,7 +33,7 @@ struct description_info {
     std::uint64_t instance{0};
 };
 //------------------------------------------------------------------------------
-struct declare_state_info {
+export struct declare_state_info {
     float_seconds offset;
     identifier source;
     identifier state_tag;
@@ -42,16 +42,23 @@ struct declare_state_info {
     std::uint64_t instance{0};
 };
 //------------------------------------------------------------------------------
-struct active_state_info {
+export struct active_state_info {
     float_seconds offset;
     identifier source;
     identifier tag;
     std::uint64_t instance{0};
 };
 //------------------------------------------------------------------------------
-struct message_info {
+export struct message_info {
+    message_info() noexcept = default;
+    message_info(message_info&&) noexcept;
+    message_info(const message_info&);
+    auto operator=(message_info&&) noexcept -> message_info&;
+    auto operator=(const message_info&) -> message_info&;
+    ~message_info() noexcept = default;
+
     float_seconds offset;
-    std::string format;
+    string_view format;
     log_event_severity severity;
     identifier source;
     identifier tag;
@@ -61,7 +68,7 @@ struct message_info {
         identifier name;
         identifier tag;
         std::variant<
-          std::string,
+          string_view,
           identifier,
           float_seconds,
           float,
@@ -85,19 +92,58 @@ struct message_info {
 
     auto find_arg(identifier) const noexcept
       -> optional_reference<const arg_info>;
+
+    /// @brief Copies the string into the storage owned by this message.
+    /// @see clear
+    ///
+    /// The format and the string argument values either view the data
+    /// being parsed or strings stored in the message. The storage is reused
+    /// by the subsequent messages, so the sinks must not keep the views
+    /// beyond the consume call. Copies of the message store their own strings.
+    auto store(string_view) -> string_view;
+
+    /// @brief Clears the format, arguments and stored strings.
+    /// @note Keeps the allocated capacity for the subsequent messages.
+    void clear() noexcept;
+
+private:
+    void _copy_from(const message_info&);
+
+    static constexpr const span_size_t _block_size{1024};
+    std::vector<memory::buffer> _blocks;
+    std::size_t _current{0U};
+    span_size_t _used{0};
 };
 //------------------------------------------------------------------------------
-struct interval_info {
+export struct interval_info {
     identifier tag;
     std::uint64_t instance{0};
     std::chrono::nanoseconds duration{0};
+    // the following are not sent by older backends reporting just the average
+    std::uint64_t count{0};
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p90{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds max{0};
 };
 //------------------------------------------------------------------------------
-struct heartbeat_info {
+export struct chart_info {
     float_seconds offset;
+    identifier source;
+    std::uint64_t instance{0};
+    identifier series;
+    // the mean if several samples were aggregated by the backend
+    float value{0.F};
+    float min{0.F};
+    float max{0.F};
+    std::uint64_t count{1};
 };
 //------------------------------------------------------------------------------
-struct finish_info {
+export struct heartbeat_info {
+    float_seconds offset;
+};
+//------------------------------------------------------------------------------
+export struct finish_info {
     float_seconds offset;
     bool clean{false};
 };
@@ -124,6 +170,9 @@ public:
     auto min_duration() const noexcept -> std::chrono::nanoseconds;
     auto max_duration() const noexcept -> std::chrono::nanoseconds;
     auto avg_duration() const noexcept -> std::chrono::nanoseconds;
+    auto p50_duration() const noexcept -> std::chrono::nanoseconds;
+    auto p90_duration() const noexcept -> std::chrono::nanoseconds;
+    auto p99_duration() const noexcept -> std::chrono::nanoseconds;
 
     identifier tag;
     std::uint64_t instance;
@@ -134,6 +183,7 @@ private:
     std::chrono::nanoseconds _duration_max{};
     std::chrono::nanoseconds _duration_sum{};
     span_size_t _count{0};
+    log_interval_histogram _histogram;
 };
 //------------------------------------------------------------------------------
 // aggregate intervals
@@ -154,7 +204,7 @@ private:
 //------------------------------------------------------------------------------
 // text output
 //------------------------------------------------------------------------------
-struct text_output : interface<text_output> {
+export struct text_output : interface<text_output> {
     virtual void write(const string_view) noexcept = 0;
     virtual void flush() noexcept = 0;
 };
@@ -171,13 +221,14 @@ export auto make_text_output(main_ctx&) -> unique_holder<text_output>;
 //------------------------------------------------------------------------------
 // object stream sink
 //------------------------------------------------------------------------------
-struct stream_sink : interface<stream_sink> {
+export struct stream_sink : interface<stream_sink> {
     virtual void consume(const begin_info&) noexcept = 0;
     virtual void consume(const description_info&) noexcept = 0;
     virtual void consume(const declare_state_info&) noexcept = 0;
     virtual void consume(const active_state_info&) noexcept = 0;
     virtual void consume(const message_info&) noexcept = 0;
     virtual void consume(const interval_info&) noexcept = 0;
+    virtual void consume(const chart_info&) noexcept = 0;
     virtual void consume(const heartbeat_info&) noexcept = 0;
     virtual void consume(const finish_info&) noexcept = 0;
 };
@@ -189,13 +240,13 @@ export struct stream_sink_factory : interface<stream_sink_factory> {
     virtual void update() noexcept = 0;
 };
 //------------------------------------------------------------------------------
-auto make_text_tree_sink_factory(main_ctx&, unique_holder<text_output>)
+export auto make_text_tree_sink_factory(main_ctx&, unique_holder<text_output>)
   -> shared_holder<stream_sink_factory>;
 //------------------------------------------------------------------------------
-auto make_influxdb_sink_factory(main_ctx&, string_view params) noexcept
+export auto make_influxdb_sink_factory(main_ctx&, string_view params) noexcept
   -> shared_holder<stream_sink_factory>;
 //------------------------------------------------------------------------------
-auto make_libpq_sink_factory(main_ctx&, string_view params) noexcept
+export auto make_libpq_sink_factory(main_ctx&, string_view params) noexcept
   -> shared_holder<stream_sink_factory>;
 //------------------------------------------------------------------------------
 auto make_combined_sink_factory(
@@ -203,6 +254,15 @@ auto make_combined_sink_factory(
   std::vector<shared_holder<stream_sink_factory>>) noexcept
   -> shared_holder<stream_sink_factory>;
 //------------------------------------------------------------------------------
+auto make_sharded_sink_factory(
+  main_ctx&,
+  std::vector<shared_holder<stream_sink_factory>>) noexcept
+  -> shared_holder<stream_sink_factory>;
+/// @brief Indicates if the calling thread is currently inside a sharded sink.
+auto sink_dispatch_active() noexcept -> bool&;
+//------------------------------------------------------------------------------
+auto reader_thread_count(main_ctx&) noexcept -> span_size_t;
+//------------------------------------------------------------------------------
 export auto make_sink_factory(main_ctx&) noexcept
   -> shared_holder<stream_sink_factory>;
 //------------------------------------------------------------------------------
@@ -210,6 +270,14 @@ export auto make_sink_factory(main_ctx&) noexcept
 //------------------------------------------------------------------------------
 auto make_json_parser(main_ctx&, shared_holder<stream_sink>) noexcept
   -> parser_input;
+export auto make_generic_json_parser(
+  main_ctx&,
+  shared_holder<stream_sink>) noexcept -> parser_input;
+auto make_binary_parser(main_ctx&, shared_holder<stream_sink>) noexcept
+  -> parser_input;
+auto make_format_detecting_parser(
+  main_ctx&,
+  shared_holder<stream_sink>) noexcept -> parser_input;
 //------------------------------------------------------------------------------
 export auto make_data_parser(main_ctx&, shared_holder<stream_sink>) noexcept
   -> parser_input;
@@ -255,6 +323,7 @@ private:
     static auto _single_instance_ptr() -> internal_backend*&;
 
     void _set_sink(unique_holder<stream_sink>) noexcept;
+    void _flush_backlog() noexcept;
 
     void _dispatch(auto&& entry) noexcept;
 
@@ -359,6 +428,8 @@ private:
 
     const std::chrono::steady_clock::time_point _start{
       std::chrono::steady_clock::now()};
+    std::mutex _mutex;
+    std::mutex _message_mutex;
     unique_holder<stream_sink> _sink;
     std::vector<std::variant<
       begin_info,
@@ -367,6 +438,7 @@ private:
       active_state_info,
       message_info,
       interval_info,
+      chart_info,
       heartbeat_info,
       finish_info>>
       _backlog;
@@ -31,11 +31,19 @@ internal_backend::~internal_backend() noexcept {
 }
 //------------------------------------------------------------------------------
 void internal_backend::_set_sink(unique_holder<stream_sink> sink) noexcept {
-    for(const auto& entry : _backlog) {
-        std::visit([&](const auto& info) { sink->consume(info); }, entry);
-    }
-    _backlog.clear();
     _sink = std::move(sink);
+    _flush_backlog();
+}
+//------------------------------------------------------------------------------
+void internal_backend::_flush_backlog() noexcept {
+    decltype(_backlog) backlog;
+    {
+        const std::lock_guard<std::mutex> lock{_mutex};
+        std::swap(backlog, _backlog);
+    }
+    for(const auto& entry : backlog) {
+        std::visit([&](const auto& info) { _sink->consume(info); }, entry);
+    }
 }
 //------------------------------------------------------------------------------
 void internal_backend::set_sink(unique_holder<stream_sink> stream) noexcept {
@@ -44,9 +52,13 @@ void internal_backend::set_sink(unique_holder<stream_sink> stream) noexcept {
 }
 //------------------------------------------------------------------------------
 void internal_backend::_dispatch(auto&& entry) noexcept {
-    if(_sink) {
+    // entries logged from inside a sink are deferred to avoid re-entering
+    // the sinks while they are locked
+    if(_sink and not sink_dispatch_active()) {
+        _flush_backlog();
         _sink->consume(entry);
     } else {
+        const std::lock_guard<std::mutex> lock{_mutex};
         _backlog.emplace_back(decltype(entry)(entry));
     }
 }
@@ -126,13 +138,15 @@ auto internal_backend::begin_message(
   logger_instance_id instance,
   log_event_severity severity,
   string_view format) noexcept -> bool {
+    // unlocked in finish_message, the log server reads on multiple threads
+    _message_mutex.lock();
+    _message.clear();
     _message.offset = _offset();
-    _message.format = to_string(format);
+    _message.format = _message.store(format);
     _message.severity = severity;
     _message.source = source;
     _message.tag = tag;
     _message.instance = instance;
-    _message.args.clear();
     return true;
 }
 //------------------------------------------------------------------------------
@@ -212,7 +226,7 @@ void internal_backend::add_string(
   identifier tag,
   string_view value) noexcept {
     _message.args.emplace_back(message_info::arg_info{
-      .name = name, .tag = tag, .value = to_string(value)});
+      .name = name, .tag = tag, .value = _message.store(value)});
 }
 //------------------------------------------------------------------------------
 void internal_backend::add_blob(
@@ -221,7 +235,16 @@ void internal_backend::add_blob(
   memory::const_block) noexcept {}
 //------------------------------------------------------------------------------
 void internal_backend::finish_message() noexcept {
-    _dispatch(_message);
+    // the sinks can log, so the message is moved out before dispatching
+    auto message{std::move(_message)};
+    _message_mutex.unlock();
+    _dispatch(message);
+    // give the string storage back for reuse by the subsequent messages,
+    // unless some other thread is already composing a message
+    if(_message_mutex.try_lock()) {
+        _message = std::move(message);
+        _message_mutex.unlock();
+    }
 }
 //------------------------------------------------------------------------------
 void internal_backend::heartbeat() noexcept {
@@ -233,9 +256,18 @@ void internal_backend::finish_log() noexcept {
 }
 //------------------------------------------------------------------------------
 void internal_backend::log_chart_sample(
-  identifier,
-  logger_instance_id,
-  identifier,
-  float) noexcept {}
+  identifier source,
+  logger_instance_id instance,
+  identifier series,
+  float value) noexcept {
+    _dispatch(chart_info{
+      .offset = _offset(),
+      .source = source,
+      .instance = instance,
+      .series = series,
+      .value = value,
+      .min = value,
+      .max = value});
+}
 //------------------------------------------------------------------------------
 } // namespace eagine::logs
@@ -75,9 +75,13 @@ auto istream_reader::run() noexcept -> bool {
                     return false;
                 }
                 const auto size{_input.gcount()};
-                _sink.consume_text(head(view(chunk), span_size(size)));
+                const bool parsed{
+                  _sink.consume_text(head(view(chunk), span_size(size)))};
                 _on_read(std_size(size));
                 _factory->update();
+                if(not parsed) {
+                    break;
+                }
                 alive.notify();
 
                 if(should_heartbeat) {
@@ -15,6 +15,7 @@ import std;
 import eagine.core;
 
 import :interfaces;
+import :utilities;
 
 namespace eagine::logs {
 //------------------------------------------------------------------------------
@@ -156,41 +157,16 @@ struct begin_extractor : begin_extractor_base {
     auto add(const extractor_arg<string_view>&) noexcept -> bool final;
 
 private:
-    auto _parse_timestamp(const string_view str)
-      -> optionally_valid<std::chrono::sys_time<std::chrono::microseconds>>;
-
-    const std::regex _ts_re{
-      R"(([0-9]{1,5}-[0-9]{2}-[0-9]{2} [0-9]{2}:[0-9]{2}:[0-9]{2})(\.[0-9]+))"};
+    const log_timestamp_parser _timestamp;
     const basic_string_path _tms_pattern{"_/time"};
     const basic_string_path _ssn_pattern{"_/session"};
     const basic_string_path _idy_pattern{"_/identity"};
 };
 //------------------------------------------------------------------------------
-auto begin_extractor::_parse_timestamp(const string_view str)
-  -> optionally_valid<std::chrono::sys_time<std::chrono::microseconds>> {
-    // TODO: replace this with std::chrono::from_stream/parse when possible
-    const auto ts_str{to_string(str)};
-    std::smatch ts_match{};
-    if(std::regex_match(ts_str, ts_match, _ts_re)) {
-        std::stringstream src{ts_str};
-        std::tm temp{};
-        if((src >> std::get_time(&temp, "%Y-%m-%d %T")).good()) {
-            if(const auto ts{::timegm(&temp)}; ts > 0) {
-                return {
-                  std::chrono::system_clock::from_time_t(ts) +
-                  std::chrono::duration_cast<std::chrono::microseconds>(
-                    std::chrono::duration<float>(
-                      std::strtof(std::string(ts_match[2]).c_str(), nullptr)))};
-            }
-        }
-    }
-    return {};
-}
-//------------------------------------------------------------------------------
 auto begin_extractor::add(const extractor_arg<string_view>& a) noexcept
   -> bool {
     if(a.path.like(_tms_pattern)) {
-        if(const auto ts{_parse_timestamp(a.value)}) {
+        if(const auto ts{_timestamp.parse(a.value)}) {
             this->info.start = *ts;
         }
         return true;
@@ -255,17 +231,20 @@ struct message_extractor : message_extractor_base {
 private:
     template <typename T>
     auto _add_value(const extractor_arg<T>&) noexcept -> bool;
+    void _arg_unit() noexcept;
 
     basic_string_path _fmt_pattern{"_/f"};
     basic_string_path _lvl_pattern{"_/lvl"};
     basic_string_path _atr_pattern{"_/a/_/*"};
 
     arg_value_translator _arg_translator;
+    // the current argument has the "u":"s" unit, in either field order
+    bool _arg_in_seconds{false};
 };
 //------------------------------------------------------------------------------
 void message_extractor::reset() noexcept {
     this->info.tag = {};
-    this->info.args.clear();
+    this->info.clear();
 }
 //------------------------------------------------------------------------------
 template <typename T>
@@ -273,6 +252,7 @@ auto message_extractor::_add_value(const extractor_arg<T>& a) noexcept -> bool {
     if(a.path.like(_atr_pattern)) {
         if(a.path.ends_with("v")) {
             this->info.args.back().value = a.value;
+            _arg_unit();
             return true;
         }
         if constexpr(std::is_arithmetic_v<T>) {
@@ -310,7 +290,7 @@ auto message_extractor::add(const extractor_arg<float>& a) noexcept -> bool {
 auto message_extractor::add(const extractor_arg<string_view>& a) noexcept
   -> bool {
     if(a.path.like(_fmt_pattern)) {
-        assign_to(a.value, this->info.format);
+        this->info.format = this->info.store(a.value);
         return true;
     } else if(a.path.like(_lvl_pattern)) {
         this->info.severity = from_string<log_event_severity>(a.value).value_or(
@@ -324,7 +304,13 @@ auto message_extractor::add(const extractor_arg<string_view>& a) noexcept
             this->info.args.back().tag = identifier{a.value};
             return true;
         } else if(a.path.ends_with("v")) {
-            this->info.args.back().value = to_string(a.value);
+            this->info.args.back().value = this->info.store(a.value);
+            return true;
+        } else if(a.path.ends_with("u")) {
+            if(a.value == string_view{"s"}) {
+                _arg_in_seconds = true;
+                _arg_unit();
+            }
             return true;
         }
     } else {
@@ -333,8 +319,18 @@ auto message_extractor::add(const extractor_arg<string_view>& a) noexcept
     return false;
 }
 //------------------------------------------------------------------------------
+void message_extractor::_arg_unit() noexcept {
+    if(_arg_in_seconds) {
+        auto& arg{this->info.args.back()};
+        if(const auto value{arg.value_duration()}) {
+            arg.value = *value;
+        }
+    }
+}
+//------------------------------------------------------------------------------
 void message_extractor::add_arg() noexcept {
     this->info.args.emplace_back();
+    _arg_in_seconds = false;
 }
 //------------------------------------------------------------------------------
 void message_extractor::consume_by(stream_sink& sink) noexcept {
@@ -350,6 +346,10 @@ using interval_extractor_base =
   instance_extractor<tag_extractor<info_extractor<interval_info>>>;
 //------------------------------------------------------------------------------
 struct interval_extractor : interval_extractor_base {
+    void reset() noexcept final {
+        this->info = {};
+    }
+
     auto add(const extractor_arg<std::int64_t>&) noexcept -> bool final;
     auto add(const extractor_arg<std::uint64_t>&) noexcept -> bool final;
 
@@ -358,6 +358,11 @@ private:
     auto _add_value(const extractor_arg<T>&) noexcept -> bool;
 
     basic_string_path _tns_pattern{"_/tns"};
+    basic_string_path _cnt_pattern{"_/cnt"};
+    basic_string_path _p50_pattern{"_/p50"};
+    basic_string_path _p90_pattern{"_/p90"};
+    basic_string_path _p99_pattern{"_/p99"};
+    basic_string_path _max_pattern{"_/max"};
 };
 //------------------------------------------------------------------------------
 template <typename T>
@@ -367,6 +372,26 @@ auto interval_extractor::_add_value(const extractor_arg<T>& a) noexcept
         this->info.duration = std::chrono::nanoseconds{a.value};
         return true;
     }
+    if(a.path.like(_cnt_pattern)) {
+        this->info.count = std::uint64_t(a.value);
+        return true;
+    }
+    if(a.path.like(_p50_pattern)) {
+        this->info.p50 = std::chrono::nanoseconds{a.value};
+        return true;
+    }
+    if(a.path.like(_p90_pattern)) {
+        this->info.p90 = std::chrono::nanoseconds{a.value};
+        return true;
+    }
+    if(a.path.like(_p99_pattern)) {
+        this->info.p99 = std::chrono::nanoseconds{a.value};
+        return true;
+    }
+    if(a.path.like(_max_pattern)) {
+        this->info.max = std::chrono::nanoseconds{a.value};
+        return true;
+    }
     return interval_extractor_base::add(a);
 }
 //------------------------------------------------------------------------------
@@ -380,6 +405,88 @@ auto interval_extractor::add(const extractor_arg<std::uint64_t>& a) noexcept
     return _add_value(a);
 }
 //------------------------------------------------------------------------------
+// chart extractor
+//------------------------------------------------------------------------------
+using chart_extractor_base = instance_extractor<
+  source_extractor<offset_extractor<info_extractor<chart_info>>>>;
+//------------------------------------------------------------------------------
+struct chart_extractor : chart_extractor_base {
+    void reset() noexcept final {
+        this->info = {};
+    }
+
+    auto add(const extractor_arg<std::int64_t>&) noexcept -> bool final;
+    auto add(const extractor_arg<std::uint64_t>&) noexcept -> bool final;
+    auto add(const extractor_arg<float>&) noexcept -> bool final;
+    auto add(const extractor_arg<string_view>&) noexcept -> bool final;
+    void consume_by(stream_sink& sink) noexcept final;
+
+private:
+    template <typename T>
+    auto _add_value(const extractor_arg<T>&) noexcept -> bool;
+
+    basic_string_path _ser_pattern{"_/ser"};
+    basic_string_path _val_pattern{"_/v"};
+    basic_string_path _cnt_pattern{"_/cnt"};
+    basic_string_path _min_pattern{"_/min"};
+    basic_string_path _max_pattern{"_/max"};
+};
+//------------------------------------------------------------------------------
+template <typename T>
+auto chart_extractor::_add_value(const extractor_arg<T>& a) noexcept -> bool {
+    if(a.path.like(_val_pattern)) {
+        this->info.value = float(a.value);
+        return true;
+    }
+    if(a.path.like(_min_pattern)) {
+        this->info.min = float(a.value);
+        return true;
+    }
+    if(a.path.like(_max_pattern)) {
+        this->info.max = float(a.value);
+        return true;
+    }
+    if constexpr(std::is_integral_v<T>) {
+        if(a.path.like(_cnt_pattern)) {
+            this->info.count = std::uint64_t(a.value);
+            return true;
+        }
+    }
+    return chart_extractor_base::add(a);
+}
+//------------------------------------------------------------------------------
+auto chart_extractor::add(const extractor_arg<std::int64_t>& a) noexcept
+  -> bool {
+    return _add_value(a);
+}
+//------------------------------------------------------------------------------
+auto chart_extractor::add(const extractor_arg<std::uint64_t>& a) noexcept
+  -> bool {
+    return _add_value(a);
+}
+//------------------------------------------------------------------------------
+auto chart_extractor::add(const extractor_arg<float>& a) noexcept -> bool {
+    return _add_value(a);
+}
+//------------------------------------------------------------------------------
+auto chart_extractor::add(const extractor_arg<string_view>& a) noexcept
+  -> bool {
+    if(a.path.like(_ser_pattern)) {
+        this->info.series = identifier{a.value};
+        return true;
+    }
+    return chart_extractor_base::add(a);
+}
+//------------------------------------------------------------------------------
+void chart_extractor::consume_by(stream_sink& sink) noexcept {
+    // single samples are sent without the range
+    if(this->info.count <= 1U) {
+        this->info.min = this->info.value;
+        this->info.max = this->info.value;
+    }
+    chart_extractor_base::consume_by(sink);
+}
+//------------------------------------------------------------------------------
 // heartbeat extractor
 //------------------------------------------------------------------------------
 using heartbeat_extractor = offset_extractor<info_extractor<heartbeat_info>>;
@@ -444,6 +551,7 @@ json_data_extractor::json_data_extractor(
     _extractors["begin"].emplace_derived(hold<begin_extractor>);
     _extractors["m"].emplace_derived(hold<message_extractor>);
     _extractors["i"].emplace_derived(hold<interval_extractor>);
+    _extractors["c"].emplace_derived(hold<chart_extractor>);
     _extractors["ds"].emplace_derived(hold<declare_state_extractor>);
     _extractors["as"].emplace_derived(hold<active_state_extractor>);
     _extractors["hb"].emplace_derived(hold<heartbeat_extractor>);
@@ -553,8 +661,9 @@ void json_data_extractor::failed() noexcept {
 //------------------------------------------------------------------------------
 // make extractor
 //------------------------------------------------------------------------------
-auto make_json_parser(main_ctx& ctx, shared_holder<stream_sink> stream) noexcept
-  -> parser_input {
+auto make_generic_json_parser(
+  main_ctx& ctx,
+  shared_holder<stream_sink> stream) noexcept -> parser_input {
     return valtree::traverse_json_stream(
       {hold<json_data_extractor>, std::move(stream)}, ctx.buffers(), ctx.log());
 }
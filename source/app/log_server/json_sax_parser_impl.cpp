@@ -0,0 +1,716 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module;
+
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+
+module eagine.core.log_server;
+
+import std;
+import eagine.core;
+
+import :interfaces;
+import :utilities;
+
+namespace eagine::logs {
+//------------------------------------------------------------------------------
+// log entry schema
+//------------------------------------------------------------------------------
+enum class json_log_entry : std::uint8_t {
+    unknown,
+    begin,
+    description,
+    declare_state,
+    active_state,
+    message,
+    interval,
+    chart,
+    heartbeat,
+    finish
+};
+//------------------------------------------------------------------------------
+static auto json_log_entry_of(const std::string_view type) noexcept
+  -> json_log_entry {
+    switch(type.size()) {
+        case 1:
+            switch(type.front()) {
+                case 'm':
+                    return json_log_entry::message;
+                case 'i':
+                    return json_log_entry::interval;
+                case 'c':
+                    return json_log_entry::chart;
+                case 'd':
+                    return json_log_entry::description;
+                default:
+                    break;
+            }
+            break;
+        case 2:
+            if(type == "hb") {
+                return json_log_entry::heartbeat;
+            } else if(type == "ds") {
+                return json_log_entry::declare_state;
+            } else if(type == "as") {
+                return json_log_entry::active_state;
+            }
+            break;
+        case 3:
+            if(type == "end") {
+                return json_log_entry::finish;
+            }
+            break;
+        case 5:
+            if(type == "begin") {
+                return json_log_entry::begin;
+            }
+            break;
+        default:
+            break;
+    }
+    return json_log_entry::unknown;
+}
+//------------------------------------------------------------------------------
+// The same field names are used in the entry and in the argument objects,
+// the "t" field is the entry type in entries and the tag in arguments.
+enum class json_log_field : std::uint8_t {
+    unknown,
+    t,
+    time,
+    session,
+    identity,
+    source,
+    instance,
+    offset,
+    tag,
+    display_name,
+    description,
+    begin_tag,
+    end_tag,
+    severity,
+    format,
+    args,
+    duration,
+    count,
+    p50,
+    p90,
+    p99,
+    min,
+    max,
+    series,
+    name,
+    unit,
+    value
+};
+//------------------------------------------------------------------------------
+static auto json_log_field_of(const std::string_view key) noexcept
+  -> json_log_field {
+    switch(key.size()) {
+        case 1:
+            switch(key.front()) {
+                case 't':
+                    return json_log_field::t;
+                case 'v':
+                    return json_log_field::value;
+                case 'u':
+                    return json_log_field::unit;
+                case 'n':
+                    return json_log_field::name;
+                case 'f':
+                    return json_log_field::format;
+                case 'a':
+                    return json_log_field::args;
+                default:
+                    break;
+            }
+            break;
+        case 2:
+            if(key == "ts") {
+                return json_log_field::offset;
+            } else if(key == "dn") {
+                return json_log_field::display_name;
+            }
+            break;
+        case 3:
+            if(key == "src") {
+                return json_log_field::source;
+            } else if(key == "iid") {
+                return json_log_field::instance;
+            } else if(key == "tag") {
+                return json_log_field::tag;
+            } else if(key == "lvl") {
+                return json_log_field::severity;
+            } else if(key == "tns") {
+                return json_log_field::duration;
+            } else if(key == "cnt") {
+                return json_log_field::count;
+            } else if(key == "min") {
+                return json_log_field::min;
+            } else if(key == "max") {
+                return json_log_field::max;
+            } else if(key == "p50") {
+                return json_log_field::p50;
+            } else if(key == "p90") {
+                return json_log_field::p90;
+            } else if(key == "p99") {
+                return json_log_field::p99;
+            } else if(key == "ser") {
+                return json_log_field::series;
+            } else if(key == "bgn") {
+                return json_log_field::begin_tag;
+            } else if(key == "end") {
+                return json_log_field::end_tag;
+            }
+            break;
+        case 4:
+            if(key == "time") {
+                return json_log_field::time;
+            } else if(key == "desc") {
+                return json_log_field::description;
+            }
+            break;
+        case 7:
+            if(key == "session") {
+                return json_log_field::session;
+            }
+            break;
+        case 8:
+            if(key == "identity") {
+                return json_log_field::identity;
+            }
+            break;
+        default:
+            break;
+    }
+    return json_log_field::unknown;
+}
+//------------------------------------------------------------------------------
+// JSON SAX data parser
+//------------------------------------------------------------------------------
+// Parses the JSON log stream written by the JSON log backend, without going
+// through the generic value tree object builder. The top-level array is split
+// into entries by a simple scanner and each complete entry is parsed by
+// the rapidjson SAX reader, with the handler filling the parsed items in
+// place depending on the known field names.
+class json_sax_data_parser final
+  : public valtree::value_tree_stream_parser
+  , public rapidjson::
+      BaseReaderHandler<rapidjson::UTF8<>, json_sax_data_parser> {
+public:
+    json_sax_data_parser(shared_holder<stream_sink> stream) noexcept
+      : _stream{std::move(stream)} {}
+
+    auto begin() noexcept -> bool final;
+    auto parse_data(memory::const_block data) noexcept -> bool final;
+    auto finish() noexcept -> bool final;
+
+    // rapidjson handler API
+    auto Null() noexcept -> bool {
+        return true;
+    }
+    auto Bool(bool value) noexcept -> bool {
+        if(_state == _parse_state::arg and _field == json_log_field::value) {
+            _message.args.back().value = value;
+        }
+        return true;
+    }
+    auto Int(int value) noexcept -> bool {
+        return Int64(value);
+    }
+    auto Uint(unsigned value) noexcept -> bool {
+        return Uint64(value);
+    }
+    auto Int64(std::int64_t value) noexcept -> bool {
+        _number(value);
+        return true;
+    }
+    auto Uint64(std::uint64_t value) noexcept -> bool {
+        _number(value);
+        return true;
+    }
+    auto Double(double value) noexcept -> bool {
+        _number(float(value));
+        return true;
+    }
+    auto String(const char* str, rapidjson::SizeType length, bool) noexcept
+      -> bool {
+        _string({str, span_size(length)});
+        return true;
+    }
+    auto Key(const char* str, rapidjson::SizeType length, bool) noexcept
+      -> bool {
+        _field = json_log_field_of({str, length});
+        return true;
+    }
+    auto StartObject() noexcept -> bool;
+    auto EndObject(rapidjson::SizeType) noexcept -> bool;
+    auto StartArray() noexcept -> bool;
+    auto EndArray(rapidjson::SizeType) noexcept -> bool;
+
+private:
+    enum class _parse_state : std::uint8_t { none, entry, args, arg, skip };
+
+    struct _entry_fields {
+        json_log_entry type{json_log_entry::unknown};
+        float_seconds offset{};
+        identifier source;
+        identifier tag;
+        identifier series;
+        identifier begin_tag;
+        identifier end_tag;
+        std::uint64_t instance{0U};
+        std::uint64_t count{0U};
+        std::int64_t duration{0};
+        std::int64_t p50{0};
+        std::int64_t p90{0};
+        std::int64_t p99{0};
+        std::int64_t max_ns{0};
+        float value{0.F};
+        float min{0.F};
+        float max{0.F};
+        std::optional<std::chrono::sys_time<std::chrono::microseconds>> start;
+    };
+
+    auto _parse_entry(string_view) noexcept -> bool;
+    void _skip(_parse_state) noexcept;
+    void _string(string_view) noexcept;
+    template <typename T>
+    void _number(T) noexcept;
+    void _arg_unit() noexcept;
+    void _consume_entry() noexcept;
+
+    shared_holder<stream_sink> _stream;
+    rapidjson::Reader _reader;
+    // the incomplete entry from the end of the previous chunk
+    std::string _pending;
+    int _depth{0};
+    bool _in_string{false};
+    bool _escaped{false};
+    bool _clean_finish{false};
+
+    _parse_state _state{_parse_state::none};
+    // the current argument has the "u":"s" unit, in either field order
+    bool _arg_in_seconds{false};
+    _parse_state _skipped_from{_parse_state::none};
+    int _skip_depth{0};
+    json_log_field _field{json_log_field::unknown};
+    _entry_fields _entry;
+    std::string _session;
+    std::string _identity;
+    std::string _display_name;
+    std::string _description;
+    message_info _message{};
+    const log_timestamp_parser _timestamp;
+    arg_value_translator _arg_translator;
+};
+//------------------------------------------------------------------------------
+auto json_sax_data_parser::begin() noexcept -> bool {
+    _pending.clear();
+    _depth = 0;
+    _in_string = false;
+    _escaped = false;
+    _clean_finish = false;
+    return true;
+}
+//------------------------------------------------------------------------------
+auto json_sax_data_parser::parse_data(memory::const_block data) noexcept
+  -> bool {
+    try {
+        const auto chars{as_chars(data)};
+        const char* const ptr{chars.data()};
+        const auto size{std_size(chars.size())};
+        // entries are at depth 2, inside of the top-level array
+        std::size_t entry_begin{0U};
+
+        for(std::size_t i = 0U; i < size; ++i) {
+            const char c{ptr[i]};
+            if(_in_string) {
+                if(_escaped) {
+                    _escaped = false;
+                } else if(c == '\\') {
+                    _escaped = true;
+                } else if(c == '"') {
+                    _in_string = false;
+                }
+                continue;
+            }
+            switch(c) {
+                case '"':
+                    _in_string = true;
+                    break;
+                case '{':
+                case '[':
+                    if(++_depth == 2) {
+                        entry_begin = i;
+                    }
+                    break;
+                case '}':
+                case ']':
+                    if(--_depth == 1) {
+                        const string_view entry{
+                          ptr + entry_begin, span_size(i + 1U - entry_begin)};
+                        bool parsed{false};
+                        if(_pending.empty()) {
+                            parsed = _parse_entry(entry);
+                        } else {
+                            _pending.append(entry);
+                            parsed = _parse_entry(string_view{_pending});
+                            _pending.clear();
+                        }
+                        if(not parsed) {
+                            return false;
+                        }
+                    } else if(_depth <= 0) {
+                        // the end of the top-level array, anything
+                        // after it is not part of the log stream
+                        _depth = 0;
+                        return true;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        if(_depth >= 2) {
+            _pending.append(ptr + entry_begin, size - entry_begin);
+        }
+        return true;
+    } catch(...) {
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto json_sax_data_parser::finish() noexcept -> bool {
+    if(not _clean_finish) {
+        _stream->consume(finish_info{});
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+auto json_sax_data_parser::_parse_entry(string_view entry) noexcept -> bool {
+    constexpr const auto flags{
+      rapidjson::kParseDefaultFlags | rapidjson::kParseStopWhenDoneFlag |
+      rapidjson::kParseTrailingCommasFlag};
+    rapidjson::MemoryStream input{entry.data(), entry.std_size()};
+    _state = _parse_state::none;
+    return not _reader.Parse<flags>(input, *this).IsError();
+}
+//------------------------------------------------------------------------------
+void json_sax_data_parser::_skip(_parse_state from) noexcept {
+    _skipped_from = from;
+    _skip_depth = 1;
+    _state = _parse_state::skip;
+}
+//------------------------------------------------------------------------------
+auto json_sax_data_parser::StartObject() noexcept -> bool {
+    switch(_state) {
+        case _parse_state::none:
+            _entry = {};
+            _session.clear();
+            _identity.clear();
+            _display_name.clear();
+            _description.clear();
+            _message.clear();
+            _field = json_log_field::unknown;
+            _state = _parse_state::entry;
+            break;
+        case _parse_state::args:
+            _message.args.emplace_back();
+            _field = json_log_field::unknown;
+            _arg_in_seconds = false;
+            _state = _parse_state::arg;
+            break;
+        case _parse_state::skip:
+            ++_skip_depth;
+            break;
+        default:
+            _skip(_state);
+            break;
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+auto json_sax_data_parser::EndObject(rapidjson::SizeType) noexcept -> bool {
+    switch(_state) {
+        case _parse_state::entry:
+            _consume_entry();
+            _state = _parse_state::none;
+            break;
+        case _parse_state::arg:
+            _state = _parse_state::args;
+            break;
+        case _parse_state::skip:
+            if(--_skip_depth == 0) {
+                _state = _skipped_from;
+            }
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+auto json_sax_data_parser::StartArray() noexcept -> bool {
+    if(_state == _parse_state::entry and _field == json_log_field::args) {
+        _state = _parse_state::args;
+    } else if(_state == _parse_state::skip) {
+        ++_skip_depth;
+    } else {
+        _skip(_state);
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+auto json_sax_data_parser::EndArray(rapidjson::SizeType) noexcept -> bool {
+    if(_state == _parse_state::args) {
+        _state = _parse_state::entry;
+    } else if(_state == _parse_state::skip) {
+        if(--_skip_depth == 0) {
+            _state = _skipped_from;
+        }
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+void json_sax_data_parser::_string(string_view value) noexcept {
+    if(_state == _parse_state::arg) {
+        auto& arg{_message.args.back()};
+        switch(_field) {
+            case json_log_field::name:
+                arg.name = identifier{value};
+                break;
+            case json_log_field::t:
+                arg.tag = identifier{value};
+                break;
+            case json_log_field::value:
+                arg.value = _message.store(value);
+                break;
+            case json_log_field::unit:
+                if(value == string_view{"s"}) {
+                    _arg_in_seconds = true;
+                    _arg_unit();
+                }
+                break;
+            default:
+                break;
+        }
+    } else if(_state == _parse_state::entry) {
+        switch(_field) {
+            case json_log_field::t:
+                _entry.type = json_log_entry_of(value);
+                break;
+            case json_log_field::source:
+                _entry.source = identifier{value};
+                break;
+            case json_log_field::tag:
+                _entry.tag = identifier{value};
+                break;
+            case json_log_field::severity:
+                _message.severity = from_string<log_event_severity>(value)
+                                      .value_or(log_event_severity::info);
+                break;
+            case json_log_field::format:
+                _message.format = _message.store(value);
+                break;
+            case json_log_field::series:
+                _entry.series = identifier{value};
+                break;
+            case json_log_field::begin_tag:
+                _entry.begin_tag = identifier{value};
+                break;
+            case json_log_field::end_tag:
+                _entry.end_tag = identifier{value};
+                break;
+            case json_log_field::time:
+                try {
+                    if(const auto ts{_timestamp.parse(value)}) {
+                        _entry.start = *ts;
+                    }
+                } catch(...) {
+                }
+                break;
+            case json_log_field::session:
+                assign_to(value, _session);
+                break;
+            case json_log_field::identity:
+                assign_to(value, _identity);
+                break;
+            case json_log_field::display_name:
+                assign_to(value, _display_name);
+                break;
+            case json_log_field::description:
+                assign_to(value, _description);
+                break;
+            default:
+                break;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+template <typename T>
+void json_sax_data_parser::_number(T value) noexcept {
+    if(_state == _parse_state::arg) {
+        auto& arg{_message.args.back()};
+        switch(_field) {
+            case json_log_field::value:
+                arg.value = value;
+                _arg_unit();
+                break;
+            case json_log_field::min:
+                arg.min = float(value);
+                break;
+            case json_log_field::max:
+                arg.max = float(value);
+                break;
+            default:
+                break;
+        }
+    } else if(_state == _parse_state::entry) {
+        switch(_field) {
+            case json_log_field::offset:
+                _entry.offset = float_seconds(float(value));
+                break;
+            case json_log_field::instance:
+                _entry.instance = std::uint64_t(value);
+                break;
+            case json_log_field::value:
+                _entry.value = float(value);
+                break;
+            case json_log_field::count:
+                _entry.count = std::uint64_t(value);
+                break;
+            case json_log_field::duration:
+                _entry.duration = std::int64_t(value);
+                break;
+            case json_log_field::p50:
+                _entry.p50 = std::int64_t(value);
+                break;
+            case json_log_field::p90:
+                _entry.p90 = std::int64_t(value);
+                break;
+            case json_log_field::p99:
+                _entry.p99 = std::int64_t(value);
+                break;
+            case json_log_field::min:
+                _entry.min = float(value);
+                break;
+            case json_log_field::max:
+                // nanoseconds in intervals, sample value in charts
+                _entry.max_ns = std::int64_t(value);
+                _entry.max = float(value);
+                break;
+            default:
+                break;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void json_sax_data_parser::_arg_unit() noexcept {
+    if(_arg_in_seconds) {
+        auto& arg{_message.args.back()};
+        if(const auto value{arg.value_duration()}) {
+            arg.value = *value;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void json_sax_data_parser::_consume_entry() noexcept {
+    switch(_entry.type) {
+        case json_log_entry::begin: {
+            begin_info info{.session = _session, .identity = _identity};
+            if(_entry.start) {
+                info.start = *_entry.start;
+            }
+            _stream->consume(info);
+            break;
+        }
+        case json_log_entry::description:
+            _stream->consume(description_info{
+              .offset = _entry.offset,
+              .source = _entry.source,
+              .display_name = _display_name,
+              .description = _description,
+              .instance = _entry.instance});
+            break;
+        case json_log_entry::declare_state:
+            _stream->consume(declare_state_info{
+              .offset = _entry.offset,
+              .source = _entry.source,
+              .state_tag = _entry.tag,
+              .begin_tag = _entry.begin_tag,
+              .end_tag = _entry.end_tag,
+              .instance = _entry.instance});
+            break;
+        case json_log_entry::active_state:
+            _stream->consume(active_state_info{
+              .offset = _entry.offset,
+              .source = _entry.source,
+              .tag = _entry.tag,
+              .instance = _entry.instance});
+            break;
+        case json_log_entry::message:
+            _message.offset = _entry.offset;
+            _message.source = _entry.source;
+            _message.tag = _entry.tag;
+            _message.instance = _entry.instance;
+            for(auto& arg : _message.args) {
+                _arg_translator.translate(_message, arg);
+            }
+            _stream->consume(_message);
+            break;
+        case json_log_entry::interval:
+            _stream->consume(interval_info{
+              .tag = _entry.tag,
+              .instance = _entry.instance,
+              .duration = std::chrono::nanoseconds{_entry.duration},
+              .count = _entry.count,
+              .p50 = std::chrono::nanoseconds{_entry.p50},
+              .p90 = std::chrono::nanoseconds{_entry.p90},
+              .p99 = std::chrono::nanoseconds{_entry.p99},
+              .max = std::chrono::nanoseconds{_entry.max_ns}});
+            break;
+        case json_log_entry::chart: {
+            chart_info info{
+              .offset = _entry.offset,
+              .source = _entry.source,
+              .instance = _entry.instance,
+              .series = _entry.series,
+              .value = _entry.value,
+              .min = _entry.min,
+              .max = _entry.max,
+              .count = std::max(_entry.count, std::uint64_t(1U))};
+            // single samples are sent without the range
+            if(info.count <= 1U) {
+                info.min = info.value;
+                info.max = info.value;
+            }
+            _stream->consume(info);
+            break;
+        }
+        case json_log_entry::heartbeat:
+            _stream->consume(heartbeat_info{.offset = _entry.offset});
+            break;
+        case json_log_entry::finish:
+            _stream->consume(
+              finish_info{.offset = _entry.offset, .clean = true});
+            _clean_finish = true;
+            break;
+        case json_log_entry::unknown:
+            break;
+    }
+}
+//------------------------------------------------------------------------------
+// make parser
+//------------------------------------------------------------------------------
+auto make_json_parser(main_ctx&, shared_holder<stream_sink> stream) noexcept
+  -> parser_input {
+    return {{hold<json_sax_data_parser>, std::move(stream)}};
+}
+//------------------------------------------------------------------------------
+} // namespace eagine::logs
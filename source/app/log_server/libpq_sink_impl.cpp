@@ -44,6 +44,11 @@ public:
         return is_ok();
     }
 
+    auto is_command_ok() const noexcept -> bool {
+        return result_handle::operator bool() and
+               (::PQresultStatus(get()) == PGRES_COMMAND_OK);
+    }
+
     auto get_value(int row, int col) const noexcept -> string_view {
         return {
           static_cast<const char*>(::PQgetvalue(get(), row, col)),
@@ -56,8 +61,92 @@ public:
     }
 };
 //------------------------------------------------------------------------------
+// Buffers the invocations of prepared statements and their text parameters
+// so that they can be sent to the server together.
+class statement_batch {
+public:
+    static constexpr const int max_params{8};
+
+    // returns false and leaves the batch unchanged if out of memory
+    template <typename... Args>
+    auto add(const char* statement, const Args&... args) noexcept -> bool {
+        static_assert(sizeof...(Args) <= max_params);
+        const auto row_count{_rows.size()};
+        const auto param_count{_params.size()};
+        const auto data_size{_data.size()};
+        try {
+            _rows.push_back(
+              {.statement = statement,
+               .first_param = param_count,
+               .param_count = int(sizeof...(Args))});
+            (_add_param(args), ...);
+            return true;
+        } catch(const std::bad_alloc&) {
+            _rows.resize(row_count);
+            _params.resize(param_count);
+            _data.resize(data_size);
+            return false;
+        }
+    }
+
+    auto empty() const noexcept -> bool {
+        return _rows.empty();
+    }
+
+    auto row_count() const noexcept -> span_size_t {
+        return span_size(_rows.size());
+    }
+
+    void clear() noexcept {
+        _rows.clear();
+        _params.clear();
+        _data.clear();
+    }
+
+    void for_each_row(auto func) const noexcept {
+        std::array<const char*, max_params> values{};
+        for(const auto& row : _rows) {
+            for(int p = 0; p < row.param_count; ++p) {
+                const auto& param{_params[row.first_param + std_size(p)]};
+                values[std_size(p)] =
+                  param.is_null ? nullptr : _data.data() + param.offset;
+            }
+            func(row.statement, row.param_count, values.data());
+        }
+    }
+
+private:
+    struct _row {
+        const char* statement{nullptr};
+        std::size_t first_param{0U};
+        int param_count{0};
+    };
+
+    struct _param {
+        std::size_t offset{0U};
+        bool is_null{false};
+    };
+
+    void _add_param(const nothing_t) {
+        _params.push_back({.is_null = true});
+    }
+
+    void _add_param(const auto& arg) {
+        const auto offset{_data.size()};
+        append_sql_param(arg, _data).push_back('\0');
+        _params.push_back({.offset = offset});
+    }
+
+    std::vector<_row> _rows;
+    std::vector<_param> _params;
+    std::string _data;
+};
+//------------------------------------------------------------------------------
 class connection : connection_handle {
 public:
+    /// @brief Maximum number of pipelined statements between syncs.
+    static constexpr const int max_in_flight{256};
+
     connection(PGconn* conn) noexcept
       : connection_handle{conn, ::PQfinish} {}
 
@@ -83,6 +172,73 @@ public:
         return is_ok();
     }
 
+    auto prepare(const char* name, string_view sql, int param_count)
+      const noexcept -> bool {
+        if(is_ok()) {
+            return result{::PQprepare(
+                            get(), name, c_str(sql), param_count, nullptr)}
+              .is_command_ok();
+        }
+        return false;
+    }
+
+    auto execute(const statement_batch& batch) const noexcept -> bool {
+        if(not is_ok()) {
+            return false;
+        }
+#ifdef LIBPQ_HAS_PIPELINING
+        // the statements are sent without waiting for the individual results.
+        // the number of statements in flight is limited, because the
+        // connection is blocking and the server stops reading when its
+        // results are not consumed, which could deadlock large batches.
+        // the intermediate syncs do not end the explicit transaction
+        if(::PQenterPipelineMode(get()) != 1) {
+            return false;
+        }
+        bool sent{_send_command("BEGIN")};
+        bool done{true};
+        int in_flight{1};
+        batch.for_each_row(
+          [&](const char* stmt, int param_count, const char* const* values) {
+              if(not(sent and done)) {
+                  return;
+              }
+              sent = ::PQsendQueryPrepared(
+                       get(),
+                       stmt,
+                       param_count,
+                       values,
+                       nullptr,
+                       nullptr,
+                       0) == 1;
+              if(sent and (++in_flight >= max_in_flight)) {
+                  done = _sync_pipeline() and done;
+                  in_flight = 0;
+              }
+          });
+        sent = sent and _send_command("COMMIT");
+        done = _sync_pipeline() and done;
+        ::PQexitPipelineMode(get());
+        return sent and done;
+#else
+        // without pipelining support at least execute the batch
+        // as a single transaction
+        if(not execute("BEGIN").is_command_ok()) {
+            return false;
+        }
+        bool done{true};
+        batch.for_each_row(
+          [&](const char* stmt, int param_count, const char* const* values) {
+              if(done) {
+                  const result res{::PQexecPrepared(
+                    get(), stmt, param_count, values, nullptr, nullptr, 0)};
+                  done = res.is_ok() or res.is_command_ok();
+              }
+          });
+        return execute(done ? "COMMIT" : "ROLLBACK").is_command_ok() and done;
+#endif
+    }
+
     auto execute(string_view sql) const noexcept -> result {
         if(is_ok()) {
             return {::PQexec(get(), c_str(sql))};
@@ -104,6 +260,38 @@ public:
     }
 
 private:
+#ifdef LIBPQ_HAS_PIPELINING
+    auto _send_command(const char* sql) const noexcept -> bool {
+        return ::PQsendQueryParams(
+                 get(), sql, 0, nullptr, nullptr, nullptr, nullptr, 0) == 1;
+    }
+
+    // sends a sync and reads the results of the statements sent before it
+    auto _sync_pipeline() const noexcept -> bool {
+        if(::PQpipelineSync(get()) != 1) {
+            return false;
+        }
+        bool done{true};
+        while(true) {
+            if(PGresult* res{::PQgetResult(get())}) {
+                const auto status{::PQresultStatus(res)};
+                ::PQclear(res);
+                if(status == PGRES_PIPELINE_SYNC) {
+                    break;
+                }
+                if(
+                  (status == PGRES_FATAL_ERROR) or
+                  (status == PGRES_PIPELINE_ABORTED)) {
+                    done = false;
+                }
+            } else if(not is_ok()) {
+                return false;
+            }
+        }
+        return done;
+    }
+#endif
+
     template <std::size_t N, std::size_t... I>
     auto _exec_p(
       string_view sql,
@@ -148,14 +336,73 @@ private:
     }
 };
 //------------------------------------------------------------------------------
+struct prepared_statement {
+    const char* name;
+    string_view sql;
+    int param_count;
+};
+//------------------------------------------------------------------------------
 } // namespace pq
 //------------------------------------------------------------------------------
+// prepared statements used in batching mode
+//------------------------------------------------------------------------------
+// the entry arguments are batched together with the entry itself, so they
+// refer to the last entry added in the current session
+#define EAGINE_LIBPQ_CURRENT_ENTRY_ID \
+    "currval(pg_get_serial_sequence('eagilog.entry', 'entry_id'))"
+static constexpr const pq::prepared_statement pq_add_entry{
+  "eagilog_add_entry",
+  "SELECT eagilog.add_entry("
+  "	$1::INTEGER, $2, $3::BIGINT, $4, $5, $6, $7::INTERVAL)",
+  7};
+static constexpr const pq::prepared_statement pq_add_arg_boolean{
+  "eagilog_add_arg_boolean",
+  "SELECT eagilog.add_entry_arg_boolean(" EAGINE_LIBPQ_CURRENT_ENTRY_ID
+  ", $1, $2, $3::BOOLEAN)",
+  3};
+static constexpr const pq::prepared_statement pq_add_arg_integer{
+  "eagilog_add_arg_integer",
+  "SELECT eagilog.add_entry_arg_integer(" EAGINE_LIBPQ_CURRENT_ENTRY_ID
+  ", $1, $2, $3::NUMERIC)",
+  3};
+static constexpr const pq::prepared_statement pq_add_arg_float{
+  "eagilog_add_arg_float",
+  "SELECT eagilog.add_entry_arg_float(" EAGINE_LIBPQ_CURRENT_ENTRY_ID
+  ", $1, $2, $3::DOUBLE PRECISION)",
+  3};
+static constexpr const pq::prepared_statement pq_add_arg_duration{
+  "eagilog_add_arg_duration",
+  "SELECT eagilog.add_entry_arg_duration(" EAGINE_LIBPQ_CURRENT_ENTRY_ID
+  ", $1, $2, $3::INTERVAL)",
+  3};
+static constexpr const pq::prepared_statement pq_add_arg_string{
+  "eagilog_add_arg_string",
+  "SELECT eagilog.add_entry_arg_string(" EAGINE_LIBPQ_CURRENT_ENTRY_ID
+  ", $1, $2, $3)",
+  3};
+static constexpr const pq::prepared_statement pq_add_arg_min_max{
+  "eagilog_add_arg_min_max",
+  "SELECT eagilog.add_entry_arg_min_max(" EAGINE_LIBPQ_CURRENT_ENTRY_ID
+  ", $1, $2::DOUBLE PRECISION, $3::DOUBLE PRECISION)",
+  3};
+static constexpr const pq::prepared_statement pq_create_object{
+  "eagilog_create_object",
+  "SELECT eagilog.create_object("
+  "	$1, $2, $3, $4, $5, $6::INTERVAL, $7::BOOLEAN)",
+  7};
+static constexpr const pq::prepared_statement pq_destroy_object{
+  "eagilog_destroy_object",
+  "SELECT eagilog.destroy_object($1, $2, $3, $4::INTERVAL)",
+  4};
+#undef EAGINE_LIBPQ_CURRENT_ENTRY_ID
+//------------------------------------------------------------------------------
 // sink factory
 //------------------------------------------------------------------------------
 class libpq_stream_sink;
 class libpq_stream_sink_factory final
   : public std::enable_shared_from_this<libpq_stream_sink_factory>
-  , public stream_sink_factory {
+  , public stream_sink_factory
+  , public main_ctx_object {
 public:
     libpq_stream_sink_factory(main_ctx&, string_view conn_params) noexcept;
 
@@ -216,6 +463,32 @@ private:
       std::chrono::seconds{1},
       std::chrono::minutes{1}};
 
+    auto _is_batching() const noexcept -> bool;
+    auto _prepare_statements() noexcept -> bool;
+    auto _flush_batch() noexcept -> bool;
+    auto _sync_batch() noexcept -> bool;
+    void _batch_arg(const message_info::arg_info&) noexcept;
+    void _report_batch_stats() noexcept;
+
+    template <typename... Args>
+    void _execute(const pq::prepared_statement&, const Args&...) noexcept;
+
+    pq::statement_batch _batch;
+    span_size_t _batch_size{0};
+    timeout _should_flush{std::chrono::milliseconds{500}};
+    timeout _should_report{std::chrono::seconds{60}};
+    bool _prepared{false};
+
+    struct _batch_stats {
+        std::chrono::steady_clock::time_point since{
+          std::chrono::steady_clock::now()};
+        std::chrono::steady_clock::duration latency_sum{};
+        std::chrono::steady_clock::duration latency_max{};
+        span_size_t flushes{0};
+        span_size_t rows{0};
+        span_size_t dropped{0};
+    } _stats;
+
     void _setup_special_args() noexcept;
     void _handle_special_arg(
       const span_size_t stream_id,
@@ -258,6 +531,7 @@ public:
     void consume(const active_state_info&) noexcept final;
     void consume(const message_info&) noexcept final;
     void consume(const interval_info&) noexcept final;
+    void consume(const chart_info&) noexcept final;
     void consume(const heartbeat_info&) noexcept final;
     void consume(const finish_info&) noexcept final;
 
@@ -357,6 +631,10 @@ void libpq_stream_sink::consume(const interval_info& info) noexcept {
     }
 }
 //------------------------------------------------------------------------------
+void libpq_stream_sink::consume(const chart_info&) noexcept {
+    // the database schema does not store chart samples
+}
+//------------------------------------------------------------------------------
 void libpq_stream_sink::consume(const heartbeat_info& info) noexcept {
     _dispatch(info);
 }
@@ -397,10 +675,155 @@ void libpq_stream_sink_factory::_setup_special_args() noexcept {
 }
 //------------------------------------------------------------------------------
 libpq_stream_sink_factory::libpq_stream_sink_factory(
-  main_ctx&,
+  main_ctx& ctx,
   string_view conn_params) noexcept
-  : _conn{pq::connection::connect(conn_params)} {
+  : main_ctx_object{"LibPQSink", ctx}
+  , _conn{pq::connection::connect(conn_params)} {
     _setup_special_args();
+    ctx.config().fetch("log_server.libpq.batch.size", _batch_size);
+    std::chrono::duration<float> max_age{};
+    if(ctx.config().fetch("log_server.libpq.batch.max_age", max_age)) {
+        _should_flush.set_duration(max_age);
+    }
+}
+//------------------------------------------------------------------------------
+auto libpq_stream_sink_factory::_is_batching() const noexcept -> bool {
+    return _batch_size > 0;
+}
+//------------------------------------------------------------------------------
+auto libpq_stream_sink_factory::_prepare_statements() noexcept -> bool {
+    // the statements may be partially prepared after a previous failure
+    _conn.execute("DEALLOCATE ALL");
+    for(const auto& stmt :
+        {pq_add_entry,
+         pq_add_arg_boolean,
+         pq_add_arg_integer,
+         pq_add_arg_float,
+         pq_add_arg_duration,
+         pq_add_arg_string,
+         pq_add_arg_min_max,
+         pq_create_object,
+         pq_destroy_object}) {
+        if(not _conn.prepare(stmt.name, stmt.sql, stmt.param_count)) {
+            return false;
+        }
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+auto libpq_stream_sink_factory::_flush_batch() noexcept -> bool {
+    if(_batch.empty()) {
+        return true;
+    }
+    if(not _prepared) {
+        _prepared = _prepare_statements();
+    }
+    if(_prepared) {
+        const auto start{std::chrono::steady_clock::now()};
+        if(_conn.execute(_batch)) {
+            const auto latency{std::chrono::steady_clock::now() - start};
+            _stats.latency_sum += latency;
+            _stats.latency_max = std::max(_stats.latency_max, latency);
+            ++_stats.flushes;
+            _stats.rows += _batch.row_count();
+            _batch.clear();
+            return true;
+        }
+    }
+    if(_conn.is_ok()) {
+        // the batch was rejected by the server, retrying would not help
+        _stats.dropped += _batch.row_count();
+        _batch.clear();
+        return true;
+    }
+    // keep the batch for after the reconnect, but limit its size
+    _prepared = false;
+    if(_batch.row_count() > _batch_size * 64) {
+        _stats.dropped += _batch.row_count();
+        _batch.clear();
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto libpq_stream_sink_factory::_sync_batch() noexcept -> bool {
+    // the non-batched statements must not overtake the batched ones
+    return not _is_batching() or _flush_batch();
+}
+//------------------------------------------------------------------------------
+template <typename... Args>
+void libpq_stream_sink_factory::_execute(
+  const pq::prepared_statement& stmt,
+  const Args&... args) noexcept {
+    if(_is_batching()) {
+        if(not _batch.add(stmt.name, args...)) {
+            ++_stats.dropped;
+        }
+    } else {
+        _conn.execute(stmt.sql, args...);
+    }
+}
+//------------------------------------------------------------------------------
+void libpq_stream_sink_factory::_batch_arg(
+  const message_info::arg_info& info) noexcept {
+    if(info.min and info.max) {
+        _execute(pq_add_arg_min_max, info.name, *info.min, *info.max);
+    }
+    if(
+      (info.tag.value() == id_v("duration")) or
+      std::holds_alternative<float_seconds>(info.value)) {
+        _execute(
+          pq_add_arg_duration,
+          info.name,
+          info.tag,
+          info.value_duration().or_default());
+    } else if(std::holds_alternative<float>(info.value)) {
+        _execute(
+          pq_add_arg_float,
+          info.name,
+          info.tag,
+          info.value_float().or_default());
+    } else if(std::holds_alternative<std::uint64_t>(info.value)) {
+        _execute(
+          pq_add_arg_integer,
+          info.name,
+          info.tag,
+          info.value_uint64().or_default());
+    } else if(std::holds_alternative<std::int64_t>(info.value)) {
+        _execute(
+          pq_add_arg_integer,
+          info.name,
+          info.tag,
+          info.value_int64().or_default());
+    } else if(std::holds_alternative<bool>(info.value)) {
+        _execute(
+          pq_add_arg_boolean,
+          info.name,
+          info.tag,
+          info.value_bool().or_false());
+    } else if(const auto val{info.value_string()}) {
+        if(not val->empty()) {
+            _execute(pq_add_arg_string, info.name, info.tag, *val);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void libpq_stream_sink_factory::_report_batch_stats() noexcept {
+    if((_stats.flushes > 0) or (_stats.dropped > 0)) {
+        const auto now{std::chrono::steady_clock::now()};
+        const auto period{
+          std::chrono::duration_cast<float_seconds>(now - _stats.since)};
+        log_stat("flushed ${rows} rows in ${flushes} batches")
+          .tag("pqBatchStt")
+          .arg("rows", _stats.rows)
+          .arg("flushes", _stats.flushes)
+          .arg("dropped", _stats.dropped)
+          .arg("rowsPerSec", float(_stats.rows) / period.count())
+          .arg(
+            "avgLatency",
+            _stats.latency_sum / std::max(_stats.flushes, span_size_t(1)))
+          .arg("maxLatency", _stats.latency_max);
+    }
+    _stats = {};
 }
 //------------------------------------------------------------------------------
 auto libpq_stream_sink_factory::make_stream() noexcept
@@ -414,6 +837,9 @@ auto libpq_stream_sink_factory::is_conn_ok() const noexcept -> bool {
 //------------------------------------------------------------------------------
 auto libpq_stream_sink_factory::get_stream_id() noexcept
   -> optionally_valid<stream_id_t> {
+    if(not _sync_batch()) {
+        return {};
+    }
     if(const auto res{_conn.execute("SELECT eagilog.start_stream()")}) {
         return res.get_value_as<stream_id_t>(0, 0);
     }
@@ -439,7 +865,8 @@ auto libpq_stream_sink_factory::consume(
 auto libpq_stream_sink_factory::consume(
   libpq_stream_sink& stream,
   const declare_state_info& info) noexcept -> bool {
-    return _conn
+    return _sync_batch() and
+           _conn
       .execute(
         "SELECT eagilog.declare_stream_state($1::INTEGER, $2, $3, $4, $5)",
         stream.id(),
@@ -453,7 +880,8 @@ auto libpq_stream_sink_factory::consume(
 auto libpq_stream_sink_factory::consume(
   libpq_stream_sink& stream,
   const active_state_info& info) noexcept -> bool {
-    return _conn
+    return _sync_batch() and
+           _conn
       .execute(
         "SELECT eagilog.make_stream_state_active($1::INTEGER, $2, $3)",
         stream.id(),
@@ -642,6 +1070,9 @@ auto libpq_stream_sink_factory::consume(
 void libpq_stream_sink_factory::set_stream_application_id(
   stream_id_t stream_id,
   identifier app_id) noexcept {
+    if(not _sync_batch()) {
+        return;
+    }
     _conn.execute(
       "SELECT eagilog.set_stream_application_id($1::INTEGER, $2)",
       stream_id,
@@ -695,9 +1126,8 @@ void libpq_stream_sink_factory::_handle_object_created(
         const auto parent_id{id_arg->value_string()};
         const auto parent_inst{inst_arg->value_uint64()};
         if(parent_id and parent_inst) {
-            _conn.execute(
-              "SELECT eagilog.create_object("
-              "	$1, $2, $3, $4, $5, $6::INTERVAL, $7::BOOLEAN)",
+            _execute(
+              pq_create_object,
               stream_id,
               msg.source,
               msg.instance,
@@ -712,8 +1142,8 @@ void libpq_stream_sink_factory::_handle_object_created(
 void libpq_stream_sink_factory::_handle_object_destroyed(
   const span_size_t stream_id,
   const message_info& msg) noexcept {
-    _conn.execute(
-      "SELECT eagilog.destroy_object($1, $2, $3, $4::INTERVAL)",
+    _execute(
+      pq_destroy_object,
       stream_id,
       msg.source,
       msg.instance,
@@ -743,6 +1173,48 @@ void libpq_stream_sink_factory::_handle_lifetime_msg(
 auto libpq_stream_sink_factory::consume(
   libpq_stream_sink& stream,
   const message_info& info) noexcept -> bool {
+    if(_is_batching()) {
+        if(find(_special_args, info.tag.value())) {
+            // messages with special arguments are rare, handle them directly
+            if(not _flush_batch()) {
+                return false;
+            }
+        } else {
+            if(_batch.empty()) {
+                _should_flush.reset();
+            }
+            const auto severity{enumerator_name(info.severity)};
+            if(info.tag) {
+                _batch.add(
+                  pq_add_entry.name,
+                  stream.id(),
+                  info.source,
+                  info.instance,
+                  severity,
+                  info.tag,
+                  info.format,
+                  info.offset);
+            } else {
+                _batch.add(
+                  pq_add_entry.name,
+                  stream.id(),
+                  info.source,
+                  info.instance,
+                  severity,
+                  nothing,
+                  info.format,
+                  info.offset);
+            }
+            for(const auto& arg : info.args) {
+                _batch_arg(arg);
+            }
+            _handle_lifetime_msg(stream.id(), info);
+            if(_batch.row_count() >= _batch_size) {
+                _flush_batch();
+            }
+            return true;
+        }
+    }
     if(const auto entry_id{get_entry_id(stream, info)}) {
         for(const auto& arg : info.args) {
             consume(stream, *entry_id, arg);
@@ -762,7 +1234,8 @@ auto libpq_stream_sink_factory::consume(
                  std::chrono::duration<float, std::milli>>(d)
           .count();
     }};
-    return _conn
+    return _sync_batch() and
+           _conn
       .execute(
         "SELECT eagilog.add_profile_interval("
         "	$1,"
@@ -787,7 +1260,8 @@ auto libpq_stream_sink_factory::consume(
 auto libpq_stream_sink_factory::consume(
   libpq_stream_sink& stream,
   const heartbeat_info& info) noexcept -> bool {
-    return _conn
+    return _sync_batch() and
+           _conn
       .execute(
         "SELECT eagilog.stream_heartbeat($1::INTEGER, $2::INTERVAL)",
         stream.id(),
@@ -798,7 +1272,8 @@ auto libpq_stream_sink_factory::consume(
 auto libpq_stream_sink_factory::consume(
   const libpq_stream_sink& stream,
   const finish_info& info) noexcept -> bool {
-    return _conn
+    return _sync_batch() and
+           _conn
       .execute(
         "SELECT eagilog.finish_stream($1::INTEGER, $2::BOOLEAN)",
         stream.id(),
@@ -810,12 +1285,23 @@ void libpq_stream_sink_factory::update() noexcept {
     if(not is_conn_ok()) {
         if(_should_reconnect.is_expired()) {
             if(_conn.reconnect()) {
+                _prepared = false;
                 _should_reconnect.rewind();
             } else {
                 _should_reconnect.extend();
             }
         }
     }
+    if(_is_batching()) {
+        if(_should_flush.is_expired()) {
+            _flush_batch();
+            _should_flush.reset();
+        }
+        if(_should_report.is_expired()) {
+            _report_batch_stats();
+            _should_report.reset();
+        }
+    }
 }
 //------------------------------------------------------------------------------
 #endif // EAGINE_USE_LIBPQ
@@ -0,0 +1,181 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module eagine.core.log_server;
+
+import std;
+import eagine.core;
+
+import :interfaces;
+
+namespace eagine::logs {
+//------------------------------------------------------------------------------
+auto sink_dispatch_active() noexcept -> bool& {
+    thread_local bool active{false};
+    return active;
+}
+//------------------------------------------------------------------------------
+// sink shard
+//------------------------------------------------------------------------------
+struct sink_shard {
+    sink_shard(shared_holder<stream_sink_factory> f) noexcept
+      : factory{std::move(f)} {}
+
+    std::mutex mutex;
+    shared_holder<stream_sink_factory> factory;
+};
+//------------------------------------------------------------------------------
+class sink_shard_lock {
+public:
+    sink_shard_lock(sink_shard& shard) noexcept
+      : _lock{shard.mutex} {
+        sink_dispatch_active() = true;
+    }
+
+    sink_shard_lock(sink_shard_lock&&) = delete;
+    sink_shard_lock(const sink_shard_lock&) = delete;
+    auto operator=(sink_shard_lock&&) = delete;
+    auto operator=(const sink_shard_lock&) = delete;
+
+    ~sink_shard_lock() noexcept {
+        sink_dispatch_active() = false;
+    }
+
+private:
+    const std::lock_guard<std::mutex> _lock;
+};
+//------------------------------------------------------------------------------
+// sharded sink
+//------------------------------------------------------------------------------
+class sharded_sink final : public stream_sink {
+public:
+    sharded_sink(
+      shared_holder<sink_shard> shard,
+      unique_holder<stream_sink> sink) noexcept
+      : _shard{std::move(shard)}
+      , _sink{std::move(sink)} {}
+
+    sharded_sink(sharded_sink&&) = delete;
+    sharded_sink(const sharded_sink&) = delete;
+    auto operator=(sharded_sink&&) = delete;
+    auto operator=(const sharded_sink&) = delete;
+
+    ~sharded_sink() noexcept final {
+        // the wrapped sink may access the shared factory when destroyed
+        const sink_shard_lock lock{*_shard};
+        _sink.reset();
+    }
+
+    void consume(const begin_info&) noexcept final;
+    void consume(const description_info&) noexcept final;
+    void consume(const declare_state_info&) noexcept final;
+    void consume(const active_state_info&) noexcept final;
+    void consume(const message_info&) noexcept final;
+    void consume(const interval_info&) noexcept final;
+    void consume(const chart_info&) noexcept final;
+    void consume(const heartbeat_info&) noexcept final;
+    void consume(const finish_info&) noexcept final;
+
+private:
+    void _consume(const auto& info) noexcept;
+
+    shared_holder<sink_shard> _shard;
+    unique_holder<stream_sink> _sink;
+};
+//------------------------------------------------------------------------------
+void sharded_sink::_consume(const auto& info) noexcept {
+    const sink_shard_lock lock{*_shard};
+    _sink->consume(info);
+}
+//------------------------------------------------------------------------------
+void sharded_sink::consume(const begin_info& info) noexcept {
+    _consume(info);
+}
+//------------------------------------------------------------------------------
+void sharded_sink::consume(const description_info& info) noexcept {
+    _consume(info);
+}
+//------------------------------------------------------------------------------
+void sharded_sink::consume(const declare_state_info& info) noexcept {
+    _consume(info);
+}
+//------------------------------------------------------------------------------
+void sharded_sink::consume(const active_state_info& info) noexcept {
+    _consume(info);
+}
+//------------------------------------------------------------------------------
+void sharded_sink::consume(const message_info& info) noexcept {
+    _consume(info);
+}
+//------------------------------------------------------------------------------
+void sharded_sink::consume(const interval_info& info) noexcept {
+    _consume(info);
+}
+//------------------------------------------------------------------------------
+void sharded_sink::consume(const chart_info& info) noexcept {
+    _consume(info);
+}
+//------------------------------------------------------------------------------
+void sharded_sink::consume(const heartbeat_info& info) noexcept {
+    _consume(info);
+}
+//------------------------------------------------------------------------------
+void sharded_sink::consume(const finish_info& info) noexcept {
+    _consume(info);
+}
+//------------------------------------------------------------------------------
+// sharded sink factory
+//------------------------------------------------------------------------------
+class sharded_sink_factory final : public stream_sink_factory {
+public:
+    sharded_sink_factory(
+      std::vector<shared_holder<stream_sink_factory>> factories) noexcept;
+
+    auto make_stream() noexcept -> unique_holder<stream_sink> final;
+    void update() noexcept final;
+
+private:
+    std::vector<shared_holder<sink_shard>> _shards;
+    std::atomic<std::size_t> _next_shard{0U};
+};
+//------------------------------------------------------------------------------
+sharded_sink_factory::sharded_sink_factory(
+  std::vector<shared_holder<stream_sink_factory>> factories) noexcept {
+    _shards.reserve(factories.size());
+    for(auto& factory : factories) {
+        _shards.emplace_back(hold<sink_shard>, std::move(factory));
+    }
+}
+//------------------------------------------------------------------------------
+auto sharded_sink_factory::make_stream() noexcept
+  -> unique_holder<stream_sink> {
+    if(_shards.empty()) [[unlikely]] {
+        return {};
+    }
+    auto& shard{_shards[_next_shard.fetch_add(1U) % _shards.size()]};
+    const sink_shard_lock lock{*shard};
+    if(auto stream{shard->factory->make_stream()}) {
+        return {hold<sharded_sink>, shard, std::move(stream)};
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
+void sharded_sink_factory::update() noexcept {
+    for(auto& shard : _shards) {
+        const sink_shard_lock lock{*shard};
+        shard->factory->update();
+    }
+}
+//------------------------------------------------------------------------------
+auto make_sharded_sink_factory(
+  main_ctx&,
+  std::vector<shared_holder<stream_sink_factory>> factories) noexcept
+  -> shared_holder<stream_sink_factory> {
+    return {hold<sharded_sink_factory>, std::move(factories)};
+}
+//------------------------------------------------------------------------------
+} // namespace eagine::logs
@@ -273,6 +273,7 @@ public:
     void consume(const active_state_info&) noexcept final;
     void consume(const message_info&) noexcept final;
     void consume(const interval_info&) noexcept final;
+    void consume(const chart_info&) noexcept final;
     void consume(const heartbeat_info&) noexcept final;
     void consume(const finish_info&) noexcept final;
 
@@ -644,6 +645,12 @@ void text_tree_sink_factory::consume(
     _write(format_reltime_ns(info.min_duration()))._write("\n");
     _conn_I(s)._write("  ├─╼ avg: ");
     _write(format_reltime_ns(info.avg_duration()))._write("\n");
+    _conn_I(s)._write("  ├─╼ p50: ");
+    _write(format_reltime_ns(info.p50_duration()))._write("\n");
+    _conn_I(s)._write("  ├─╼ p90: ");
+    _write(format_reltime_ns(info.p90_duration()))._write("\n");
+    _conn_I(s)._write("  ├─╼ p99: ");
+    _write(format_reltime_ns(info.p99_duration()))._write("\n");
     _conn_I(s)._write("  ╰─╼ max: ");
     _write(format_reltime_ns(info.max_duration()))._write("\n")._flush();
 }
@@ -655,6 +662,10 @@ void text_tree_sink::consume(const interval_info& info) noexcept {
     }
 }
 //------------------------------------------------------------------------------
+void text_tree_sink::consume(const chart_info&) noexcept {
+    // chart samples are not shown in the text output
+}
+//------------------------------------------------------------------------------
 void text_tree_sink_factory::consume(
   const text_tree_sink& s,
   const heartbeat_info& info) noexcept {
@@ -20,11 +20,45 @@ public:
     void translate(const message_info&, message_info::arg_info&) noexcept;
 };
 //------------------------------------------------------------------------------
+// log timestamp parser
+//------------------------------------------------------------------------------
+class log_timestamp_parser {
+public:
+    auto parse(const string_view) const
+      -> optionally_valid<std::chrono::sys_time<std::chrono::microseconds>>;
+
+private:
+    const std::regex _ts_re{
+      R"(([0-9]{1,5}-[0-9]{2}-[0-9]{2} [0-9]{2}:[0-9]{2}:[0-9]{2})(\.[0-9]+))"};
+};
+//------------------------------------------------------------------------------
 auto format_reltime_ns(std::chrono::nanoseconds) noexcept -> std::string;
 auto format_reltime(std::chrono::microseconds) noexcept -> std::string;
 auto format_reltime_s(float_seconds) noexcept -> std::string;
 auto format_instance(std::uint64_t, std::string&) noexcept -> std::string&;
 //------------------------------------------------------------------------------
+// SQL statement parameters
+//------------------------------------------------------------------------------
+export auto append_sql_param(string_view, std::string&) -> std::string&;
+export auto append_sql_param(identifier, std::string&) -> std::string&;
+export auto append_sql_param(bool, std::string&) -> std::string&;
+export auto append_sql_param(float_seconds, std::string&) -> std::string&;
+
+export auto append_sql_param(const std::integral auto arg, std::string& dst)
+  -> std::string& {
+    std::format_to(std::back_inserter(dst), "{}", arg);
+    return dst;
+}
+
+// PostgreSQL does not accept the exponent notation in all contexts
+// (for example in INTERVAL literals), so the fixed notation is used
+export auto append_sql_param(
+  const std::floating_point auto arg,
+  std::string& dst) -> std::string& {
+    std::format_to(std::back_inserter(dst), "{:f}", arg);
+    return dst;
+}
+//------------------------------------------------------------------------------
 // message formatter
 //------------------------------------------------------------------------------
 class message_formatter {
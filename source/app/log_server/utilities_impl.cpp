@@ -18,67 +18,64 @@ void arg_value_translator::translate(
   const message_info&,
   message_info::arg_info& arg) noexcept {
     if(arg.tag.matches("DbgOutSrce")) {
-        using std::operator""s;
         switch(arg.value_uint64().or_default()) {
             case 0x8246:
-                arg.value = "API"s;
+                arg.value = string_view{"API"};
                 break;
             case 0x8247:
-                arg.value = "window system"s;
+                arg.value = string_view{"window system"};
                 break;
             case 0x8248:
-                arg.value = "shader compiler"s;
+                arg.value = string_view{"shader compiler"};
                 break;
             case 0x8249:
-                arg.value = "third party"s;
+                arg.value = string_view{"third party"};
                 break;
             case 0x824A:
-                arg.value = "application"s;
+                arg.value = string_view{"application"};
             case 0x824B:
                 break;
-                arg.value = "other"s;
+                arg.value = string_view{"other"};
                 break;
             default:
                 break;
         }
     } else if(arg.tag.matches("DbgOutType")) {
-        using std::operator""s;
         switch(arg.value_uint64().or_default()) {
             case 0x824C:
-                arg.value = "error"s;
+                arg.value = string_view{"error"};
                 break;
             case 0x824D:
-                arg.value = "deprecated behavior"s;
+                arg.value = string_view{"deprecated behavior"};
                 break;
             case 0x824E:
-                arg.value = "undefined  behavior"s;
+                arg.value = string_view{"undefined  behavior"};
                 break;
             case 0x824F:
-                arg.value = "portability"s;
+                arg.value = string_view{"portability"};
                 break;
             case 0x8250:
-                arg.value = "performance"s;
+                arg.value = string_view{"performance"};
                 break;
             case 0x8251:
-                arg.value = "other"s;
+                arg.value = string_view{"other"};
                 break;
             default:
                 break;
         }
     } else if(arg.tag.matches("DbgOutSvrt")) {
-        using std::operator""s;
         switch(arg.value_uint64().or_default()) {
             case 0x9146:
-                arg.value = "high"s;
+                arg.value = string_view{"high"};
                 break;
             case 0x9147:
-                arg.value = "medium"s;
+                arg.value = string_view{"medium"};
                 break;
             case 0x9148:
-                arg.value = "low"s;
+                arg.value = string_view{"low"};
                 break;
             case 0x826B:
-                arg.value = "notification"s;
+                arg.value = string_view{"notification"};
                 break;
             default:
                 break;
@@ -86,6 +83,29 @@ void arg_value_translator::translate(
     }
 }
 //------------------------------------------------------------------------------
+// log timestamp parser
+//------------------------------------------------------------------------------
+auto log_timestamp_parser::parse(const string_view str) const
+  -> optionally_valid<std::chrono::sys_time<std::chrono::microseconds>> {
+    // TODO: replace this with std::chrono::from_stream/parse when possible
+    const auto ts_str{to_string(str)};
+    std::smatch ts_match{};
+    if(std::regex_match(ts_str, ts_match, _ts_re)) {
+        std::stringstream src{ts_str};
+        std::tm temp{};
+        if((src >> std::get_time(&temp, "%Y-%m-%d %T")).good()) {
+            if(const auto ts{::timegm(&temp)}; ts > 0) {
+                return {
+                  std::chrono::system_clock::from_time_t(ts) +
+                  std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::duration<float>(
+                      std::strtof(std::string(ts_match[2]).c_str(), nullptr)))};
+            }
+        }
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
 // format reltime
 //------------------------------------------------------------------------------
 auto format_reltime_ns(std::chrono::nanoseconds t) noexcept -> std::string {
@@ -178,7 +198,10 @@ auto format_default(const message_info::arg_info& i) -> std::string {
     if(const auto val{get_if<identifier>(i.value)}; val.has_value()) {
         return val->name().str();
     }
-    return get_if<std::string>(i.value).value_or("-");
+    if(const auto val{get_if<string_view>(i.value)}) {
+        return to_string(*val);
+    }
+    return "-";
 }
 //------------------------------------------------------------------------------
 auto format_duration(const message_info::arg_info& i, bool) noexcept
@@ -358,6 +381,25 @@ auto message_formatter::format(const message_info& info) noexcept
       result, info.format, {construct_from, translate});
 }
 //------------------------------------------------------------------------------
+// SQL statement parameters
+//------------------------------------------------------------------------------
+auto append_sql_param(string_view arg, std::string& dst) -> std::string& {
+    return append_to(arg, dst);
+}
+//------------------------------------------------------------------------------
+auto append_sql_param(identifier arg, std::string& dst) -> std::string& {
+    return append_sql_param(string_view{arg.name()}, dst);
+}
+//------------------------------------------------------------------------------
+auto append_sql_param(bool arg, std::string& dst) -> std::string& {
+    return append_sql_param(
+      arg ? string_view{"TRUE"} : string_view{"FALSE"}, dst);
+}
+//------------------------------------------------------------------------------
+auto append_sql_param(float_seconds arg, std::string& dst) -> std::string& {
+    return append_sql_param(arg.count(), dst);
+}
+//------------------------------------------------------------------------------
 // string padded to length
 //------------------------------------------------------------------------------
 auto padded_to(std::size_t l, std::string_view s) noexcept -> std::string {
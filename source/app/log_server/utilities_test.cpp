@@ -0,0 +1,93 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin.hpp>
+import std;
+import eagine.core;
+import eagine.core.log_server;
+//------------------------------------------------------------------------------
+void sql_param_text(auto& s) {
+    eagitest::case_ test{s, 1, "text"};
+    using eagine::logs::append_sql_param;
+
+    std::string dst;
+    test.check_equal(
+      append_sql_param(eagine::string_view{"lorem"}, dst),
+      std::string{"lorem"},
+      "string");
+    dst.clear();
+    test.check_equal(
+      append_sql_param(eagine::identifier{"ipsum"}, dst),
+      std::string{"ipsum"},
+      "identifier");
+    dst.clear();
+    test.check_equal(append_sql_param(true, dst), std::string{"TRUE"}, "true");
+    dst.clear();
+    test.check_equal(
+      append_sql_param(false, dst), std::string{"FALSE"}, "false");
+}
+//------------------------------------------------------------------------------
+void sql_param_integer(auto& s) {
+    eagitest::case_ test{s, 2, "integer"};
+    using eagine::logs::append_sql_param;
+
+    std::string dst;
+    test.check_equal(
+      append_sql_param(std::int64_t(-1234), dst),
+      std::string{"-1234"},
+      "signed");
+    dst.clear();
+    test.check_equal(
+      append_sql_param(std::uint64_t(5678), dst),
+      std::string{"5678"},
+      "unsigned");
+}
+//------------------------------------------------------------------------------
+void sql_param_float(auto& s) {
+    eagitest::case_ test{s, 3, "float"};
+    using eagine::logs::append_sql_param;
+
+    std::string dst;
+    test.check_equal(
+      append_sql_param(1.5F, dst), std::string{"1.500000"}, "1.5");
+    dst.clear();
+    test.check_equal(
+      append_sql_param(1.2e-5F, dst), std::string{"0.000012"}, "small");
+    dst.clear();
+    test.check_equal(
+      append_sql_param(2.5e7F, dst), std::string{"25000000.000000"}, "big");
+}
+//------------------------------------------------------------------------------
+void sql_param_duration(auto& s) {
+    eagitest::case_ test{s, 4, "duration"};
+    using eagine::logs::append_sql_param;
+
+    // INTERVAL parameters must not be in the exponent notation
+    std::string dst;
+    test.check_equal(
+      append_sql_param(eagine::float_seconds{1.2e-5F}, dst),
+      std::string{"0.000012"},
+      "small");
+    dst.clear();
+    test.check_equal(
+      append_sql_param(eagine::float_seconds{3.25F}, dst),
+      std::string{"3.250000"},
+      "seconds");
+    test.check(dst.find_first_of("eE") == std::string::npos, "no exponent");
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagitest::suite test{argc, argv, "utilities", 4};
+    test.once(sql_param_text);
+    test.once(sql_param_integer);
+    test.once(sql_param_float);
+    test.once(sql_param_duration);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end.hpp>
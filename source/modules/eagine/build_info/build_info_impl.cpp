@@ -386,19 +386,49 @@ auto version_info::version_at_least(int major, int minor, int patch, int commit)
     return indeterminate;
 }
 //------------------------------------------------------------------------------
+// Parses dot-separated decimal numbers spanning the whole string.
+// Optionally the last number can also be separated by a dash.
+static auto parse_version_numbers(
+  const std::string_view str,
+  std::span<int> numbers,
+  bool dash_before_last) noexcept -> bool {
+    const char* pos{str.data()};
+    const char* const end{pos + str.size()};
+    for(std::size_t i = 0; i < numbers.size(); ++i) {
+        if(i > 0) {
+            if(pos == end) {
+                return false;
+            }
+            const bool dash{dash_before_last and (i + 1 == numbers.size())};
+            if((*pos != '.') and not(dash and (*pos == '-'))) {
+                return false;
+            }
+            ++pos;
+        }
+        if((pos == end) or (*pos < '0') or (*pos > '9')) {
+            return false;
+        }
+        const auto [next, error]{std::from_chars(pos, end, numbers[i])};
+        if(error != std::errc{}) {
+            return false;
+        }
+        pos = next;
+    }
+    return pos == end;
+}
+//------------------------------------------------------------------------------
 auto parse_version_string(
   const string_view str,
   int& major,
   int& minor,
   int& patch,
   int& commit) noexcept -> bool {
-    static const std::regex re{R"(([0-9]+)\.([0-9]+)\.([0-9]+)[.-]([0-9]+))"};
-    std::match_results<string_view::iterator> match;
-    if(std::regex_match(str.begin(), str.end(), match, re)) {
-        major = std::atoi(match[1].str().c_str());
-        minor = std::atoi(match[2].str().c_str());
-        patch = std::atoi(match[3].str().c_str());
-        commit = std::atoi(match[4].str().c_str());
+    std::array<int, 4> numbers{};
+    if(parse_version_numbers(str, numbers, true)) {
+        major = numbers[0];
+        minor = numbers[1];
+        patch = numbers[2];
+        commit = numbers[3];
         return true;
     }
     return false;
@@ -409,12 +439,11 @@ auto parse_version_string(
   int& major,
   int& minor,
   int& patch) noexcept -> bool {
-    static const std::regex re{R"(([0-9]+)\.([0-9]+)\.([0-9]+))"};
-    std::match_results<string_view::iterator> match;
-    if(std::regex_match(str.begin(), str.end(), match, re)) {
-        major = std::atoi(match[1].str().c_str());
-        minor = std::atoi(match[2].str().c_str());
-        patch = std::atoi(match[3].str().c_str());
+    std::array<int, 3> numbers{};
+    if(parse_version_numbers(str, numbers, false)) {
+        major = numbers[0];
+        minor = numbers[1];
+        patch = numbers[2];
         return true;
     }
     return false;
@@ -422,11 +451,10 @@ auto parse_version_string(
 //------------------------------------------------------------------------------
 auto parse_version_string(const string_view str, int& major, int& minor) noexcept
   -> bool {
-    static const std::regex re{R"(([0-9]+)\.([0-9]+))"};
-    std::match_results<string_view::iterator> match;
-    if(std::regex_match(str.begin(), str.end(), match, re)) {
-        major = std::atoi(match[1].str().c_str());
-        minor = std::atoi(match[2].str().c_str());
+    std::array<int, 2> numbers{};
+    if(parse_version_numbers(str, numbers, false)) {
+        major = numbers[0];
+        minor = numbers[1];
         return true;
     }
     return false;
@@ -15,6 +15,7 @@ export import :chunk_list;
 export import :object_pool;
 export import :flat_set;
 export import :flat_map;
+export import :eytzinger_map;
 export import :trie;
 export import :iterator;
 export import :wrapping;
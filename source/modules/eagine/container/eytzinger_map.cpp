@@ -0,0 +1,349 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module;
+
+#include <cassert>
+
+export module eagine.core.container:eytzinger_map;
+
+import std;
+import eagine.core.types;
+import :flat_map;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+/// @brief Read-optimized associative container with keys in Eytzinger order.
+/// @ingroup container
+/// @see flat_map
+///
+/// The keys are stored in a separate array in the breadth-first order of
+/// an implicit balanced binary search tree, so the first levels visited by
+/// every lookup share a few cache lines and the search loop is branchless.
+/// Small maps with trivial keys are searched with a linear scan that can be
+/// vectorized by the compiler. The values are stored in a parallel array.
+/// Modifications rebuild the whole layout, so this container is intended
+/// for maps that are built once and then looked up frequently.
+export template <typename Key, typename Val, typename Cmp = std::less<Key>>
+class eytzinger_map {
+public:
+    /// @brief The key type.
+    using key_type = Key;
+
+    /// @brief The mapped value type.
+    using mapped_type = Val;
+
+    /// @brief The key/value pair type.
+    using value_type = std::pair<Key, Val>;
+
+    /// @brief Key comparator type.
+    using key_compare = Cmp;
+
+    /// @brief Size type.
+    using size_type = span_size_t;
+
+    /// @brief Maximum size of maps searched by linear scan.
+    static constexpr const std::size_t linear_search_limit{
+      (std::is_trivially_copyable_v<Key> and sizeof(Key) <= 8U) ? 16U : 0U};
+
+    /// @brief Default constructor.
+    eytzinger_map() noexcept = default;
+
+    /// @brief Construction from an initializer list of key/value pairs.
+    /// @note If keys are repeated then the first occurrence is kept.
+    eytzinger_map(std::initializer_list<value_type> il) {
+        assign(il);
+    }
+
+    /// @brief Construction from a vector of key/value pairs.
+    /// @note If keys are repeated then the first occurrence is kept.
+    eytzinger_map(std::vector<value_type> v) {
+        assign(std::move(v));
+    }
+
+    /// @brief Construction from a flat_map.
+    template <typename Container>
+    eytzinger_map(const flat_map<Key, Val, Cmp, Container>& m) {
+        assign(m);
+    }
+
+    /// @brief Replaces the elements with keys/values from an initializer list.
+    void assign(std::initializer_list<value_type> il) {
+        assign(std::vector<value_type>(il.begin(), il.end()));
+    }
+
+    /// @brief Replaces the elements with keys/values from a vector.
+    void assign(std::vector<value_type> v) {
+        std::stable_sort(v.begin(), v.end(), _value_comp());
+        v.erase(
+          std::unique(
+            v.begin(),
+            v.end(),
+            [this](const auto& l, const auto& r) {
+                return _equal(l.first, r.first);
+            }),
+          v.end());
+        _build(std::move(v));
+    }
+
+    /// @brief Replaces the elements with keys/values from a flat_map.
+    template <typename Container>
+    void assign(const flat_map<Key, Val, Cmp, Container>& m) {
+        _build(std::vector<value_type>(m.begin(), m.end()));
+    }
+
+    /// @brief Indicates if this map is empty.
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return _values.empty();
+    }
+
+    /// @brief Returns the number of elements in this map.
+    [[nodiscard]] auto size() const noexcept -> size_type {
+        return span_size(_values.size());
+    }
+
+    /// @brief Clears all elements from this map.
+    void clear() noexcept {
+        _keys.clear();
+        _values.clear();
+    }
+
+    /// @brief Returns a reference to the key comparator object.
+    [[nodiscard]] auto key_comp() const noexcept -> const Cmp& {
+        return _cmp;
+    }
+
+    /// @brief Returns a reference to the value stored under the specified key.
+    template <typename K>
+    [[nodiscard]] auto find(const K& key) noexcept -> optional_reference<Val> {
+        if(const auto k{_find(key)}) {
+            return {_values[k - 1U]};
+        }
+        return {nothing};
+    }
+
+    /// @brief Returns a reference to the value stored under the specified key.
+    template <typename K>
+    [[nodiscard]] auto find(const K& key) const noexcept
+      -> optional_reference<const Val> {
+        if(const auto k{_find(key)}) {
+            return {_values[k - 1U]};
+        }
+        return {nothing};
+    }
+
+    /// @brief Indicates if this map contains the specified key.
+    template <typename K>
+    [[nodiscard]] auto contains(const K& key) const noexcept -> bool {
+        return _find(key) != 0U;
+    }
+
+    /// @brief Returns the value stored under the specified key.
+    /// @throws std::out_of_range if the key is not found.
+    template <typename K>
+    [[nodiscard]] auto at(const K& key) -> Val& {
+        return _values[_at(key) - 1U];
+    }
+
+    /// @brief Returns the value stored under the specified key.
+    /// @throws std::out_of_range if the key is not found.
+    template <typename K>
+    [[nodiscard]] auto at(const K& key) const -> const Val& {
+        return _values[_at(key) - 1U];
+    }
+
+    /// @brief Returns the value stored under the specified key.
+    /// @pre contains(key)
+    template <typename K>
+    [[nodiscard]] auto get(const K& key) noexcept -> Val& {
+        const auto k{_find(key)};
+        assert(k != 0U);
+        return _values[k - 1U];
+    }
+
+    /// @brief Returns the value stored under the specified key.
+    /// @pre contains(key)
+    template <typename K>
+    [[nodiscard]] auto get(const K& key) const noexcept -> const Val& {
+        const auto k{_find(key)};
+        assert(k != 0U);
+        return _values[k - 1U];
+    }
+
+    /// @brief Inserts a new or replaces the existing value under a key.
+    /// @note This rebuilds the whole layout.
+    void insert_or_assign(const Key& key, Val value) {
+        auto elements{_release_elements()};
+        const auto pos{std::lower_bound(
+          elements.begin(),
+          elements.end(),
+          key,
+          [this](const auto& e, const auto& k) { return _cmp(e.first, k); })};
+        if((pos != elements.end()) and _equal(pos->first, key)) {
+            pos->second = std::move(value);
+        } else {
+            elements.emplace(pos, key, std::move(value));
+        }
+        _build(std::move(elements));
+    }
+
+    /// @brief Erases the element stored under the specified key.
+    /// @note This rebuilds the whole layout if the key is found.
+    template <typename K>
+    auto erase(const K& key) -> size_type {
+        if(not contains(key)) {
+            return 0;
+        }
+        auto elements{_release_elements()};
+        std::erase_if(
+          elements, [&](const auto& e) { return _equal(e.first, key); });
+        _build(std::move(elements));
+        return 1;
+    }
+
+    /// @brief Calls the specified function on all key/value pairs in key order.
+    template <typename Function>
+    void for_each(Function func) const {
+        for(auto k{_first()}; k != 0U; k = _next(k)) {
+            func(_keys[k], _values[k - 1U]);
+        }
+    }
+
+    /// @brief Calls the specified function on all key/value pairs in key order.
+    template <typename Function>
+    void for_each(Function func) {
+        for(auto k{_first()}; k != 0U; k = _next(k)) {
+            func(std::as_const(_keys[k]), _values[k - 1U]);
+        }
+    }
+
+private:
+    // Positions are one-based, position k has children 2k and 2k+1.
+    // _keys[0] is an unused copy of a key making the arithmetic simpler,
+    // _values[k-1] is the value for _keys[k].
+
+    auto _value_comp() const noexcept {
+        return [this](const value_type& l, const value_type& r) {
+            return _cmp(l.first, r.first);
+        };
+    }
+
+    template <typename L, typename R>
+    auto _equal(const L& l, const R& r) const noexcept -> bool {
+        return not _cmp(l, r) and not _cmp(r, l);
+    }
+
+    auto _first() const noexcept -> std::size_t {
+        return _values.empty() ? 0U : _first_of(_values.size());
+    }
+
+    auto _next(std::size_t k) const noexcept -> std::size_t {
+        return _next_of(k, _values.size());
+    }
+
+    template <typename K>
+    auto _scan(const K& key) const noexcept -> std::size_t {
+        // no early exit, so that this can be vectorized
+        std::size_t result{0U};
+        for(std::size_t k = 1U; k <= _values.size(); ++k) {
+            result = _equal(_keys[k], key) ? k : result;
+        }
+        return result;
+    }
+
+    template <typename K>
+    auto _lower_bound(const K& key) const noexcept -> std::size_t {
+        const auto n{_values.size()};
+        std::size_t k{1U};
+        while(k <= n) {
+            k = 2U * k + std::size_t(_cmp(_keys[k], key));
+        }
+        // undo the right turns taken after the last left turn
+        return k >> (std::countr_one(k) + 1);
+    }
+
+    template <typename K>
+    auto _find(const K& key) const noexcept -> std::size_t {
+        if(_values.size() <= linear_search_limit) {
+            return _scan(key);
+        }
+        const auto k{_lower_bound(key)};
+        if((k != 0U) and not _cmp(key, _keys[k])) {
+            return k;
+        }
+        return 0U;
+    }
+
+    template <typename K>
+    auto _at(const K& key) const -> std::size_t {
+        const auto k{_find(key)};
+        if(k == 0U) [[unlikely]] {
+            throw std::out_of_range("Invalid eytzinger map key");
+        }
+        return k;
+    }
+
+    auto _release_elements() -> std::vector<value_type> {
+        std::vector<value_type> result;
+        result.reserve(_values.size());
+        for(auto k{_first()}; k != 0U; k = _next(k)) {
+            result.emplace_back(
+              std::move(_keys[k]), std::move(_values[k - 1U]));
+        }
+        clear();
+        return result;
+    }
+
+    void _build(std::vector<value_type> sorted) {
+        clear();
+        const auto n{sorted.size()};
+        if(n == 0U) {
+            return;
+        }
+        std::vector<std::size_t> order(n + 1U);
+        std::size_t i{0U};
+        _keys.resize(n + 1U, sorted.front().first);
+        for(auto k{_first_of(n)}; k != 0U; k = _next_of(k, n)) {
+            order[k] = i++;
+        }
+        _values.reserve(n);
+        for(std::size_t k = 1U; k <= n; ++k) {
+            auto& element{sorted[order[k]]};
+            _keys[k] = std::move(element.first);
+            _values.push_back(std::move(element.second));
+        }
+    }
+
+    static auto _first_of(std::size_t n) noexcept -> std::size_t {
+        std::size_t k{1U};
+        while(2U * k <= n) {
+            k *= 2U;
+        }
+        return k;
+    }
+
+    static auto _next_of(std::size_t k, std::size_t n) noexcept
+      -> std::size_t {
+        if(2U * k + 1U <= n) {
+            k = 2U * k + 1U;
+            while(2U * k <= n) {
+                k *= 2U;
+            }
+            return k;
+        }
+        while((k & 1U) != 0U) {
+            k >>= 1U;
+        }
+        return k >> 1U;
+    }
+
+    std::vector<Key> _keys;
+    std::vector<Val> _values;
+    [[no_unique_address]] Cmp _cmp{};
+};
+//------------------------------------------------------------------------------
+} // namespace eagine
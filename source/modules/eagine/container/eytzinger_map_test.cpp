@@ -0,0 +1,130 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin.hpp>
+import std;
+import eagine.core.types;
+import eagine.core.container;
+//------------------------------------------------------------------------------
+void eytzinger_map_default_construct(auto& s) {
+    eagitest::case_ test{s, 1, "default construct"};
+    eagine::eytzinger_map<int, int> em;
+
+    test.check(em.empty(), "is empty");
+    test.check_equal(em.size(), 0, "size is zero");
+    test.check(not em.contains(0), "does not contain");
+    test.check(not em.find(1).has_value(), "not found");
+}
+//------------------------------------------------------------------------------
+template <typename Key>
+void eytzinger_map_find_T(auto& s, unsigned count) {
+    eagitest::case_ test{s, 2, "find"};
+    auto& rg{test.random()};
+
+    std::map<Key, std::size_t> sm;
+    std::vector<std::pair<Key, std::size_t>> d;
+
+    const auto max_key{Key(4U * count + 1U)};
+    for(unsigned i = 0; i < count; ++i) {
+        const auto k{rg.template get_between<Key>(Key(0), max_key)};
+        sm.emplace(k, i);
+        d.emplace_back(k, i);
+    }
+
+    const eagine::eytzinger_map<Key, std::size_t> em{d};
+    test.check_equal(em.size(), eagine::span_size(sm.size()), "size is same");
+
+    for(Key k = 0; k <= max_key; ++k) {
+        const auto pos{sm.find(k)};
+        const auto found{em.find(k)};
+        test.check_equal(pos != sm.end(), found.has_value(), "found is same");
+        test.check_equal(pos != sm.end(), em.contains(k), "contains is same");
+        if(pos != sm.end()) {
+            test.check_equal(*found, pos->second, "first value is kept");
+            test.check_equal(em.at(k), pos->second, "at is ok");
+            test.check_equal(em.get(k), pos->second, "get is ok");
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void eytzinger_map_find(auto& s) {
+    for(const unsigned count : {1U, 2U, 7U, 16U, 17U, 100U, 1000U, 5000U}) {
+        eytzinger_map_find_T<int>(s, count);
+        eytzinger_map_find_T<std::uint64_t>(s, count);
+    }
+}
+//------------------------------------------------------------------------------
+void eytzinger_map_for_each(auto& s) {
+    eagitest::case_ test{s, 3, "for each"};
+    auto& rg{test.random()};
+
+    std::map<std::string, int> sm;
+    eagine::flat_map<std::string, int> fm;
+    for(unsigned i = 0; i < test.repeats(1000); ++i) {
+        const auto k{rg.get_string(1, 8)};
+        sm[k] = int(i);
+        fm[k] = int(i);
+    }
+
+    eagine::eytzinger_map<std::string, int> em{fm};
+    test.check_equal(em.size(), eagine::span_size(sm.size()), "size is same");
+
+    auto pos{sm.begin()};
+    em.for_each([&](const std::string& k, int& v) {
+        test.ensure(pos != sm.end(), "not at end");
+        test.check(k == pos->first, "key is same");
+        test.check_equal(v, pos->second, "value is same");
+        ++v;
+        ++pos;
+    });
+    test.check(pos == sm.end(), "is at end");
+
+    for(const auto& [k, v] : sm) {
+        test.check_equal(em.at(k), v + 1, "value updated");
+    }
+}
+//------------------------------------------------------------------------------
+void eytzinger_map_modify(auto& s) {
+    eagitest::case_ test{s, 4, "modify"};
+    eagine::eytzinger_map<int, std::string> em{{3, "C"}, {1, "A"}, {2, "B"}};
+
+    test.check_equal(em.size(), 3, "size is ok");
+    test.check(em.at(2) == "B", "value is ok");
+
+    em.insert_or_assign(2, "b");
+    test.check_equal(em.size(), 3, "size is same");
+    test.check(em.at(2) == "b", "value replaced");
+
+    em.insert_or_assign(0, "Z");
+    test.check_equal(em.size(), 4, "size incremented");
+    test.check(em.at(0) == "Z", "value inserted");
+
+    test.check_equal(em.erase(5), 0, "nothing erased");
+    test.check_equal(em.erase(1), 1, "erased");
+    test.check(not em.contains(1), "is erased");
+    test.check_equal(em.size(), 3, "size decremented");
+
+    bool thrown{false};
+    try {
+        [[maybe_unused]] const auto& v{em.at(1)};
+    } catch(const std::out_of_range&) {
+        thrown = true;
+    }
+    test.check(thrown, "at throws");
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagitest::suite test{argc, argv, "eytzinger_map", 4};
+    test.once(eytzinger_map_default_construct);
+    test.once(eytzinger_map_find);
+    test.once(eytzinger_map_for_each);
+    test.once(eytzinger_map_modify);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end.hpp>
@@ -19,12 +19,16 @@ namespace eagine {
 //------------------------------------------------------------------------------
 export template <typename Object, std::size_t N>
 class object_pool;
-export template <typename Object, std::size_t N>
-class pool_object : public optional_like_crtp<pool_object<Object, N>, Object> {
+export template <
+  typename Object,
+  std::size_t N,
+  typename Pool = object_pool<Object, N>>
+class pool_object
+  : public optional_like_crtp<pool_object<Object, N, Pool>, Object> {
 public:
     pool_object() noexcept = default;
 
-    pool_object(object_pool<Object, N>& pool);
+    pool_object(Pool& pool);
 
     pool_object(pool_object&& temp) noexcept
       : _pool{std::exchange(temp._pool, nullptr)}
@@ -65,7 +69,7 @@ public:
     }
 
 private:
-    object_pool<Object, N>* _pool{nullptr};
+    Pool* _pool{nullptr};
     Object* _object{nullptr};
 };
 //------------------------------------------------------------------------------
@@ -161,13 +165,282 @@ private:
     std::size_t _count{0U};
 };
 //------------------------------------------------------------------------------
-template <typename Object, std::size_t N>
-pool_object<Object, N>::pool_object(object_pool<Object, N>& pool)
+/// @brief Object pool allocating objects in contiguous slabs of N objects.
+/// @ingroup container
+/// @see object_pool
+///
+/// Unused object slots are kept in an intrusive free list, so make and get
+/// run in constant time. The slabs are aligned to their power-of-two size,
+/// which makes finding the slab of an eaten object a single hash lookup.
+/// If ThreadSafe is true, the pool is guarded by a mutex, and front_cache
+/// objects can be used to make and eat objects without locking it for each
+/// operation.
+export template <typename Object, std::size_t N, bool ThreadSafe = false>
+class slab_object_pool {
+    static_assert(N > 0U);
+
+    struct _node {
+        union {
+            _node* next;
+            Object object;
+        };
+        bool live{false};
+
+        _node() noexcept
+          : next{nullptr} {}
+        _node(_node&&) = delete;
+        _node(const _node&) = delete;
+        auto operator=(_node&&) = delete;
+        auto operator=(const _node&) = delete;
+        ~_node() noexcept {}
+    };
+
+    struct _slab {
+        std::array<_node, N> nodes;
+    };
+
+    static constexpr const std::size_t _slab_align{
+      std::bit_ceil(std::max(sizeof(_slab), alignof(_slab)))};
+
+    struct _no_lock {
+        constexpr void lock() noexcept {}
+        constexpr void unlock() noexcept {}
+    };
+
+    using _mutex_t = std::conditional_t<ThreadSafe, std::mutex, _no_lock>;
+    using _count_t =
+      std::conditional_t<ThreadSafe, std::atomic<std::size_t>, std::size_t>;
+
+public:
+    /// @brief Per-thread cache of free object slots of a slab_object_pool.
+    /// @note Must be destroyed before the pool it was created for.
+    class front_cache {
+    public:
+        front_cache(slab_object_pool& pool) noexcept
+          : _pool{pool} {}
+
+        front_cache(front_cache&&) = delete;
+        front_cache(const front_cache&) = delete;
+        auto operator=(front_cache&&) = delete;
+        auto operator=(const front_cache&) = delete;
+
+        ~front_cache() noexcept {
+            _pool._flush(*this, _size);
+        }
+
+    private:
+        friend class slab_object_pool;
+        static constexpr const std::size_t _capacity{32U};
+
+        slab_object_pool& _pool;
+        std::array<_node*, _capacity> _nodes{};
+        std::size_t _size{0U};
+    };
+
+    slab_object_pool() noexcept = default;
+    slab_object_pool(slab_object_pool&&) = delete;
+    slab_object_pool(const slab_object_pool&) = delete;
+    auto operator=(slab_object_pool&&) = delete;
+    auto operator=(const slab_object_pool&) = delete;
+
+    ~slab_object_pool() noexcept {
+        for(auto* slab : _slabs) {
+            for(auto& node : slab->nodes) {
+                if(node.live) {
+                    std::destroy_at(&node.object);
+                }
+            }
+            std::destroy_at(slab);
+            ::operator delete(
+              static_cast<void*>(slab), std::align_val_t{_slab_align});
+        }
+    }
+
+    /// @brief Constructs a new object from the specified arguments.
+    template <typename... Args>
+    [[nodiscard]] auto make(Args&&... args) -> Object& {
+        _node* node{nullptr};
+        {
+            const std::lock_guard lock{_mutex};
+            node = _pop_free();
+        }
+        return _construct(*node, std::forward<Args>(args)...);
+    }
+
+    /// @brief Constructs a new default-initialized object.
+    [[nodiscard]] auto get() -> Object& {
+        return make();
+    }
+
+    [[nodiscard]] auto get_object()
+      -> pool_object<Object, N, slab_object_pool> {
+        return {*this};
+    }
+
+    /// @brief Constructs a new object using a slot from the specified cache.
+    template <typename... Args>
+    [[nodiscard]] auto make(front_cache& cache, Args&&... args) -> Object& {
+        assert(&cache._pool == this);
+        if(cache._size == 0U) [[unlikely]] {
+            _refill(cache);
+        }
+        return _construct(
+          *cache._nodes[--cache._size], std::forward<Args>(args)...);
+    }
+
+    /// @brief Destroys the specified object and returns it to the pool.
+    /// @returns false if the object does not belong to this pool.
+    auto eat(const Object& obj) noexcept -> bool {
+        const std::lock_guard lock{_mutex};
+        if(auto node{_find_live(obj)}) [[likely]] {
+            _destroy(*node);
+            node->next = _free;
+            _free = node;
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief Destroys the specified object and puts its slot into the cache.
+    /// @pre The object was made by this pool and was not eaten yet.
+    void eat(front_cache& cache, const Object& obj) noexcept {
+        assert(&cache._pool == this);
+        auto& node{_node_of(obj)};
+        assert(node.live);
+        _destroy(node);
+        if(cache._size == cache._capacity) [[unlikely]] {
+            _flush(cache, cache._capacity / 2U);
+        }
+        cache._nodes[cache._size++] = &node;
+    }
+
+    auto eat(const Object* obj) noexcept -> bool {
+        if(obj) [[likely]] {
+            return eat(*obj);
+        }
+        return false;
+    }
+
+    template <typename Base>
+        requires(std::derived_from<Object, Base>)
+    auto eat(const Base* base) noexcept -> bool {
+        if(const auto obj{dynamic_cast<const Object*>(base)}) [[likely]] {
+            return eat(*obj);
+        }
+        return false;
+    }
+
+    auto empty() const noexcept -> bool {
+        return size() == 0U;
+    }
+
+    auto size() const noexcept -> std::size_t {
+        return _count;
+    }
+
+    auto capacity() const noexcept -> std::size_t {
+        const std::lock_guard lock{_mutex};
+        return _slabs.size() * N;
+    }
+
+private:
+    static auto _node_of(const Object& obj) noexcept -> _node& {
+        // the object is the first member of the node
+        return *reinterpret_cast<_node*>(
+          const_cast<std::byte*>(reinterpret_cast<const std::byte*>(&obj)));
+    }
+
+    auto _find_live(const Object& obj) const noexcept -> _node* {
+        const auto addr{reinterpret_cast<std::uintptr_t>(&obj)};
+        const auto base{addr & ~std::uintptr_t(_slab_align - 1U)};
+        const auto pos{_slabs.find(reinterpret_cast<_slab*>(base))};
+        if(pos != _slabs.end()) {
+            const auto offset{addr - base};
+            if((offset < sizeof(_slab)) and (offset % sizeof(_node) == 0U)) {
+                auto& node{(*pos)->nodes[offset / sizeof(_node)]};
+                if(node.live) {
+                    return &node;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    void _add_slab() {
+        void* ptr{::operator new(sizeof(_slab), std::align_val_t{_slab_align})};
+        auto* slab{new(ptr) _slab{}};
+        try {
+            _slabs.insert(slab);
+        } catch(...) {
+            std::destroy_at(slab);
+            ::operator delete(ptr, std::align_val_t{_slab_align});
+            throw;
+        }
+        for(auto& node : std::views::reverse(slab->nodes)) {
+            node.next = _free;
+            _free = &node;
+        }
+    }
+
+    auto _pop_free() -> _node* {
+        if(not _free) [[unlikely]] {
+            _add_slab();
+        }
+        auto* node{_free};
+        _free = node->next;
+        return node;
+    }
+
+    template <typename... Args>
+    auto _construct(_node& node, Args&&... args) -> Object& {
+        try {
+            std::construct_at(&node.object, std::forward<Args>(args)...);
+        } catch(...) {
+            const std::lock_guard lock{_mutex};
+            node.next = _free;
+            _free = &node;
+            throw;
+        }
+        node.live = true;
+        ++_count;
+        return node.object;
+    }
+
+    void _destroy(_node& node) noexcept {
+        std::destroy_at(&node.object);
+        node.live = false;
+        --_count;
+    }
+
+    void _refill(front_cache& cache) {
+        const std::lock_guard lock{_mutex};
+        while(cache._size < cache._capacity / 2U) {
+            cache._nodes[cache._size++] = _pop_free();
+        }
+    }
+
+    void _flush(front_cache& cache, std::size_t count) noexcept {
+        const std::lock_guard lock{_mutex};
+        while(count-- > 0U) {
+            auto* node{cache._nodes[--cache._size]};
+            node->next = _free;
+            _free = node;
+        }
+    }
+
+    mutable _mutex_t _mutex;
+    std::unordered_set<_slab*> _slabs;
+    _node* _free{nullptr};
+    _count_t _count{0U};
+};
+//------------------------------------------------------------------------------
+template <typename Object, std::size_t N, typename Pool>
+pool_object<Object, N, Pool>::pool_object(Pool& pool)
   : _pool{&pool}
   , _object{&_pool->get()} {}
 //------------------------------------------------------------------------------
-template <typename Object, std::size_t N>
-pool_object<Object, N>::~pool_object() noexcept {
+template <typename Object, std::size_t N, typename Pool>
+pool_object<Object, N, Pool>::~pool_object() noexcept {
     if(_pool) {
         _pool->eat(_object);
     }
@@ -119,12 +119,111 @@ void object_pool_object(auto& s) {
     test.check(pool.size() <= pool.capacity(), "size <= capacity");
 }
 //------------------------------------------------------------------------------
+void slab_object_pool_make(auto& s) {
+    eagitest::case_ test{s, 6, "slab make"};
+    auto& rg{test.random()};
+
+    eagine::slab_object_pool<std::string, 16> pool;
+    test.check(pool.empty(), "is empty");
+    test.check_equal(pool.capacity(), 0U, "capacity is zero");
+
+    std::vector<std::reference_wrapper<std::string>> refs;
+    std::vector<std::string> strs;
+
+    for(unsigned i = 0; i < test.repeats(1000); ++i) {
+        strs.push_back(rg.get_string(2, 64));
+        refs.push_back(pool.make(strs.back()));
+    }
+
+    test.check_equal(pool.size(), refs.size(), "size is ok");
+    test.check(pool.size() <= pool.capacity(), "size <= capacity");
+    test.check_equal(pool.capacity() % 16U, 0U, "whole slabs");
+
+    for(std::size_t i = 0; i < refs.size(); ++i) {
+        test.check_equal(refs[i].get(), strs[i], "value is ok");
+    }
+
+    for(const auto& str : strs) {
+        test.check(not pool.eat(str), "do not eat foreign");
+    }
+
+    std::default_random_engine re{};
+    std::shuffle(refs.begin(), refs.end(), re);
+
+    const auto capacity{pool.capacity()};
+    for(const auto& ref : refs) {
+        test.check(pool.eat(ref.get()), "eat ok");
+    }
+    test.check(pool.empty(), "is empty");
+
+    for(unsigned i = 0; i < test.repeats(1000); ++i) {
+        refs[i] = pool.make(rg.get_string(2, 64));
+    }
+    test.check_equal(pool.capacity(), capacity, "slots reused");
+    test.check(pool.eat(refs.front().get()), "eat ok");
+    test.check(not pool.eat(refs.front().get()), "do not eat twice");
+}
+//------------------------------------------------------------------------------
+void slab_object_pool_object(auto& s) {
+    eagitest::case_ test{s, 7, "slab object"};
+
+    eagine::slab_object_pool<std::string, 8> pool;
+    std::vector<decltype(pool.get_object())> strs;
+
+    for(unsigned i = 0; i < test.repeats(1000); ++i) {
+        strs.push_back(pool.get_object());
+        test.check(strs.back()->empty(), "is default constructed");
+    }
+
+    test.check_equal(pool.size(), strs.size(), "size is ok");
+    strs.clear();
+    test.check(pool.empty(), "is empty");
+}
+//------------------------------------------------------------------------------
+void slab_object_pool_front_cache(auto& s) {
+    eagitest::case_ test{s, 8, "slab front cache"};
+
+    eagine::slab_object_pool<std::uint64_t, 64, true> pool;
+    std::atomic<int> errors{0};
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, &errors, t] {
+            decltype(pool)::front_cache cache{pool};
+            std::vector<std::uint64_t*> objs;
+            for(int r = 0; r < 10; ++r) {
+                for(int i = 0; i < 1000; ++i) {
+                    objs.push_back(&pool.make(cache, std::uint64_t(t + i)));
+                }
+                for(int i = 0; i < 1000; ++i) {
+                    if(*objs[std::size_t(i)] != std::uint64_t(t + i)) {
+                        ++errors;
+                    }
+                    pool.eat(cache, *objs[std::size_t(i)]);
+                }
+                objs.clear();
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    test.check_equal(errors.load(), 0, "no errors");
+    test.check(pool.empty(), "is empty");
+    test.check(pool.capacity() <= 4U * 1064U, "slots reused");
+}
+//------------------------------------------------------------------------------
 auto main(int argc, const char** argv) -> int {
-    eagitest::suite test{argc, argv, "object_pool", 4};
+    eagitest::suite test{argc, argv, "object_pool", 8};
     test.once(object_pool_default_construct);
     test.once(object_pool_make);
     test.once(object_pool_get);
     test.once(object_pool_do_not_eat);
+    test.once(object_pool_object);
+    test.once(slab_object_pool_make);
+    test.once(slab_object_pool_object);
+    test.once(slab_object_pool_front_cache);
     return test.exit_code();
 }
 //------------------------------------------------------------------------------
@@ -7,6 +7,7 @@
 ///
 module;
 
+#include <asio/buffer.hpp>
 #include <asio/io_context.hpp>
 #include <asio/ip/tcp.hpp>
 #include <asio/local/stream_protocol.hpp>
@@ -32,7 +33,13 @@ class asio_log_output_stream_base
       asio_log_output_stream_base<Endpoint, Socket>>
   , public log_output_stream {
 public:
-    asio_log_output_stream_base(Endpoint endpoint);
+    asio_log_output_stream_base(Endpoint endpoint, const log_stream_info&);
+    asio_log_output_stream_base(asio_log_output_stream_base&&) = delete;
+    asio_log_output_stream_base(const asio_log_output_stream_base&) = delete;
+    auto operator=(asio_log_output_stream_base&&) = delete;
+    auto operator=(const asio_log_output_stream_base&) = delete;
+    ~asio_log_output_stream_base() noexcept override;
+
     void begin_stream(
       const memory::const_block&,
       const memory::const_block&) noexcept final;
@@ -41,6 +48,10 @@ public:
     void finish_entry() noexcept final;
     void finish_stream(const memory::const_block&) noexcept final;
 
+    auto dropped_entries() noexcept -> std::uintmax_t final;
+    auto queued_entries() noexcept -> span_size_t final;
+    auto bytes_in_flight() noexcept -> span_size_t final;
+
 private:
     void _do_send(const memory::const_block);
     void _separate();
@@ -51,6 +62,17 @@ private:
     void _reconnect() noexcept;
     void _handle_entry() noexcept;
 
+    // background sender
+    void _enqueue_entry() noexcept;
+    void _gather_chunk(const memory::const_block chunk) {
+        _gathered.emplace_back(chunk.data(), chunk.std_size());
+    }
+    void _gather_first(const memory::const_block);
+    void _gather(const memory::const_block);
+    void _send_batch() noexcept;
+    void _sender_loop() noexcept;
+    void _stop_sender() noexcept;
+
     asio::io_context _context{};
     Endpoint _endpoint;
     Socket _socket;
@@ -61,13 +83,41 @@ private:
     memory::buffer _bgn;
     memory::buffer _sep;
     bool _first{true};
+
+    const span_size_t _max_queued_bytes;
+    std::mutex _queue_mutex;
+    std::condition_variable _queue_cond;
+    std::vector<memory::buffer> _queue;
+    std::vector<memory::buffer> _batch;
+    std::vector<memory::buffer> _recycled;
+    std::vector<asio::const_buffer> _gathered;
+    std::atomic<span_size_t> _queued_entries{0};
+    std::atomic<span_size_t> _bytes_in_flight{0};
+    std::atomic<std::uintmax_t> _dropped{0U};
+    std::thread _sender;
+    bool _stopping{false};
 };
 //------------------------------------------------------------------------------
 template <typename Endpoint, typename Socket>
 asio_log_output_stream_base<Endpoint, Socket>::asio_log_output_stream_base(
-  Endpoint endpoint)
+  Endpoint endpoint,
+  const log_stream_info& info)
   : _endpoint{std::move(endpoint)}
-  , _socket{_context} {}
+  , _socket{_context}
+  , _storage{info.reconnect_buffer_size}
+  , _max_queued_bytes{info.sender_queue_size} {
+    if(info.background_sender) {
+        _sender = std::thread{[this] {
+            _sender_loop();
+        }};
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Endpoint, typename Socket>
+asio_log_output_stream_base<Endpoint, Socket>::
+  ~asio_log_output_stream_base() noexcept {
+    _stop_sender();
+}
 //------------------------------------------------------------------------------
 template <typename Endpoint, typename Socket>
 void asio_log_output_stream_base<Endpoint, Socket>::_send_stored() {
@@ -173,6 +223,10 @@ void asio_log_output_stream_base<Endpoint, Socket>::_reconnect() noexcept {
 //------------------------------------------------------------------------------
 template <typename Endpoint, typename Socket>
 void asio_log_output_stream_base<Endpoint, Socket>::finish_entry() noexcept {
+    if(_sender.joinable()) {
+        _enqueue_entry();
+        return;
+    }
     if(not _socket.is_open()) [[unlikely]] {
         _reconnect();
     }
@@ -182,6 +236,7 @@ void asio_log_output_stream_base<Endpoint, Socket>::finish_entry() noexcept {
 template <typename Endpoint, typename Socket>
 void asio_log_output_stream_base<Endpoint, Socket>::finish_stream(
   const memory::const_block& end) noexcept {
+    _stop_sender();
     if(not _socket.is_open()) [[unlikely]] {
         _reconnect();
     }
@@ -191,6 +246,154 @@ void asio_log_output_stream_base<Endpoint, Socket>::finish_stream(
     }
 }
 //------------------------------------------------------------------------------
+template <typename Endpoint, typename Socket>
+auto asio_log_output_stream_base<Endpoint, Socket>::dropped_entries() noexcept
+  -> std::uintmax_t {
+    return _dropped.load(std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+template <typename Endpoint, typename Socket>
+auto asio_log_output_stream_base<Endpoint, Socket>::queued_entries() noexcept
+  -> span_size_t {
+    return _queued_entries.load(std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+template <typename Endpoint, typename Socket>
+auto asio_log_output_stream_base<Endpoint, Socket>::bytes_in_flight() noexcept
+  -> span_size_t {
+    return _bytes_in_flight.load(std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+// Background sender
+//------------------------------------------------------------------------------
+template <typename Endpoint, typename Socket>
+void asio_log_output_stream_base<Endpoint, Socket>::_enqueue_entry() noexcept {
+    auto& entry{_buffers.next()};
+    const auto size{entry.size()};
+    if(size == 0) {
+        return;
+    }
+    try {
+        const std::lock_guard<std::mutex> lock{_queue_mutex};
+        if(_bytes_in_flight.load() + size > _max_queued_bytes) [[unlikely]] {
+            _dropped.fetch_add(1U, std::memory_order_relaxed);
+            entry.clear();
+            return;
+        }
+        // hand over the entry buffer and reuse a previously sent one
+        _queue.emplace_back(std::move(entry));
+        if(_recycled.empty()) {
+            entry = memory::buffer{};
+        } else {
+            entry = std::move(_recycled.back());
+            _recycled.pop_back();
+        }
+        _queued_entries.fetch_add(1, std::memory_order_relaxed);
+        _bytes_in_flight.fetch_add(size, std::memory_order_relaxed);
+    } catch(...) {
+        _dropped.fetch_add(1U, std::memory_order_relaxed);
+        entry.clear();
+        return;
+    }
+    _queue_cond.notify_one();
+}
+//------------------------------------------------------------------------------
+template <typename Endpoint, typename Socket>
+void asio_log_output_stream_base<Endpoint, Socket>::_gather_first(
+  const memory::const_block entry) {
+    _gather_chunk(view(_hdr));
+    if(_bgn.empty()) {
+        memory::append_to(entry, _bgn);
+    } else {
+        _gather_chunk(view(_bgn));
+        _gather_chunk(view(_sep));
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Endpoint, typename Socket>
+void asio_log_output_stream_base<Endpoint, Socket>::_gather(
+  const memory::const_block entry) {
+    if(not _first) [[likely]] {
+        _gather_chunk(view(_sep));
+    } else {
+        _gather_first(entry);
+        _first = false;
+    }
+    _gather_chunk(entry);
+}
+//------------------------------------------------------------------------------
+template <typename Endpoint, typename Socket>
+void asio_log_output_stream_base<Endpoint, Socket>::_send_batch() noexcept {
+    if(not _socket.is_open()) [[unlikely]] {
+        _reconnect();
+    }
+    bool sent{false};
+    if(_socket.is_open()) [[likely]] {
+        try {
+            if(not _storage.empty()) [[unlikely]] {
+                _send_stored();
+            }
+            // all entries from the batch go out in one scatter-gather write
+            _gathered.clear();
+            for(const auto& entry : _batch) {
+                _gather(view(entry));
+            }
+            asio::write(_socket, _gathered);
+            sent = true;
+        } catch(...) {
+            _first = true;
+            _socket.close();
+        }
+    }
+    if(not sent) {
+        for(const auto& entry : _batch) {
+            _store(view(entry));
+        }
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Endpoint, typename Socket>
+void asio_log_output_stream_base<Endpoint, Socket>::_sender_loop() noexcept {
+    std::unique_lock<std::mutex> lock{_queue_mutex};
+    while(true) {
+        _queue_cond.wait(lock, [this] {
+            return _stopping or not _queue.empty();
+        });
+        if(_queue.empty()) {
+            break;
+        }
+        std::swap(_queue, _batch);
+        _queued_entries.store(0, std::memory_order_relaxed);
+        lock.unlock();
+
+        span_size_t batch_size{0};
+        for(const auto& entry : _batch) {
+            batch_size += entry.size();
+        }
+        _send_batch();
+
+        lock.lock();
+        _bytes_in_flight.fetch_sub(batch_size, std::memory_order_relaxed);
+        for(auto& entry : _batch) {
+            entry.clear();
+            _recycled.emplace_back(std::move(entry));
+        }
+        _batch.clear();
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Endpoint, typename Socket>
+void asio_log_output_stream_base<Endpoint, Socket>::_stop_sender() noexcept {
+    if(_sender.joinable()) {
+        {
+            const std::lock_guard<std::mutex> lock{_queue_mutex};
+            _stopping = true;
+        }
+        _queue_cond.notify_one();
+        _sender.join();
+    }
+}
+//------------------------------------------------------------------------------
 // Local stream
 //------------------------------------------------------------------------------
 class asio_local_log_output_stream
@@ -202,8 +405,10 @@ class asio_local_log_output_stream
       asio::local::stream_protocol::socket>;
 
 public:
-    asio_local_log_output_stream(const string_view addr_str)
-      : base{_endpoint(addr_str)} {}
+    asio_local_log_output_stream(
+      const string_view addr_str,
+      const log_stream_info& info)
+      : base{_endpoint(addr_str), info} {}
 
 private:
     static auto _fix_addr(const string_view addr_str) noexcept -> string_view {
@@ -226,8 +431,10 @@ class asio_tcpipv4_log_output_stream
       asio_log_output_stream_base<asio::ip::tcp::endpoint, asio::ip::tcp::socket>;
 
 public:
-    asio_tcpipv4_log_output_stream(const string_view addr_str)
-      : base{_endpoint(addr_str)} {}
+    asio_tcpipv4_log_output_stream(
+      const string_view addr_str,
+      const log_stream_info& info)
+      : base{_endpoint(addr_str), info} {}
 
 private:
     static auto _fix_addr(const string_view addr_str)
@@ -252,14 +459,16 @@ private:
 //------------------------------------------------------------------------------
 // factory functions
 //------------------------------------------------------------------------------
-auto make_asio_local_output_stream(const string_view addr_str)
-  -> unique_holder<log_output_stream> {
-    return {hold<asio_local_log_output_stream>, addr_str};
+auto make_asio_local_output_stream(
+  const string_view addr_str,
+  const log_stream_info& info) -> unique_holder<log_output_stream> {
+    return {hold<asio_local_log_output_stream>, addr_str, info};
 }
 //------------------------------------------------------------------------------
-auto make_asio_tcpipv4_output_stream(const string_view addr_str)
-  -> unique_holder<log_output_stream> {
-    return {hold<asio_tcpipv4_log_output_stream>, addr_str};
+auto make_asio_tcpipv4_output_stream(
+  const string_view addr_str,
+  const log_stream_info& info) -> unique_holder<log_output_stream> {
+    return {hold<asio_tcpipv4_log_output_stream>, addr_str, info};
 }
 //------------------------------------------------------------------------------
 } // namespace eagine
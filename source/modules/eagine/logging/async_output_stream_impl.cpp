@@ -0,0 +1,431 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module eagine.core.logging;
+
+import std;
+import eagine.core.types;
+import eagine.core.memory;
+import :backend;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+// Staging ring
+//------------------------------------------------------------------------------
+/// @brief Single-producer single-consumer byte ring of length-prefixed entries.
+class async_log_staging_ring {
+public:
+    async_log_staging_ring(const span_size_t capacity) noexcept
+      : _capacity{std::bit_ceil(std::max(std_size(capacity), _min_capacity))}
+      , _mask{_capacity - 1U} {
+        _storage.resize(span_size(_capacity));
+    }
+
+    auto try_claim() noexcept -> bool {
+        return not _claimed.test_and_set(std::memory_order_acquire);
+    }
+
+    void release() noexcept {
+        _claimed.clear(std::memory_order_release);
+    }
+
+    auto entry() noexcept -> memory::buffer& {
+        return _entry;
+    }
+
+    auto dropped_count() const noexcept -> std::uintmax_t {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    void count_dropped() noexcept {
+        _dropped.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    auto can_ever_fit(const memory::const_block entry) const noexcept -> bool {
+        return _record_size(entry) <= _capacity;
+    }
+
+    /// @brief Tries to push the entry into the ring, returns false when full.
+    /// @note Must be called only by the thread that claimed this ring.
+    auto try_push(const memory::const_block entry) noexcept -> bool {
+        const auto pos{_head.load(std::memory_order_relaxed)};
+        const auto tail{_tail.load(std::memory_order_acquire)};
+        const auto size{_record_size(entry)};
+        if(_capacity - (pos - tail) < size) {
+            return false;
+        }
+        const auto len{limit_cast<std::uint32_t>(entry.size())};
+        _copy_in(pos, as_bytes(view_one(len)));
+        _copy_in(pos + sizeof(len), entry);
+        _head.store(pos + size, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Calls the function on each stored entry and removes it.
+    /// @note Must be called only by the draining thread.
+    template <typename Function>
+    auto drain(Function& func) noexcept -> span_size_t {
+        span_size_t count{0};
+        auto tail{_tail.load(std::memory_order_relaxed)};
+        const auto end{_head.load(std::memory_order_acquire)};
+        while(tail != end) {
+            std::uint32_t len{0U};
+            _copy_out(tail, as_bytes(cover_one(len)));
+            const auto offs{(tail + sizeof(len)) & _mask};
+            if(offs + len <= _capacity) [[likely]] {
+                func(head(
+                  skip(view(_storage), span_size(offs)), span_size(len)));
+            } else {
+                _record.resize(span_size(len));
+                _copy_out(tail + sizeof(len), cover(_record));
+                func(view(_record));
+            }
+            tail += sizeof(len) + len;
+            _tail.store(tail, std::memory_order_release);
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    static constexpr const std::size_t _min_capacity{4096U};
+
+    static auto _record_size(const memory::const_block entry) noexcept
+      -> std::size_t {
+        return sizeof(std::uint32_t) + std_size(entry.size());
+    }
+
+    void _copy_in(
+      const std::size_t pos,
+      const memory::const_block src) noexcept {
+        const auto offs{pos & _mask};
+        const auto first{std::min(std_size(src.size()), _capacity - offs)};
+        std::memcpy(_storage.data() + offs, src.data(), first);
+        std::memcpy(
+          _storage.data(), src.data() + first, std_size(src.size()) - first);
+    }
+
+    void _copy_out(const std::size_t pos, memory::block dst) noexcept {
+        const auto offs{pos & _mask};
+        const auto first{std::min(std_size(dst.size()), _capacity - offs)};
+        std::memcpy(dst.data(), _storage.data() + offs, first);
+        std::memcpy(
+          dst.data() + first, _storage.data(), std_size(dst.size()) - first);
+    }
+
+    const std::size_t _capacity;
+    const std::size_t _mask;
+    memory::buffer _storage;
+    alignas(64) std::atomic<std::size_t> _head{0U};
+    alignas(64) std::atomic<std::size_t> _tail{0U};
+    std::atomic<std::uintmax_t> _dropped{0U};
+    std::atomic_flag _claimed{};
+    // producer-side entry staging
+    memory::buffer _entry;
+    // consumer-side scratch for records wrapping around the end
+    memory::buffer _record;
+};
+//------------------------------------------------------------------------------
+// Async stream
+//------------------------------------------------------------------------------
+class async_log_output_stream : public log_output_stream {
+public:
+    async_log_output_stream(
+      shared_holder<log_output_stream> output,
+      const log_stream_info& info);
+
+    async_log_output_stream(async_log_output_stream&&) = delete;
+    async_log_output_stream(const async_log_output_stream&) = delete;
+    auto operator=(async_log_output_stream&&) = delete;
+    auto operator=(const async_log_output_stream&) = delete;
+    ~async_log_output_stream() noexcept final;
+
+    void begin_stream(
+      const memory::const_block&,
+      const memory::const_block&) noexcept final;
+    void begin_entry() noexcept final;
+    void entry_append(const memory::const_block&) noexcept final;
+    void finish_entry() noexcept final;
+    void finish_stream(const memory::const_block&) noexcept final;
+
+    auto dropped_entries() noexcept -> std::uintmax_t final;
+
+    auto queued_entries() noexcept -> span_size_t final {
+        return _output->queued_entries();
+    }
+
+    auto bytes_in_flight() noexcept -> span_size_t final {
+        return _output->bytes_in_flight();
+    }
+
+private:
+    struct _thread_binding {
+        std::uint64_t parent_id{0U};
+        shared_holder<async_log_staging_ring> ring{};
+
+        _thread_binding() noexcept = default;
+        _thread_binding(_thread_binding&&) = delete;
+        _thread_binding(const _thread_binding&) = delete;
+        auto operator=(_thread_binding&&) = delete;
+        auto operator=(const _thread_binding&) = delete;
+        ~_thread_binding() noexcept {
+            unbind();
+        }
+
+        void unbind() noexcept {
+            if(ring) {
+                ring->release();
+                ring.reset();
+            }
+            parent_id = 0U;
+        }
+    };
+
+    auto _bind_ring() noexcept -> async_log_staging_ring&;
+    auto _claim_ring() -> shared_holder<async_log_staging_ring>;
+    void _wake_drain() noexcept;
+    void _wake_producers() noexcept;
+    void _push(async_log_staging_ring&) noexcept;
+    void _batch_entry(const memory::const_block) noexcept;
+    void _write_batch() noexcept;
+    auto _drain_all(
+      std::vector<shared_holder<async_log_staging_ring>>&) noexcept
+      -> span_size_t;
+    void _drain_loop() noexcept;
+    void _stop() noexcept;
+
+    static auto _next_instance_id() noexcept -> std::uint64_t {
+        static std::atomic<std::uint64_t> id_seq{0U};
+        return ++id_seq;
+    }
+
+    const std::uint64_t _instance_id{_next_instance_id()};
+    shared_holder<log_output_stream> _output;
+    const span_size_t _ring_size;
+    const log_overflow_policy _overflow;
+
+    std::mutex _rings_mutex;
+    std::vector<shared_holder<async_log_staging_ring>> _rings;
+    std::atomic<std::size_t> _ring_count{0U};
+
+    // entries are joined with the separator and written in batches
+    static constexpr const span_size_t _max_batch_size{64 * 1024};
+    memory::buffer _sep;
+    memory::buffer _batch;
+    span_size_t _batch_entries{0};
+    bool _first_entry{true};
+
+    std::atomic<std::uint64_t> _sequence{0U};
+    // incremented by the drain thread after it freed some ring space
+    std::atomic<std::uint64_t> _drained{0U};
+    std::atomic<bool> _done{false};
+    std::thread _drain_thread;
+};
+//------------------------------------------------------------------------------
+async_log_output_stream::async_log_output_stream(
+  shared_holder<log_output_stream> output,
+  const log_stream_info& info)
+  : _output{std::move(output)}
+  , _ring_size{info.async_ring_size}
+  , _overflow{info.overflow_policy}
+  , _drain_thread{[this]() {
+      _drain_loop();
+  }} {}
+//------------------------------------------------------------------------------
+async_log_output_stream::~async_log_output_stream() noexcept {
+    _stop();
+}
+//------------------------------------------------------------------------------
+auto async_log_output_stream::_claim_ring()
+  -> shared_holder<async_log_staging_ring> {
+    const std::lock_guard<std::mutex> lock{_rings_mutex};
+    // reuse rings released by threads that have exited
+    for(auto& ring : _rings) {
+        if(ring->try_claim()) {
+            return ring;
+        }
+    }
+    shared_holder<async_log_staging_ring> ring{
+      hold<async_log_staging_ring>, _ring_size};
+    [[maybe_unused]] const auto claimed{ring->try_claim()};
+    _rings.push_back(ring);
+    _ring_count.store(_rings.size(), std::memory_order_release);
+    return ring;
+}
+//------------------------------------------------------------------------------
+auto async_log_output_stream::_bind_ring() noexcept -> async_log_staging_ring& {
+    thread_local _thread_binding binding{};
+    if(binding.parent_id != _instance_id) [[unlikely]] {
+        binding.unbind();
+        try {
+            binding.ring = _claim_ring();
+            binding.parent_id = _instance_id;
+        } catch(...) {
+            std::terminate();
+        }
+    }
+    return *binding.ring;
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::_wake_drain() noexcept {
+    _sequence.fetch_add(1U, std::memory_order_release);
+    _sequence.notify_one();
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::_wake_producers() noexcept {
+    _drained.fetch_add(1U, std::memory_order_release);
+    _drained.notify_all();
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::_push(async_log_staging_ring& ring) noexcept {
+    const auto entry{view(ring.entry())};
+    if(not ring.can_ever_fit(entry)) [[unlikely]] {
+        ring.count_dropped();
+        return;
+    }
+    while(true) {
+        // read before trying, so that space freed after a failed try
+        // is not missed by the wait below
+        const auto drained{_drained.load(std::memory_order_acquire)};
+        if(ring.try_push(entry)) {
+            break;
+        }
+        switch(_overflow) {
+            case log_overflow_policy::block:
+                if(_done.load(std::memory_order_acquire)) [[unlikely]] {
+                    ring.count_dropped();
+                    return;
+                }
+                _wake_drain();
+                _drained.wait(drained, std::memory_order_acquire);
+                break;
+            case log_overflow_policy::drop:
+                return;
+            case log_overflow_policy::count_and_drop:
+                ring.count_dropped();
+                return;
+        }
+    }
+    _wake_drain();
+}
+//------------------------------------------------------------------------------
+auto async_log_output_stream::_drain_all(
+  std::vector<shared_holder<async_log_staging_ring>>& rings) noexcept
+  -> span_size_t {
+    if(rings.size() != _ring_count.load(std::memory_order_acquire)) {
+        try {
+            const std::lock_guard<std::mutex> lock{_rings_mutex};
+            rings = _rings;
+        } catch(...) {
+        }
+    }
+    const auto batch_entry{[this](const memory::const_block entry) {
+        _batch_entry(entry);
+    }};
+    span_size_t count{0};
+    for(auto& ring : rings) {
+        count += ring->drain(batch_entry);
+    }
+    if(count > 0) {
+        _write_batch();
+        _wake_producers();
+    }
+    return count;
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::_batch_entry(
+  const memory::const_block entry) noexcept {
+    if(_batch_entries > 0) {
+        memory::append_to(view(_sep), _batch);
+    }
+    memory::append_to(entry, _batch);
+    ++_batch_entries;
+    // the first entry is written alone, since some outputs re-send it
+    // after reconnecting
+    if(_first_entry or (_batch.size() >= _max_batch_size)) {
+        _write_batch();
+        _first_entry = false;
+    }
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::_write_batch() noexcept {
+    if(_batch_entries > 0) {
+        _output->begin_entry();
+        _output->entry_append(view(_batch));
+        _output->finish_entry();
+        _batch.clear();
+        _batch_entries = 0;
+    }
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::_drain_loop() noexcept {
+    std::vector<shared_holder<async_log_staging_ring>> rings;
+    while(not _done.load(std::memory_order_acquire)) {
+        const auto seen{_sequence.load(std::memory_order_acquire)};
+        if(_drain_all(rings) == 0) {
+            _sequence.wait(seen, std::memory_order_acquire);
+        }
+    }
+    _drain_all(rings);
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::_stop() noexcept {
+    if(_drain_thread.joinable()) {
+        _done.store(true, std::memory_order_release);
+        _wake_drain();
+        _drain_thread.join();
+        // release producers blocked on a full ring
+        _wake_producers();
+    }
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::begin_stream(
+  const memory::const_block& stream_header,
+  const memory::const_block& entry_sep) noexcept {
+    // called before any entry is pushed, the drain thread does not touch
+    // the output or the separator until it pops the first entry
+    memory::append_to(entry_sep, _sep);
+    _output->begin_stream(stream_header, entry_sep);
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::begin_entry() noexcept {
+    _bind_ring().entry().clear();
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::entry_append(
+  const memory::const_block& chunk) noexcept {
+    memory::append_to(chunk, _bind_ring().entry());
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::finish_entry() noexcept {
+    auto& ring{_bind_ring()};
+    _push(ring);
+    ring.entry().clear();
+}
+//------------------------------------------------------------------------------
+void async_log_output_stream::finish_stream(
+  const memory::const_block& stream_footer) noexcept {
+    _stop();
+    _output->finish_stream(stream_footer);
+}
+//------------------------------------------------------------------------------
+auto async_log_output_stream::dropped_entries() noexcept -> std::uintmax_t {
+    std::uintmax_t result{_output->dropped_entries()};
+    const std::lock_guard<std::mutex> lock{_rings_mutex};
+    for(const auto& ring : _rings) {
+        result += ring->dropped_count();
+    }
+    return result;
+}
+//------------------------------------------------------------------------------
+auto make_async_output_stream(
+  shared_holder<log_output_stream> output,
+  const log_stream_info& info) -> unique_holder<log_output_stream> {
+    return {hold<async_log_output_stream>, std::move(output), info};
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
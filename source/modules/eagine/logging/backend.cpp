@@ -83,16 +83,41 @@ export enum class log_backend_lock : std::uint8_t {
     /// @brief Mutex.
     mutex,
     /// @brief Spinlock.
-    spinlock
+    spinlock,
+    /// @brief Per-thread lock-free staging drained by a background thread.
+    async
 };
 
 export template <>
 struct enumerator_traits<log_backend_lock> {
     static constexpr auto mapping() noexcept {
-        return enumerator_map_type<log_backend_lock, 3>{
+        return enumerator_map_type<log_backend_lock, 4>{
           {{"none", log_backend_lock::none},
            {"mutex", log_backend_lock::mutex},
-           {"spinlock", log_backend_lock::spinlock}}};
+           {"spinlock", log_backend_lock::spinlock},
+           {"async", log_backend_lock::async}}};
+    }
+};
+//------------------------------------------------------------------------------
+/// @brief Policy for handling log entries that do not fit into async staging.
+/// @ingroup logging
+/// @see log_backend_lock
+export enum class log_overflow_policy : std::uint8_t {
+    /// @brief Wait until the background thread makes room for the entry.
+    block,
+    /// @brief Silently drop the entry.
+    drop,
+    /// @brief Drop the entry and increment the dropped entry counter.
+    count_and_drop
+};
+
+export template <>
+struct enumerator_traits<log_overflow_policy> {
+    static constexpr auto mapping() noexcept {
+        return enumerator_map_type<log_overflow_policy, 3>{
+          {{"block", log_overflow_policy::block},
+           {"drop", log_overflow_policy::drop},
+           {"count_and_drop", log_overflow_policy::count_and_drop}}};
     }
 };
 //------------------------------------------------------------------------------
@@ -102,17 +127,98 @@ export enum class log_data_format : std::uint8_t {
     /// @brief XML format.
     xml,
     /// @brief JSON format.
-    json
+    json,
+    /// @brief Compact length-prefixed binary format.
+    /// @see log_binary_entry
+    /// @see log_binary_arg
+    binary
 };
 
 export template <>
 struct enumerator_traits<log_data_format> {
     static constexpr auto mapping() noexcept {
-        return enumerator_map_type<log_data_format, 2>{
-          {{"xml", log_data_format::xml}, {"json", log_data_format::json}}};
+        return enumerator_map_type<log_data_format, 3>{
+          {{"xml", log_data_format::xml},
+           {"json", log_data_format::json},
+           {"binary", log_data_format::binary}}};
     }
 };
 //------------------------------------------------------------------------------
+/// @brief The header starting a binary log data stream.
+/// @ingroup logging
+/// @see log_data_format
+export constexpr const string_view log_binary_stream_magic{
+  "\x7f"
+  "EAGiLog\x01"};
+
+/// @brief Binary log stream entry type codes.
+/// @ingroup logging
+/// @see log_data_format
+///
+/// Each entry in the binary stream is stored as a 32-bit little-endian payload
+/// length followed by the payload starting with one of these codes.
+/// Identifiers are stored as raw 64-bit identifier_t values, numbers as
+/// fixed-width little-endian values, strings and blobs as a 32-bit length
+/// followed by the raw bytes.
+export enum class log_binary_entry : std::uint8_t {
+    /// @brief Stream begin: i64 start time in microseconds since epoch,
+    /// string session, string identity.
+    begin = 0x01U,
+    /// @brief Description: f32 offset, id source, u64 instance,
+    /// string display name, string description.
+    description = 0x02U,
+    /// @brief State declaration: f32 offset, id source, id state tag,
+    /// id begin tag, id end tag.
+    declare_state = 0x03U,
+    /// @brief Active state: f32 offset, id source, id state tag.
+    active_state = 0x04U,
+    /// @brief Message: u8 severity, id source, id tag, u64 instance,
+    /// f32 offset, string format, followed by the arguments until the end.
+    message = 0x05U,
+    /// @brief Time interval: id tag, u64 instance, i64 average nanoseconds,
+    /// u64 count, i64 p50, i64 p90, i64 p99 and i64 max nanoseconds.
+    interval = 0x06U,
+    /// @brief Heartbeat: f32 offset.
+    heartbeat = 0x07U,
+    /// @brief Stream end: f32 offset.
+    finish = 0x08U,
+    /// @brief Chart sample: f32 offset, id source, u64 instance, id series,
+    /// f32 value, optionally followed by u64 count, f32 min and f32 max
+    /// if several samples were aggregated and the value is their mean.
+    chart_sample = 0x09U
+};
+
+/// @brief Binary log message argument type codes.
+/// @ingroup logging
+/// @see log_binary_entry
+///
+/// Each argument starts with the type code, the argument name identifier
+/// and the argument tag identifier followed by the value.
+export enum class log_binary_arg : std::uint8_t {
+    /// @brief No value.
+    nothing = 0x00U,
+    /// @brief 64-bit identifier value.
+    identifier = 0x01U,
+    /// @brief Pair of 64-bit identifier values.
+    message_id = 0x02U,
+    /// @brief 8-bit boolean value.
+    boolean = 0x03U,
+    /// @brief 64-bit signed integer value.
+    integer = 0x04U,
+    /// @brief 64-bit unsigned integer value.
+    unsigned_integer = 0x05U,
+    /// @brief 32-bit float value.
+    floating = 0x06U,
+    /// @brief Three 32-bit floats: min, value and max.
+    float_range = 0x07U,
+    /// @brief 32-bit float duration in seconds.
+    duration = 0x08U,
+    /// @brief 32-bit length followed by the UTF-8 string bytes.
+    string = 0x09U,
+    /// @brief 32-bit length followed by the raw bytes.
+    blob = 0x0AU
+};
+//------------------------------------------------------------------------------
 /// @brief Structure used to supply initial log stream information to a logger.
 /// @ingroup logging
 export struct log_stream_info {
@@ -122,6 +228,18 @@ export struct log_stream_info {
     std::string log_identity;
     /// @brief The minimum severity of log messages.
     log_event_severity min_severity;
+    /// @brief What to do with entries not fitting into the async staging ring.
+    log_overflow_policy overflow_policy{log_overflow_policy::count_and_drop};
+    /// @brief The size (in bytes) of the per-thread async staging ring.
+    span_size_t async_ring_size{256 * 1024};
+    /// @brief Indicates if network outputs use a background sender thread.
+    bool background_sender{false};
+    /// @brief The maximum number of bytes queued for the background sender.
+    span_size_t sender_queue_size{4 * 1024 * 1024};
+    /// @brief The maximum number of bytes buffered while reconnecting.
+    span_size_t reconnect_buffer_size{64 * 1024 * 1024};
+    /// @brief The window over which chart samples are aggregated (0 = off).
+    std::chrono::milliseconds chart_sample_window{0};
 };
 //------------------------------------------------------------------------------
 /// @brief Interface for logging backend implementations.
@@ -452,13 +570,37 @@ struct log_output_stream : interface<log_output_stream> {
     void finish_stream(const string_view stream_footer) noexcept {
         finish_stream(as_bytes(stream_footer));
     }
+
+    /// @brief Returns the number of entries dropped by this stream so far.
+    virtual auto dropped_entries() noexcept -> std::uintmax_t {
+        return 0U;
+    }
+
+    /// @brief Returns the number of entries waiting to be written.
+    virtual auto queued_entries() noexcept -> span_size_t {
+        return 0;
+    }
+
+    /// @brief Returns the number of bytes queued or being written.
+    virtual auto bytes_in_flight() noexcept -> span_size_t {
+        return 0;
+    }
 };
 //------------------------------------------------------------------------------
 auto make_std_output_stream(std::ostream&) -> unique_holder<log_output_stream>;
-auto make_asio_local_output_stream(const string_view)
+auto make_asio_local_output_stream(const string_view, const log_stream_info&)
   -> unique_holder<log_output_stream>;
-auto make_asio_tcpipv4_output_stream(const string_view)
+auto make_asio_tcpipv4_output_stream(const string_view, const log_stream_info&)
   -> unique_holder<log_output_stream>;
+auto make_async_output_stream(
+  shared_holder<log_output_stream>,
+  const log_stream_info&) -> unique_holder<log_output_stream>;
+//------------------------------------------------------------------------------
+/// @brief Lockable used with async output streams that stage entries per-thread.
+struct async_log_lock {
+    constexpr void lock() noexcept {}
+    constexpr void unlock() noexcept {}
+};
 //------------------------------------------------------------------------------
 //
 //------------------------------------------------------------------------------
@@ -479,6 +621,11 @@ auto make_xml_log_backend(
   const log_stream_info&,
   shared_holder<log_output_stream>,
   const log_backend_lock lock_type) -> unique_holder<logger_backend>;
+
+auto make_binary_log_backend(
+  const log_stream_info&,
+  shared_holder<log_output_stream>,
+  const log_backend_lock lock_type) -> unique_holder<logger_backend>;
 //------------------------------------------------------------------------------
 auto make_proxy_log_backend(log_stream_info info)
   -> unique_holder<logger_backend>;
@@ -0,0 +1,703 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module eagine.core.logging;
+
+import std;
+import eagine.core.types;
+import eagine.core.memory;
+import eagine.core.identifier;
+import eagine.core.utility;
+import :backend;
+import :interval_histogram;
+import :chart_downsampler;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+template <typename Lockable>
+class binary_log_backend : public logger_backend {
+    static constexpr const bool _is_async{
+      std::is_same_v<Lockable, async_log_lock>};
+
+    // in async mode each thread encodes its entries into its own buffer
+    auto _buf() noexcept -> std::vector<byte>& {
+        if constexpr(_is_async) {
+            thread_local std::vector<byte> buffer;
+            return buffer;
+        } else {
+            return _buffer;
+        }
+    }
+
+    template <std::integral T>
+    void _add(const T value) {
+        auto& buf{_buf()};
+        const auto pos{buf.size()};
+        buf.resize(pos + sizeof(T));
+        if constexpr(std::endian::native == std::endian::big) {
+            const auto le{std::byteswap(value)};
+            std::memcpy(buf.data() + pos, &le, sizeof(T));
+        } else {
+            std::memcpy(buf.data() + pos, &value, sizeof(T));
+        }
+    }
+
+    void _add(const bool value) {
+        _add(std::uint8_t(value ? 1U : 0U));
+    }
+
+    void _add(const float value) {
+        _add(std::bit_cast<std::uint32_t>(value));
+    }
+
+    void _add(const log_binary_entry code) {
+        _add(std::to_underlying(code));
+    }
+
+    void _add(const log_binary_arg code) {
+        _add(std::to_underlying(code));
+    }
+
+    void _add(const log_event_severity severity) {
+        _add(std::to_underlying(severity));
+    }
+
+    void _add(const identifier id) {
+        _add(id.value());
+    }
+
+    void _add(const memory::const_block data) {
+        _add(limit_cast<std::uint32_t>(data.size()));
+        auto& buf{_buf()};
+        buf.insert(buf.end(), data.begin(), data.end());
+    }
+
+    void _add(const string_view str) {
+        _add(as_bytes(str));
+    }
+
+    void _add(const std::chrono::steady_clock::time_point now) {
+        _add(std::chrono::duration<float>(now - _start).count());
+    }
+
+    void _add_arg(
+      const log_binary_arg type,
+      const identifier arg,
+      const identifier tag) {
+        _add(type);
+        _add(arg);
+        _add(tag);
+    }
+
+    void _begin_entry(const log_binary_entry type);
+    void _finish_entry() noexcept;
+
+public:
+    binary_log_backend(
+      const log_stream_info&,
+      shared_holder<log_output_stream>) noexcept;
+
+    binary_log_backend(binary_log_backend&&) = delete;
+    binary_log_backend(const binary_log_backend&) = delete;
+    auto operator=(binary_log_backend&&) = delete;
+    auto operator=(const binary_log_backend&) = delete;
+
+    auto allocator() noexcept -> memory::shared_byte_allocator final {
+        return _alloc;
+    }
+
+    auto type_id() noexcept -> identifier override {
+        return "BinaryLog";
+    }
+
+    void make_more_verbose() noexcept final {
+        _min_severity = decreased(_min_severity);
+    }
+
+    void make_less_verbose() noexcept final {
+        _min_severity = increased(_min_severity);
+    }
+
+    auto entry_backend(const log_event_severity severity) noexcept
+      -> logger_backend* final {
+        if(severity >= _min_severity) {
+            return this;
+        }
+        return nullptr;
+    }
+
+    void begin_log() noexcept final;
+
+    auto register_time_interval(
+      const identifier tag,
+      const logger_instance_id log_id) noexcept -> time_interval_id final;
+
+    void time_interval_begin(const time_interval_id int_id) noexcept final;
+
+    void time_interval_end(const time_interval_id int_id) noexcept final;
+
+    void set_description(
+      const identifier source,
+      const logger_instance_id instance,
+      const string_view display_name,
+      const string_view description) noexcept final;
+
+    void declare_state(
+      const identifier source,
+      const identifier state_tag,
+      const identifier begin_tag,
+      const identifier end_tag) noexcept final;
+
+    void active_state(
+      const identifier source,
+      const identifier state_tag) noexcept final;
+
+    auto begin_message(
+      const identifier source,
+      const identifier tag,
+      const logger_instance_id instance,
+      const log_event_severity severity,
+      const string_view format) noexcept -> bool final;
+
+    void add_nothing(const identifier arg, const identifier tag) noexcept final;
+
+    void add_identifier(
+      const identifier arg,
+      const identifier tag,
+      const identifier value) noexcept final;
+
+    void add_message_id(
+      const identifier arg,
+      const identifier tag,
+      const message_id value) noexcept final;
+
+    void add_bool(
+      const identifier arg,
+      const identifier tag,
+      const bool value) noexcept final;
+
+    void add_integer(
+      const identifier arg,
+      const identifier tag,
+      const std::intmax_t value) noexcept final;
+
+    void add_unsigned(
+      const identifier arg,
+      const identifier tag,
+      const std::uintmax_t value) noexcept final;
+
+    void add_float(
+      const identifier arg,
+      const identifier tag,
+      const float value) noexcept final;
+
+    void add_float(
+      const identifier arg,
+      const identifier tag,
+      const float min,
+      const float value,
+      const float max) noexcept final;
+
+    void add_duration(
+      const identifier arg,
+      const identifier tag,
+      const std::chrono::duration<float> value) noexcept final;
+
+    void add_string(
+      const identifier arg,
+      const identifier tag,
+      const string_view value) noexcept final;
+
+    void add_blob(
+      const identifier arg,
+      const identifier tag,
+      const memory::const_block value) noexcept final;
+
+    void finish_message() noexcept final;
+
+    void log_chart_sample(
+      const identifier source,
+      const logger_instance_id instance,
+      const identifier series,
+      const float value) noexcept final;
+
+    void heartbeat() noexcept final;
+    void finish_log() noexcept final;
+
+private:
+    void _report_interval(log_interval_statistics&) noexcept;
+    void _write_chart(const log_chart_window&) noexcept;
+
+    Lockable _lockable{};
+    std::conditional_t<_is_async, std::mutex, Lockable> _registry_lockable{};
+    shared_holder<log_output_stream> _output;
+    const std::string _session_identity;
+    const std::string _log_identity;
+    log_event_severity _min_severity;
+    const std::chrono::steady_clock::time_point _start;
+    std::vector<byte> _buffer;
+    memory::shared_byte_allocator _alloc{
+      hold<memory::concurrent_arena_byte_allocator>};
+
+    std::map<
+      std::tuple<identifier_t, logger_instance_id>,
+      log_interval_statistics>
+      _intervals;
+    log_chart_downsampler _charts;
+};
+//------------------------------------------------------------------------------
+// implementation
+//------------------------------------------------------------------------------
+template <typename Lockable>
+binary_log_backend<Lockable>::binary_log_backend(
+  const log_stream_info& info,
+  shared_holder<log_output_stream> output) noexcept
+  : _output{std::move(output)}
+  , _session_identity{info.session_identity}
+  , _log_identity{info.log_identity}
+  , _min_severity{info.min_severity}
+  , _start{std::chrono::steady_clock::now()}
+  , _charts{info.chart_sample_window} {
+    _buffer.reserve(1024);
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::_begin_entry(const log_binary_entry type) {
+    // placeholder for the entry size, patched in _finish_entry
+    _buf().clear();
+    _add(std::uint32_t(0U));
+    _add(type);
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::_finish_entry() noexcept {
+    auto& buf{_buf()};
+    auto size{limit_cast<std::uint32_t>(buf.size() - sizeof(std::uint32_t))};
+    if constexpr(std::endian::native == std::endian::big) {
+        size = std::byteswap(size);
+    }
+    std::memcpy(buf.data(), &size, sizeof(size));
+    _output->begin_entry();
+    _output->entry_append(view(buf));
+    _output->finish_entry();
+    buf.clear();
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::begin_log() noexcept {
+    try {
+        const auto now_sys{std::chrono::system_clock::now()};
+        const auto now_sdy{std::chrono::steady_clock::now()};
+        const auto start{std::chrono::duration_cast<std::chrono::microseconds>(
+          (now_sys - (now_sdy - _start)).time_since_epoch())};
+        const std::lock_guard<Lockable> lock{_lockable};
+        _output->begin_stream(log_binary_stream_magic, {});
+        _begin_entry(log_binary_entry::begin);
+        _add(std::int64_t(start.count()));
+        _add(string_view{_session_identity});
+        _add(string_view{_log_identity});
+        _finish_entry();
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+auto binary_log_backend<Lockable>::register_time_interval(
+  const identifier tag,
+  const logger_instance_id log_id) noexcept -> time_interval_id {
+    try {
+        const auto key{std::make_tuple(tag.value(), log_id)};
+        const std::lock_guard lock{_registry_lockable};
+        const auto pos{
+          _intervals.try_emplace(key, tag, log_id, std::chrono::seconds{10})
+            .first};
+        return reinterpret_cast<time_interval_id>(&(pos->second));
+    } catch(...) {
+        return 0U;
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::time_interval_begin(
+  const time_interval_id int_id) noexcept {
+    if(const auto info{static_cast<log_interval_statistics*>(
+         reinterpret_cast<void*>(int_id))}) {
+        info->begin();
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::time_interval_end(
+  const time_interval_id int_id) noexcept {
+    try {
+        if(const auto info{static_cast<log_interval_statistics*>(
+             reinterpret_cast<void*>(int_id))}) {
+            if(info->end()) {
+                _report_interval(*info);
+            }
+        }
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::_report_interval(
+  log_interval_statistics& info) noexcept {
+    try {
+        const auto stats{info.drain()};
+        if(stats.count > 0U) {
+            const std::lock_guard<Lockable> lock{_lockable};
+            _begin_entry(log_binary_entry::interval);
+            _add(info.tag());
+            _add(std::uint64_t(info.instance()));
+            _add(std::int64_t(stats.avg.count()));
+            _add(std::uint64_t(stats.count));
+            _add(std::int64_t(stats.p50.count()));
+            _add(std::int64_t(stats.p90.count()));
+            _add(std::int64_t(stats.p99.count()));
+            _add(std::int64_t(stats.max.count()));
+            _finish_entry();
+        }
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::set_description(
+  const identifier source,
+  const logger_instance_id instance,
+  const string_view display_name,
+  const string_view description) noexcept {
+    try {
+        const auto now{std::chrono::steady_clock::now()};
+        const std::lock_guard<Lockable> lock{_lockable};
+        _begin_entry(log_binary_entry::description);
+        _add(now);
+        _add(source);
+        _add(std::uint64_t(instance));
+        _add(display_name);
+        _add(description);
+        _finish_entry();
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::declare_state(
+  const identifier source,
+  const identifier state_tag,
+  const identifier begin_tag,
+  const identifier end_tag) noexcept {
+    try {
+        const auto now{std::chrono::steady_clock::now()};
+        const std::lock_guard<Lockable> lock{_lockable};
+        _begin_entry(log_binary_entry::declare_state);
+        _add(now);
+        _add(source);
+        _add(state_tag);
+        _add(begin_tag);
+        _add(end_tag);
+        _finish_entry();
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::active_state(
+  const identifier source,
+  const identifier state_tag) noexcept {
+    try {
+        const auto now{std::chrono::steady_clock::now()};
+        const std::lock_guard<Lockable> lock{_lockable};
+        _begin_entry(log_binary_entry::active_state);
+        _add(now);
+        _add(source);
+        _add(state_tag);
+        _finish_entry();
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+auto binary_log_backend<Lockable>::begin_message(
+  const identifier source,
+  const identifier tag,
+  const logger_instance_id instance,
+  const log_event_severity severity,
+  const string_view format) noexcept -> bool {
+    try {
+        const auto now{std::chrono::steady_clock::now()};
+        _lockable.lock();
+        _begin_entry(log_binary_entry::message);
+        _add(severity);
+        _add(source);
+        _add(tag);
+        _add(std::uint64_t(instance));
+        _add(now);
+        _add(format);
+    } catch(...) {
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::add_nothing(
+  const identifier arg,
+  const identifier tag) noexcept {
+    try {
+        _add_arg(log_binary_arg::nothing, arg, tag);
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::add_identifier(
+  const identifier arg,
+  const identifier tag,
+  const identifier value) noexcept {
+    try {
+        _add_arg(log_binary_arg::identifier, arg, tag);
+        _add(value);
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::add_message_id(
+  const identifier arg,
+  const identifier tag,
+  const message_id value) noexcept {
+    try {
+        _add_arg(log_binary_arg::message_id, arg, tag);
+        _add(value.class_id());
+        _add(value.method_id());
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::add_bool(
+  const identifier arg,
+  const identifier tag,
+  const bool value) noexcept {
+    try {
+        _add_arg(log_binary_arg::boolean, arg, tag);
+        _add(value);
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::add_integer(
+  const identifier arg,
+  const identifier tag,
+  const std::intmax_t value) noexcept {
+    try {
+        _add_arg(log_binary_arg::integer, arg, tag);
+        _add(std::int64_t(value));
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::add_unsigned(
+  const identifier arg,
+  const identifier tag,
+  const std::uintmax_t value) noexcept {
+    try {
+        _add_arg(log_binary_arg::unsigned_integer, arg, tag);
+        _add(std::uint64_t(value));
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::add_float(
+  const identifier arg,
+  const identifier tag,
+  const float value) noexcept {
+    try {
+        _add_arg(log_binary_arg::floating, arg, tag);
+        _add(value);
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::add_float(
+  const identifier arg,
+  const identifier tag,
+  const float min,
+  const float value,
+  const float max) noexcept {
+    try {
+        _add_arg(log_binary_arg::float_range, arg, tag);
+        _add(min);
+        _add(value);
+        _add(max);
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::add_duration(
+  const identifier arg,
+  const identifier tag,
+  const std::chrono::duration<float> value) noexcept {
+    try {
+        _add_arg(log_binary_arg::duration, arg, tag);
+        _add(value.count());
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::add_string(
+  const identifier arg,
+  const identifier tag,
+  const string_view value) noexcept {
+    try {
+        _add_arg(log_binary_arg::string, arg, tag);
+        _add(value);
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::add_blob(
+  const identifier arg,
+  const identifier tag,
+  const memory::const_block value) noexcept {
+    try {
+        _add_arg(log_binary_arg::blob, arg, tag);
+        _add(value);
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::finish_message() noexcept {
+    _finish_entry();
+    _lockable.unlock();
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::log_chart_sample(
+  const identifier source,
+  const logger_instance_id instance,
+  const identifier series,
+  const float value) noexcept {
+    try {
+        const auto now{std::chrono::steady_clock::now()};
+        if(_charts.is_enabled()) {
+            std::optional<log_chart_window> window;
+            {
+                const std::lock_guard lock{_registry_lockable};
+                window = _charts.add(source, instance, series, value, now);
+            }
+            if(window) {
+                _write_chart(*window);
+            }
+        } else {
+            _write_chart(
+              {.source = source,
+               .instance = instance,
+               .series = series,
+               .time = now,
+               .count = 1U,
+               .min = value,
+               .max = value,
+               .mean = value});
+        }
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::_write_chart(
+  const log_chart_window& window) noexcept {
+    try {
+        const std::lock_guard<Lockable> lock{_lockable};
+        _begin_entry(log_binary_entry::chart_sample);
+        _add(window.time);
+        _add(window.source);
+        _add(std::uint64_t(window.instance));
+        _add(window.series);
+        _add(window.mean);
+        if(window.count != 1U) {
+            _add(std::uint64_t(window.count));
+            _add(window.min);
+            _add(window.max);
+        }
+        _finish_entry();
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::heartbeat() noexcept {
+    try {
+        const auto now{std::chrono::steady_clock::now()};
+        if(_charts.is_enabled()) {
+            // windows of series without recent samples
+            const std::lock_guard lock{_registry_lockable};
+            for(const auto& window : _charts.flush_expired(now)) {
+                _write_chart(window);
+            }
+        }
+        const std::lock_guard<Lockable> lock{_lockable};
+        _begin_entry(log_binary_entry::heartbeat);
+        _add(now);
+        _finish_entry();
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void binary_log_backend<Lockable>::finish_log() noexcept {
+    try {
+        {
+            const std::lock_guard lock{_registry_lockable};
+            for(auto& entry : _intervals) {
+                _report_interval(entry.second);
+            }
+            for(const auto& window : _charts.flush()) {
+                _write_chart(window);
+            }
+        }
+        const auto now{std::chrono::steady_clock::now()};
+        const std::lock_guard<Lockable> lock{_lockable};
+        _begin_entry(log_binary_entry::finish);
+        _add(now);
+        _finish_entry();
+        _output->finish_stream(memory::const_block{});
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+// factory
+//------------------------------------------------------------------------------
+auto make_binary_log_backend(
+  const log_stream_info& info,
+  shared_holder<log_output_stream> out,
+  const log_backend_lock lock_type) -> unique_holder<logger_backend> {
+    switch(lock_type) {
+        case log_backend_lock::none:
+            return {hold<binary_log_backend<no_lock>>, info, std::move(out)};
+        case log_backend_lock::mutex:
+            return {hold<binary_log_backend<std::mutex>>, info, std::move(out)};
+        case log_backend_lock::spinlock:
+            return {hold<binary_log_backend<spinlock>>, info, std::move(out)};
+        case log_backend_lock::async:
+            return {
+              hold<binary_log_backend<async_log_lock>>,
+              info,
+              make_async_output_stream(std::move(out), info)};
+    }
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
@@ -0,0 +1,96 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+export module eagine.core.logging:chart_downsampler;
+
+import std;
+import eagine.core.types;
+import eagine.core.identifier;
+import :backend;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+/// @brief Aggregated chart samples of a single series from a time window.
+/// @ingroup logging
+/// @see log_chart_downsampler
+export struct log_chart_window {
+    /// @brief The identifier of the source logger object.
+    identifier source;
+    /// @brief Unique instance id of the source logger object.
+    logger_instance_id instance{0U};
+    /// @brief The identifier of the chart data series.
+    identifier series;
+    /// @brief The time of the last sample in the window.
+    std::chrono::steady_clock::time_point time{};
+    /// @brief The number of samples in the window.
+    std::uint64_t count{0U};
+    /// @brief The minimum of the sample values.
+    float min{0.F};
+    /// @brief The maximum of the sample values.
+    float max{0.F};
+    /// @brief The mean of the sample values.
+    float mean{0.F};
+};
+//------------------------------------------------------------------------------
+/// @brief Aggregates high-frequency chart samples into per-series windows.
+/// @ingroup logging
+/// @note Not thread-safe, the logger backends synchronize the access.
+///
+/// Each series has its own window starting with its first sample. When
+/// a sample arrives after the window elapsed, the aggregated window is
+/// returned and a new window is started with that sample. The windows of
+/// series that went quiet are returned by flush_expired.
+export class log_chart_downsampler {
+public:
+    /// @brief Constructs the downsampler with the specified window length.
+    /// @see is_enabled
+    log_chart_downsampler(std::chrono::steady_clock::duration window) noexcept
+      : _window{window} {}
+
+    /// @brief Indicates if the samples should be downsampled.
+    auto is_enabled() const noexcept -> bool {
+        return _window > std::chrono::steady_clock::duration::zero();
+    }
+
+    /// @brief Adds a sample, returns the previous window of the series if done.
+    auto add(
+      const identifier source,
+      const logger_instance_id instance,
+      const identifier series,
+      const float value,
+      const std::chrono::steady_clock::time_point now)
+      -> std::optional<log_chart_window>;
+
+    /// @brief Returns the pending windows that elapsed and removes them.
+    /// @see flush
+    ///
+    /// Should be called periodically, so that the last windows of series
+    /// without new samples are not held back and their state is released.
+    auto flush_expired(const std::chrono::steady_clock::time_point now)
+      -> std::vector<log_chart_window>;
+
+    /// @brief Returns all pending windows and removes them.
+    /// @see flush_expired
+    auto flush() -> std::vector<log_chart_window>;
+
+private:
+    struct _series_window {
+        std::chrono::steady_clock::time_point start{};
+        log_chart_window window{};
+        double sum{0.0};
+    };
+
+    static auto _finish(_series_window&) noexcept -> log_chart_window;
+
+    const std::chrono::steady_clock::duration _window;
+    std::map<
+      std::tuple<identifier_t, logger_instance_id, identifier_t>,
+      _series_window>
+      _series;
+};
+//------------------------------------------------------------------------------
+} // namespace eagine
@@ -0,0 +1,84 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module eagine.core.logging;
+
+import std;
+import eagine.core.types;
+import eagine.core.identifier;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+auto log_chart_downsampler::_finish(_series_window& s) noexcept
+  -> log_chart_window {
+    auto result{s.window};
+    result.mean = float(s.sum / double(result.count));
+    s.window.count = 0U;
+    s.sum = 0.0;
+    return result;
+}
+//------------------------------------------------------------------------------
+auto log_chart_downsampler::add(
+  const identifier source,
+  const logger_instance_id instance,
+  const identifier series,
+  const float value,
+  const std::chrono::steady_clock::time_point now)
+  -> std::optional<log_chart_window> {
+    std::optional<log_chart_window> result;
+    auto& s{_series[std::make_tuple(source.value(), instance, series.value())]};
+    if((s.window.count > 0U) and (now - s.start >= _window)) {
+        result = _finish(s);
+    }
+    if(s.window.count == 0U) {
+        s.start = now;
+        s.window.source = source;
+        s.window.instance = instance;
+        s.window.series = series;
+        s.window.min = value;
+        s.window.max = value;
+    } else {
+        s.window.min = std::min(s.window.min, value);
+        s.window.max = std::max(s.window.max, value);
+    }
+    s.window.time = now;
+    s.sum += value;
+    ++s.window.count;
+    return result;
+}
+//------------------------------------------------------------------------------
+auto log_chart_downsampler::flush_expired(
+  const std::chrono::steady_clock::time_point now)
+  -> std::vector<log_chart_window> {
+    std::vector<log_chart_window> result;
+    auto pos{_series.begin()};
+    while(pos != _series.end()) {
+        if(now - pos->second.start >= _window) {
+            if(pos->second.window.count > 0U) {
+                result.push_back(_finish(pos->second));
+            }
+            // the next sample of the series starts a new entry
+            pos = _series.erase(pos);
+        } else {
+            ++pos;
+        }
+    }
+    return result;
+}
+//------------------------------------------------------------------------------
+auto log_chart_downsampler::flush() -> std::vector<log_chart_window> {
+    std::vector<log_chart_window> result;
+    for(auto& entry : _series) {
+        if(entry.second.window.count > 0U) {
+            result.push_back(_finish(entry.second));
+        }
+    }
+    _series.clear();
+    return result;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
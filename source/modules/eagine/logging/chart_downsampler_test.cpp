@@ -0,0 +1,98 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin.hpp>
+import std;
+import eagine.core.identifier;
+import eagine.core.logging;
+//------------------------------------------------------------------------------
+void chart_downsampler_disabled(auto& s) {
+    eagitest::case_ test{s, 1, "disabled"};
+
+    eagine::log_chart_downsampler charts{std::chrono::seconds{0}};
+    test.check(not charts.is_enabled(), "is not enabled");
+    test.check(charts.flush().empty(), "nothing pending");
+}
+//------------------------------------------------------------------------------
+void chart_downsampler_window(auto& s) {
+    eagitest::case_ test{s, 2, "window"};
+
+    using namespace std::chrono_literals;
+    const eagine::identifier src{"source"};
+    const eagine::identifier ser{"series"};
+    const auto t0{std::chrono::steady_clock::now()};
+
+    eagine::log_chart_downsampler charts{1s};
+    test.check(charts.is_enabled(), "is enabled");
+
+    for(int i = 0; i < 100; ++i) {
+        const auto window{charts.add(
+          src, 1U, ser, float(i), t0 + std::chrono::milliseconds{i})};
+        test.check(not window.has_value(), "window in progress");
+    }
+
+    const auto window{charts.add(src, 1U, ser, 1000.F, t0 + 1s)};
+    test.ensure(window.has_value(), "window done");
+    test.check(window->source == src, "source");
+    test.check(window->series == ser, "series");
+    test.check_equal(window->instance, 1U, "instance");
+    test.check_equal(window->count, 100U, "count");
+    test.check_equal(window->min, 0.F, "min");
+    test.check_equal(window->max, 99.F, "max");
+    test.check_equal(window->mean, 49.5F, "mean");
+
+    const auto other{charts.add(src, 2U, ser, 5.F, t0 + 1s)};
+    test.check(not other.has_value(), "separate instance");
+
+    const auto pending{charts.flush()};
+    test.check_equal(pending.size(), 2U, "pending");
+    for(const auto& p : pending) {
+        test.check_equal(p.count, 1U, "pending count");
+        test.check_equal(p.min, p.max, "pending min max");
+    }
+    test.check(charts.flush().empty(), "flushed");
+}
+//------------------------------------------------------------------------------
+void chart_downsampler_expired(auto& s) {
+    eagitest::case_ test{s, 3, "expired"};
+
+    using namespace std::chrono_literals;
+    const eagine::identifier src{"source"};
+    const eagine::identifier ser{"series"};
+    const auto t0{std::chrono::steady_clock::now()};
+
+    eagine::log_chart_downsampler charts{1s};
+    charts.add(src, 1U, ser, 1.F, t0);
+    charts.add(src, 1U, ser, 3.F, t0 + 100ms);
+    charts.add(src, 2U, ser, 5.F, t0 + 600ms);
+
+    test.check(charts.flush_expired(t0 + 500ms).empty(), "none expired");
+
+    const auto expired{charts.flush_expired(t0 + 1s)};
+    test.ensure(expired.size() == 1U, "one expired");
+    test.check_equal(expired.front().instance, 1U, "instance");
+    test.check_equal(expired.front().count, 2U, "count");
+    test.check_equal(expired.front().mean, 2.F, "mean");
+
+    const auto other{charts.add(src, 1U, ser, 7.F, t0 + 1100ms)};
+    test.check(not other.has_value(), "new window");
+
+    const auto later{charts.flush_expired(t0 + 3s)};
+    test.check_equal(later.size(), 2U, "all expired");
+    test.check(charts.flush().empty(), "removed");
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagitest::suite test{argc, argv, "chart_downsampler", 3};
+    test.once(chart_downsampler_disabled);
+    test.once(chart_downsampler_window);
+    test.once(chart_downsampler_expired);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end.hpp>
@@ -14,7 +14,9 @@ import eagine.core.identifier;
 import eagine.core.valid_if;
 import eagine.core.utility;
 import :entry_arg;
+import :entry_arg_buffer;
 import :backend;
+import :rate_limiter;
 
 namespace eagine {
 //------------------------------------------------------------------------------
@@ -49,17 +51,15 @@ public:
       const logger_instance_id instance_id,
       const log_event_severity severity,
       const string_view format,
-      logger_backend* backend) noexcept
+      logger_backend* backend,
+      log_rate_limiter* rate_limiter = nullptr) noexcept
       : _backend{backend}
+      , _rate_limiter{rate_limiter}
       , _source_id{source_id}
       , _instance_id{instance_id}
       , _format{format}
       , _args{_be_alloc(_backend)}
-      , _severity{severity} {
-        if(_backend) {
-            _args.reserve(16);
-        }
-    }
+      , _severity{severity} {}
 
     /// @brief Not moveable.
     log_entry(log_entry&&) = delete;
@@ -76,6 +76,7 @@ public:
             if(_backend->begin_message(
                  _source_id, _entry_tag, _instance_id, _severity, _format))
               [[likely]] {
+                _records.replay(*_backend);
                 _args(*_backend);
                 _backend->finish_message();
             }
@@ -90,8 +91,11 @@ public:
       const identifier tag,
       const nothing_t) noexcept -> auto& {
         if(_backend) {
-            _args.add(
-              [=](logger_backend& backend) { backend.add_nothing(name, tag); });
+            if(not _records.add_nothing(name, tag)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_nothing(name, tag);
+                });
+            }
         }
         return *this;
     }
@@ -109,9 +113,11 @@ public:
       const identifier tag,
       const identifier value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_identifier(name, tag, value);
-            });
+            if(not _records.add_identifier(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_identifier(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -130,9 +136,12 @@ public:
     template <identifier_t Tag>
     auto arg(const identifier name, const tagged_id<Tag> id) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_unsigned(name, identifier{Tag}, id.value());
-            });
+            if(not _records.add_unsigned(name, identifier{Tag}, id.value()))
+              [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_unsigned(name, identifier{Tag}, id.value());
+                });
+            }
         }
         return *this;
     }
@@ -146,9 +155,11 @@ public:
       const identifier tag,
       const message_id value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_message_id(name, tag, value);
-            });
+            if(not _records.add_message_id(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_message_id(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -169,9 +180,11 @@ public:
       const identifier tag,
       const bool value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_bool(name, tag, value);
-            });
+            if(not _records.add_bool(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_bool(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -192,9 +205,11 @@ public:
       const identifier tag,
       const std::int64_t value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_integer(name, tag, value);
-            });
+            if(not _records.add_integer(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_integer(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -215,11 +230,13 @@ public:
       const identifier tag,
       const span<const std::int64_t> values) noexcept -> log_entry& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                for(const auto value : values) {
-                    backend.add_integer(name, tag, value);
-                }
-            });
+            if(not _records.add_integers(name, tag, values)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    for(const auto value : values) {
+                        backend.add_integer(name, tag, value);
+                    }
+                });
+            }
         }
         return *this;
     }
@@ -241,9 +258,11 @@ public:
       const identifier tag,
       const std::int32_t value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_integer(name, tag, value);
-            });
+            if(not _records.add_integer(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_integer(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -264,11 +283,13 @@ public:
       const identifier tag,
       const span<const std::int32_t> values) noexcept -> log_entry& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                for(const auto value : values) {
-                    backend.add_integer(name, tag, value);
-                }
-            });
+            if(not _records.add_integers(name, tag, values)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    for(const auto value : values) {
+                        backend.add_integer(name, tag, value);
+                    }
+                });
+            }
         }
         return *this;
     }
@@ -290,9 +311,11 @@ public:
       const identifier tag,
       const std::int16_t value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_integer(name, tag, value);
-            });
+            if(not _records.add_integer(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_integer(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -313,11 +336,13 @@ public:
       const identifier tag,
       const span<const std::int16_t> values) noexcept -> log_entry& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                for(const auto value : values) {
-                    backend.add_integer(name, tag, value);
-                }
-            });
+            if(not _records.add_integers(name, tag, values)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    for(const auto value : values) {
+                        backend.add_integer(name, tag, value);
+                    }
+                });
+            }
         }
         return *this;
     }
@@ -339,9 +364,11 @@ public:
       const identifier tag,
       const std::uint64_t value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_unsigned(name, tag, value);
-            });
+            if(not _records.add_unsigned(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_unsigned(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -362,11 +389,13 @@ public:
       const identifier tag,
       const span<const std::uint64_t> values) noexcept -> log_entry& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                for(const auto value : values) {
-                    backend.add_unsigned(name, tag, value);
-                }
-            });
+            if(not _records.add_integers(name, tag, values)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    for(const auto value : values) {
+                        backend.add_unsigned(name, tag, value);
+                    }
+                });
+            }
         }
         return *this;
     }
@@ -388,9 +417,11 @@ public:
       const identifier tag,
       const std::uint32_t value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_unsigned(name, tag, value);
-            });
+            if(not _records.add_unsigned(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_unsigned(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -411,11 +442,13 @@ public:
       const identifier tag,
       const span<const std::uint32_t> values) noexcept -> log_entry& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                for(const auto value : values) {
-                    backend.add_unsigned(name, tag, value);
-                }
-            });
+            if(not _records.add_integers(name, tag, values)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    for(const auto value : values) {
+                        backend.add_unsigned(name, tag, value);
+                    }
+                });
+            }
         }
         return *this;
     }
@@ -437,9 +470,11 @@ public:
       const identifier tag,
       const std::uint16_t value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_unsigned(name, tag, value);
-            });
+            if(not _records.add_unsigned(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_unsigned(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -460,11 +495,13 @@ public:
       const identifier tag,
       const span<const std::uint16_t> values) noexcept -> log_entry& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                for(const auto value : values) {
-                    backend.add_unsigned(name, tag, value);
-                }
-            });
+            if(not _records.add_integers(name, tag, values)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    for(const auto value : values) {
+                        backend.add_unsigned(name, tag, value);
+                    }
+                });
+            }
         }
         return *this;
     }
@@ -486,9 +523,11 @@ public:
       const identifier tag,
       const float value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_float(name, tag, value);
-            });
+            if(not _records.add_float(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_float(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -514,9 +553,11 @@ public:
       const identifier tag,
       const span<const float> values) noexcept -> log_entry& {
         if(_backend) {
-            for(const auto value : values) {
+            if(not _records.add_floats(name, tag, values)) [[unlikely]] {
                 _args.add([=](logger_backend& backend) {
-                    backend.add_float(name, tag, value);
+                    for(const auto value : values) {
+                        backend.add_float(name, tag, value);
+                    }
                 });
             }
         }
@@ -541,9 +582,12 @@ public:
       const float value,
       const float max) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_float(name, tag, min, value, max);
-            });
+            if(not _records.add_float(name, tag, min, value, max))
+              [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_float(name, tag, min, value, max);
+                });
+            }
         }
         return *this;
     }
@@ -569,13 +613,13 @@ public:
       const identifier tag,
       const std::chrono::duration<R, P> value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_duration(
-                  name,
-                  tag,
-                  std::chrono::duration_cast<std::chrono::duration<float>>(
-                    value));
-            });
+            const auto dur{
+              std::chrono::duration_cast<std::chrono::duration<float>>(value)};
+            if(not _records.add_duration(name, tag, dur)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_duration(name, tag, dur);
+                });
+            }
         }
         return *this;
     }
@@ -599,9 +643,11 @@ public:
       const identifier tag,
       const string_view value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_string(name, tag, value);
-            });
+            if(not _records.add_string(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_string(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -642,9 +688,11 @@ public:
       const identifier tag,
       const std::string& value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_string(name, tag, value);
-            });
+            if(not _records.add_string_copy(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_string(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -666,9 +714,11 @@ public:
       const identifier tag,
       const memory::const_block value) noexcept -> auto& {
         if(_backend) {
-            _args.add([=](logger_backend& backend) {
-                backend.add_blob(name, tag, value);
-            });
+            if(not _records.add_blob(name, tag, value)) [[unlikely]] {
+                _args.add([=](logger_backend& backend) {
+                    backend.add_blob(name, tag, value);
+                });
+            }
         }
         return *this;
     }
@@ -685,7 +735,9 @@ public:
     template <typename Func>
     auto arg_func(Func function) -> auto& {
         if(_backend) {
-            _args.add(std::move(function));
+            if(not _records.add_callable(function)) {
+                _args.add(std::move(function));
+            }
         }
         return *this;
     }
@@ -775,17 +827,27 @@ public:
     }
 
     /// @brief Adds an optional tag to this log entry.
+    /// @note The tag-specific rate limits are checked here, so the tag
+    ///       should be set before the arguments are added.
     auto tag(const identifier entry_tag) noexcept -> auto& {
         _entry_tag = entry_tag;
+        if(_rate_limiter and _backend) [[unlikely]] {
+            if(not _rate_limiter->should_log(
+                 _source_id, entry_tag, _severity)) {
+                _backend = nullptr;
+            }
+        }
         return *this;
     }
 
 private:
-    logger_backend* const _backend{nullptr};
+    logger_backend* _backend{nullptr};
+    log_rate_limiter* const _rate_limiter{nullptr};
     const identifier _source_id{};
     identifier _entry_tag{};
     const logger_instance_id _instance_id{};
     const string_view _format{};
+    log_entry_arg_buffer _records;
     memory::callable_storage<void(logger_backend&)> _args;
     const log_event_severity _severity{log_event_severity::info};
 
@@ -0,0 +1,370 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+export module eagine.core.logging:entry_arg_buffer;
+
+import std;
+import eagine.core.types;
+import eagine.core.memory;
+import eagine.core.identifier;
+import :backend;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+/// @brief Enumeration of log entry argument record kinds.
+/// @ingroup logging
+/// @see log_entry_arg_record
+export enum class log_entry_arg_kind : std::uint8_t {
+    nothing,
+    identifier,
+    message_id,
+    boolean,
+    integer,
+    unsigned_integer,
+    real,
+    real_range,
+    duration,
+    string,
+    blob,
+    int64_span,
+    int32_span,
+    int16_span,
+    uint64_span,
+    uint32_span,
+    uint16_span,
+    real_span,
+    callable
+};
+//------------------------------------------------------------------------------
+/// @brief Compact type-tagged record of a single log entry argument.
+/// @ingroup logging
+/// @see log_entry_arg_buffer
+///
+/// Scalar values are stored inline, strings, BLOBs and spans are stored as
+/// pointer and size and small trivially-copyable adapter functions are stored
+/// inline together with a pointer to a function invoking them.
+export struct log_entry_arg_record {
+    static constexpr const std::size_t callable_size{24U};
+
+    struct sequence {
+        const void* data;
+        span_size_t size;
+    };
+
+    struct callable {
+        void (*invoke)(const void*, logger_backend&) noexcept;
+        alignas(std::uint64_t) std::byte storage[callable_size];
+    };
+
+    union payload {
+        identifier_t id;
+        identifier_t ids[2];
+        bool flag;
+        std::int64_t integer;
+        std::uint64_t unsigned_integer;
+        float real;
+        float reals[3];
+        sequence seq;
+        callable func;
+    };
+
+    identifier_t name;
+    identifier_t tag;
+    payload value;
+    log_entry_arg_kind kind;
+
+    /// @brief Passes the argument stored in this record to a backend.
+    void replay(logger_backend& backend) const noexcept;
+};
+//------------------------------------------------------------------------------
+/// @brief Fixed-size in-place buffer of log entry argument records.
+/// @ingroup logging
+/// @see log_entry_arg_record
+///
+/// The add functions return false if the argument could not be stored in
+/// the buffer, either because it is full or because the argument does not
+/// fit. After the first such failure, all subsequent additions fail as well,
+/// so that arguments stored elsewhere by the caller keep their order.
+export class log_entry_arg_buffer {
+public:
+    /// @brief The maximum number of argument records.
+    static constexpr const span_size_t max_count{32};
+    /// @brief The size of the storage for copied string values.
+    static constexpr const span_size_t text_size{256};
+
+    /// @brief Returns the number of stored argument records.
+    auto size() const noexcept -> span_size_t {
+        return _count;
+    }
+
+    /// @brief Indicates that an argument could not be stored in this buffer.
+    auto is_spilled() const noexcept -> bool {
+        return _spilled;
+    }
+
+    auto add_nothing(const identifier name, const identifier tag) noexcept
+      -> bool {
+        return _add(name, tag, log_entry_arg_kind::nothing, [](auto&) {});
+    }
+
+    auto add_identifier(
+      const identifier name,
+      const identifier tag,
+      const identifier value) noexcept -> bool {
+        return _add(name, tag, log_entry_arg_kind::identifier, [=](auto& v) {
+            v.id = value.value();
+        });
+    }
+
+    auto add_message_id(
+      const identifier name,
+      const identifier tag,
+      const message_id value) noexcept -> bool {
+        return _add(name, tag, log_entry_arg_kind::message_id, [=](auto& v) {
+            v.ids[0] = value.class_id();
+            v.ids[1] = value.method_id();
+        });
+    }
+
+    auto add_bool(
+      const identifier name,
+      const identifier tag,
+      const bool value) noexcept -> bool {
+        return _add(name, tag, log_entry_arg_kind::boolean, [=](auto& v) {
+            v.flag = value;
+        });
+    }
+
+    auto add_integer(
+      const identifier name,
+      const identifier tag,
+      const std::int64_t value) noexcept -> bool {
+        return _add(name, tag, log_entry_arg_kind::integer, [=](auto& v) {
+            v.integer = value;
+        });
+    }
+
+    auto add_unsigned(
+      const identifier name,
+      const identifier tag,
+      const std::uint64_t value) noexcept -> bool {
+        return _add(
+          name, tag, log_entry_arg_kind::unsigned_integer, [=](auto& v) {
+              v.unsigned_integer = value;
+          });
+    }
+
+    auto add_float(
+      const identifier name,
+      const identifier tag,
+      const float value) noexcept -> bool {
+        return _add(name, tag, log_entry_arg_kind::real, [=](auto& v) {
+            v.real = value;
+        });
+    }
+
+    auto add_float(
+      const identifier name,
+      const identifier tag,
+      const float min,
+      const float value,
+      const float max) noexcept -> bool {
+        return _add(name, tag, log_entry_arg_kind::real_range, [=](auto& v) {
+            v.reals[0] = min;
+            v.reals[1] = value;
+            v.reals[2] = max;
+        });
+    }
+
+    auto add_duration(
+      const identifier name,
+      const identifier tag,
+      const std::chrono::duration<float> value) noexcept -> bool {
+        return _add(name, tag, log_entry_arg_kind::duration, [=](auto& v) {
+            v.real = value.count();
+        });
+    }
+
+    /// @brief Adds a string argument, referencing the value.
+    auto add_string(
+      const identifier name,
+      const identifier tag,
+      const string_view value) noexcept -> bool {
+        return _add_sequence(
+          name, tag, log_entry_arg_kind::string, value.data(), value.size());
+    }
+
+    /// @brief Adds a string argument, copying the value into this buffer.
+    auto add_string_copy(
+      const identifier name,
+      const identifier tag,
+      const string_view value) noexcept -> bool;
+
+    auto add_blob(
+      const identifier name,
+      const identifier tag,
+      const memory::const_block value) noexcept -> bool {
+        return _add_sequence(
+          name, tag, log_entry_arg_kind::blob, value.data(), value.size());
+    }
+
+    auto add_integers(
+      const identifier name,
+      const identifier tag,
+      const span<const std::int64_t> values) noexcept -> bool {
+        return _add_sequence(
+          name,
+          tag,
+          log_entry_arg_kind::int64_span,
+          values.data(),
+          values.size());
+    }
+
+    auto add_integers(
+      const identifier name,
+      const identifier tag,
+      const span<const std::int32_t> values) noexcept -> bool {
+        return _add_sequence(
+          name,
+          tag,
+          log_entry_arg_kind::int32_span,
+          values.data(),
+          values.size());
+    }
+
+    auto add_integers(
+      const identifier name,
+      const identifier tag,
+      const span<const std::int16_t> values) noexcept -> bool {
+        return _add_sequence(
+          name,
+          tag,
+          log_entry_arg_kind::int16_span,
+          values.data(),
+          values.size());
+    }
+
+    auto add_integers(
+      const identifier name,
+      const identifier tag,
+      const span<const std::uint64_t> values) noexcept -> bool {
+        return _add_sequence(
+          name,
+          tag,
+          log_entry_arg_kind::uint64_span,
+          values.data(),
+          values.size());
+    }
+
+    auto add_integers(
+      const identifier name,
+      const identifier tag,
+      const span<const std::uint32_t> values) noexcept -> bool {
+        return _add_sequence(
+          name,
+          tag,
+          log_entry_arg_kind::uint32_span,
+          values.data(),
+          values.size());
+    }
+
+    auto add_integers(
+      const identifier name,
+      const identifier tag,
+      const span<const std::uint16_t> values) noexcept -> bool {
+        return _add_sequence(
+          name,
+          tag,
+          log_entry_arg_kind::uint16_span,
+          values.data(),
+          values.size());
+    }
+
+    auto add_floats(
+      const identifier name,
+      const identifier tag,
+      const span<const float> values) noexcept -> bool {
+        return _add_sequence(
+          name,
+          tag,
+          log_entry_arg_kind::real_span,
+          values.data(),
+          values.size());
+    }
+
+    /// @brief Adds an adapter function if it is small and trivially copyable.
+    template <typename Func>
+    auto add_callable(const Func& function) noexcept -> bool {
+        if constexpr(
+          std::is_trivially_copyable_v<Func> and
+          std::is_invocable_v<const Func&, logger_backend&> and
+          (sizeof(Func) <= log_entry_arg_record::callable_size) and
+          (alignof(Func) <= alignof(std::uint64_t))) {
+            return _add({}, {}, log_entry_arg_kind::callable, [&](auto& v) {
+                v.func.invoke = &_invoke<Func>;
+                std::memcpy(
+                  static_cast<void*>(v.func.storage), &function, sizeof(Func));
+            });
+        } else {
+            _spilled = true;
+            return false;
+        }
+    }
+
+    /// @brief Passes the stored arguments to the specified backend, in order.
+    void replay(logger_backend& backend) const noexcept {
+        for(span_size_t i = 0; i < _count; ++i) {
+            _records[std_size(i)].replay(backend);
+        }
+    }
+
+private:
+    template <typename Func>
+    static void _invoke(const void* ptr, logger_backend& backend) noexcept {
+        std::array<std::byte, sizeof(Func)> bytes;
+        std::memcpy(bytes.data(), ptr, sizeof(Func));
+        std::bit_cast<Func>(bytes)(backend);
+    }
+
+    template <typename Init>
+    auto _add(
+      const identifier name,
+      const identifier tag,
+      const log_entry_arg_kind kind,
+      const Init& init) noexcept -> bool {
+        if(_spilled or (_count >= max_count)) [[unlikely]] {
+            _spilled = true;
+            return false;
+        }
+        auto& record{_records[std_size(_count++)]};
+        record.name = name.value();
+        record.tag = tag.value();
+        record.kind = kind;
+        init(record.value);
+        return true;
+    }
+
+    auto _add_sequence(
+      const identifier name,
+      const identifier tag,
+      const log_entry_arg_kind kind,
+      const void* data,
+      const span_size_t size) noexcept -> bool {
+        return _add(name, tag, kind, [=](auto& v) {
+            v.seq.data = data;
+            v.seq.size = size;
+        });
+    }
+
+    std::array<log_entry_arg_record, std_size(max_count)> _records;
+    std::array<char, std_size(text_size)> _text;
+    span_size_t _count{0};
+    span_size_t _text_used{0};
+    bool _spilled{false};
+};
+//------------------------------------------------------------------------------
+} // namespace eagine
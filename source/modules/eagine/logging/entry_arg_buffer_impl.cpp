@@ -0,0 +1,130 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module eagine.core.logging;
+
+import std;
+import eagine.core.types;
+import eagine.core.memory;
+import eagine.core.identifier;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+template <typename T>
+static void log_entry_replay_integers(
+  logger_backend& backend,
+  const identifier name,
+  const identifier tag,
+  const log_entry_arg_record::sequence seq) noexcept {
+    for(const auto value :
+        span<const T>{static_cast<const T*>(seq.data), seq.size}) {
+        if constexpr(std::is_signed_v<T>) {
+            backend.add_integer(name, tag, value);
+        } else {
+            backend.add_unsigned(name, tag, value);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void log_entry_arg_record::replay(logger_backend& backend) const noexcept {
+    const identifier n{name};
+    const identifier t{tag};
+    switch(kind) {
+        case log_entry_arg_kind::nothing:
+            backend.add_nothing(n, t);
+            break;
+        case log_entry_arg_kind::identifier:
+            backend.add_identifier(n, t, identifier{value.id});
+            break;
+        case log_entry_arg_kind::message_id:
+            backend.add_message_id(
+              n, t, message_id{value.ids[0], value.ids[1]});
+            break;
+        case log_entry_arg_kind::boolean:
+            backend.add_bool(n, t, value.flag);
+            break;
+        case log_entry_arg_kind::integer:
+            backend.add_integer(n, t, value.integer);
+            break;
+        case log_entry_arg_kind::unsigned_integer:
+            backend.add_unsigned(n, t, value.unsigned_integer);
+            break;
+        case log_entry_arg_kind::real:
+            backend.add_float(n, t, value.real);
+            break;
+        case log_entry_arg_kind::real_range:
+            backend.add_float(
+              n, t, value.reals[0], value.reals[1], value.reals[2]);
+            break;
+        case log_entry_arg_kind::duration:
+            backend.add_duration(
+              n, t, std::chrono::duration<float>{value.real});
+            break;
+        case log_entry_arg_kind::string:
+            backend.add_string(
+              n,
+              t,
+              string_view{
+                static_cast<const char*>(value.seq.data), value.seq.size});
+            break;
+        case log_entry_arg_kind::blob:
+            backend.add_blob(
+              n,
+              t,
+              memory::const_block{
+                static_cast<const byte*>(value.seq.data), value.seq.size});
+            break;
+        case log_entry_arg_kind::int64_span:
+            log_entry_replay_integers<std::int64_t>(backend, n, t, value.seq);
+            break;
+        case log_entry_arg_kind::int32_span:
+            log_entry_replay_integers<std::int32_t>(backend, n, t, value.seq);
+            break;
+        case log_entry_arg_kind::int16_span:
+            log_entry_replay_integers<std::int16_t>(backend, n, t, value.seq);
+            break;
+        case log_entry_arg_kind::uint64_span:
+            log_entry_replay_integers<std::uint64_t>(backend, n, t, value.seq);
+            break;
+        case log_entry_arg_kind::uint32_span:
+            log_entry_replay_integers<std::uint32_t>(backend, n, t, value.seq);
+            break;
+        case log_entry_arg_kind::uint16_span:
+            log_entry_replay_integers<std::uint16_t>(backend, n, t, value.seq);
+            break;
+        case log_entry_arg_kind::real_span:
+            for(const auto v : span<const float>{
+                  static_cast<const float*>(value.seq.data), value.seq.size}) {
+                backend.add_float(n, t, v);
+            }
+            break;
+        case log_entry_arg_kind::callable:
+            value.func.invoke(
+              static_cast<const void*>(value.func.storage), backend);
+            break;
+    }
+}
+//------------------------------------------------------------------------------
+auto log_entry_arg_buffer::add_string_copy(
+  const identifier name,
+  const identifier tag,
+  const string_view value) noexcept -> bool {
+    if(value.size() > text_size - _text_used) {
+        _spilled = true;
+        return false;
+    }
+    const auto dest{std::next(_text.data(), _text_used)};
+    if(_add_sequence(name, tag, log_entry_arg_kind::string, dest, value.size()))
+      [[likely]] {
+        std::copy(value.begin(), value.end(), dest);
+        _text_used += value.size();
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
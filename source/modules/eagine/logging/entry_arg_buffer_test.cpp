@@ -0,0 +1,81 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin.hpp>
+import std;
+import eagine.core.types;
+import eagine.core.identifier;
+import eagine.core.logging;
+//------------------------------------------------------------------------------
+void entry_arg_buffer_scalars(auto& s) {
+    eagitest::case_ test{s, 1, "scalars"};
+
+    eagine::log_entry_arg_buffer buffer;
+    test.check_equal(buffer.size(), 0, "empty");
+    test.check(not buffer.is_spilled(), "not spilled");
+
+    for(eagine::span_size_t i = 0; i < buffer.max_count; ++i) {
+        test.check(buffer.add_integer("arg", "int64", i), "added");
+    }
+    test.check_equal(buffer.size(), buffer.max_count, "full");
+    test.check(not buffer.is_spilled(), "not spilled yet");
+
+    test.check(not buffer.add_bool("arg", "bool", true), "not added");
+    test.check(buffer.is_spilled(), "spilled");
+    test.check_equal(buffer.size(), buffer.max_count, "still full");
+}
+//------------------------------------------------------------------------------
+void entry_arg_buffer_strings(auto& s) {
+    eagitest::case_ test{s, 2, "strings"};
+
+    eagine::log_entry_arg_buffer buffer;
+    const std::string str(std::size_t(buffer.text_size / 2), 'x');
+
+    test.check(buffer.add_string_copy("arg", "str", str), "1st copy");
+    test.check(buffer.add_string_copy("arg", "str", str), "2nd copy");
+    test.check(buffer.add_string("arg", "str", str), "reference");
+    test.check_equal(buffer.size(), 3, "three");
+
+    test.check(not buffer.add_string_copy("arg", "str", "y"), "no space");
+    test.check(buffer.is_spilled(), "spilled");
+    test.check(not buffer.add_float("arg", "real", 1.F), "keeps order");
+    test.check_equal(buffer.size(), 3, "still three");
+}
+//------------------------------------------------------------------------------
+void entry_arg_buffer_callable(auto& s) {
+    eagitest::case_ test{s, 3, "callable"};
+
+    eagine::log_entry_arg_buffer buffer;
+    const eagine::identifier name{"arg"};
+    const int value{42};
+
+    test.check(
+      buffer.add_callable([=](auto& backend) {
+          backend.add_integer(name, "int", value);
+      }),
+      "small trivial");
+    test.check_equal(buffer.size(), 1, "one");
+
+    const std::string str{"string"};
+    test.check(
+      not buffer.add_callable(
+        [=](auto& backend) { backend.add_string(name, "str", str); }),
+      "not trivial");
+    test.check(buffer.is_spilled(), "spilled");
+    test.check_equal(buffer.size(), 1, "still one");
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagitest::suite test{argc, argv, "entry_arg_buffer", 3};
+    test.once(entry_arg_buffer_scalars);
+    test.once(entry_arg_buffer_strings);
+    test.once(entry_arg_buffer_callable);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end.hpp>
@@ -19,12 +19,14 @@ auto make_asio_local_log_backend(
   const log_stream_info& info,
   const log_data_format format,
   const log_backend_lock lock_type) -> unique_holder<logger_backend> {
-    auto output{make_asio_local_output_stream(addr_str)};
+    auto output{make_asio_local_output_stream(addr_str, info)};
     switch(format) {
         case log_data_format::json:
             return make_json_log_backend(info, std::move(output), lock_type);
         case log_data_format::xml:
             return make_xml_log_backend(info, std::move(output), lock_type);
+        case log_data_format::binary:
+            return make_binary_log_backend(info, std::move(output), lock_type);
     }
 }
 //------------------------------------------------------------------------------
@@ -33,12 +35,14 @@ auto make_asio_tcpipv4_log_backend(
   const log_stream_info& info,
   const log_data_format format,
   const log_backend_lock lock_type) -> unique_holder<logger_backend> {
-    auto output{make_asio_tcpipv4_output_stream(addr_str)};
+    auto output{make_asio_tcpipv4_output_stream(addr_str, info)};
     switch(format) {
         case log_data_format::json:
             return make_json_log_backend(info, std::move(output), lock_type);
         case log_data_format::xml:
             return make_xml_log_backend(info, std::move(output), lock_type);
+        case log_data_format::binary:
+            return make_binary_log_backend(info, std::move(output), lock_type);
     }
 }
 //------------------------------------------------------------------------------
@@ -53,6 +57,8 @@ auto make_ostream_log_backend(
             return make_json_log_backend(info, std::move(output), lock_type);
         case log_data_format::xml:
             return make_xml_log_backend(info, std::move(output), lock_type);
+        case log_data_format::binary:
+            return make_binary_log_backend(info, std::move(output), lock_type);
     }
 }
 //------------------------------------------------------------------------------
@@ -0,0 +1,193 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+export module eagine.core.logging:interval_histogram;
+
+import std;
+import eagine.core.types;
+import eagine.core.identifier;
+import :backend;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+/// @brief Summary of time interval measurements from a reporting period.
+/// @ingroup logging
+/// @see log_interval_histogram
+export struct log_interval_summary {
+    /// @brief The number of measurements.
+    std::uint64_t count{0U};
+    /// @brief The average measured duration.
+    std::chrono::nanoseconds avg{0};
+    /// @brief The median of the measured durations.
+    std::chrono::nanoseconds p50{0};
+    /// @brief The 90-th percentile of the measured durations.
+    std::chrono::nanoseconds p90{0};
+    /// @brief The 99-th percentile of the measured durations.
+    std::chrono::nanoseconds p99{0};
+    /// @brief The maximum measured duration.
+    std::chrono::nanoseconds max{0};
+};
+//------------------------------------------------------------------------------
+/// @brief Log-linear histogram of time interval durations.
+/// @ingroup logging
+/// @see log_interval_statistics
+///
+/// Durations below 16ns have a bucket each, longer durations are split into
+/// power-of-two ranges with 16 linear sub-buckets, which keeps the relative
+/// error of the reported percentiles below 1/16.
+export class log_interval_histogram {
+public:
+    static constexpr const std::size_t sub_bucket_bits{4U};
+    static constexpr const std::size_t sub_bucket_count{1U << sub_bucket_bits};
+    /// @brief Durations longer than 2^max_exponent ns (~73 min) are clamped.
+    static constexpr const std::size_t max_exponent{42U};
+    static constexpr const std::size_t bucket_count{
+      (max_exponent - sub_bucket_bits + 2U) * sub_bucket_count};
+
+    /// @brief Returns the index of the bucket for a duration in nanoseconds.
+    static constexpr auto bucket_index(const std::uint64_t ns) noexcept
+      -> std::size_t {
+        if(ns < sub_bucket_count) {
+            return std::size_t(ns);
+        }
+        const auto exponent{std::size_t(std::bit_width(ns) - 1)};
+        if(exponent > max_exponent) {
+            return bucket_count - 1U;
+        }
+        const auto shift{exponent - sub_bucket_bits};
+        return (exponent - sub_bucket_bits + 1U) * sub_bucket_count +
+               std::size_t((ns >> shift) & (sub_bucket_count - 1U));
+    }
+
+    /// @brief Returns the representative duration in ns of a bucket.
+    static constexpr auto bucket_value(const std::size_t index) noexcept
+      -> std::uint64_t {
+        if(index < sub_bucket_count) {
+            return index;
+        }
+        const auto shift{index / sub_bucket_count - 1U};
+        const auto lower{
+          std::uint64_t(sub_bucket_count + index % sub_bucket_count) << shift};
+        return lower + ((std::uint64_t(1U) << shift) >> 1U);
+    }
+
+    /// @brief Adds the specified number of measurements of a duration.
+    void add(
+      const std::chrono::nanoseconds d,
+      const std::uint64_t n = 1U) noexcept {
+        using rep = std::chrono::nanoseconds::rep;
+        const auto ns{std::uint64_t(std::max(d.count(), rep(0)))};
+        add_bucket(bucket_index(ns), n);
+        update_totals(ns * n, ns);
+    }
+
+    /// @brief Adds the specified number of measurements to a bucket.
+    /// @see update_totals
+    void add_bucket(const std::size_t index, const std::uint64_t n) noexcept {
+        _buckets[index] += n;
+        _count += n;
+    }
+
+    /// @brief Updates the sum and maximum of the measured durations.
+    /// @see add_bucket
+    void update_totals(
+      const std::uint64_t sum,
+      const std::uint64_t max) noexcept {
+        _sum += sum;
+        _max = std::max(_max, max);
+    }
+
+    /// @brief Returns the number of measurements.
+    auto count() const noexcept -> std::uint64_t {
+        return _count;
+    }
+
+    /// @brief Returns the specified percentile (0.0 - 1.0) of the durations.
+    auto percentile(const float q) const noexcept -> std::chrono::nanoseconds;
+
+    /// @brief Returns the summary of the measurements.
+    auto summary() const noexcept -> log_interval_summary;
+
+    /// @brief Removes all measurements.
+    void reset() noexcept;
+
+private:
+    std::array<std::uint64_t, bucket_count> _buckets{};
+    std::uint64_t _count{0U};
+    std::uint64_t _sum{0U};
+    std::uint64_t _max{0U};
+};
+//------------------------------------------------------------------------------
+/// @brief Lock-free, per-thread sharded statistics of a time interval.
+/// @ingroup logging
+/// @see log_interval_histogram
+/// @note Used by the logger backends to implement time interval measurement.
+///
+/// The measurements are recorded with relaxed atomic increments into one of
+/// several shards, selected by the calling thread. The shards are merged and
+/// reset when the summary is drained.
+export class log_interval_statistics {
+public:
+    log_interval_statistics(
+      const identifier tag,
+      const logger_instance_id instance,
+      const std::chrono::steady_clock::duration period) noexcept;
+
+    log_interval_statistics(log_interval_statistics&&) = delete;
+    log_interval_statistics(const log_interval_statistics&) = delete;
+    auto operator=(log_interval_statistics&&) = delete;
+    auto operator=(const log_interval_statistics&) = delete;
+    ~log_interval_statistics() noexcept = default;
+
+    /// @brief Returns the tag identifying the time interval.
+    auto tag() const noexcept -> identifier {
+        return _tag;
+    }
+
+    /// @brief Returns the id of the logger object measuring the time interval.
+    auto instance() const noexcept -> logger_instance_id {
+        return _instance;
+    }
+
+    /// @brief Marks the start of a measurement on the calling thread.
+    /// @see end
+    void begin() noexcept;
+
+    /// @brief Marks the end of a measurement on the calling thread.
+    /// @see begin
+    /// @see drain
+    ///
+    /// Returns true if the reporting period elapsed and the calling thread
+    /// should drain and report the summary.
+    auto end() noexcept -> bool;
+
+    /// @brief Merges and resets the shards and returns the summary.
+    auto drain() noexcept -> log_interval_summary;
+
+private:
+    static constexpr const std::size_t _shard_count{8U};
+
+    struct alignas(64) _shard {
+        std::array<
+          std::atomic<std::uint32_t>,
+          log_interval_histogram::bucket_count>
+          buckets{};
+        std::atomic<std::uint64_t> sum{0U};
+        std::atomic<std::uint64_t> max{0U};
+    };
+
+    static auto _shard_index() noexcept -> std::size_t;
+    void _record(const std::chrono::nanoseconds) noexcept;
+
+    const identifier _tag;
+    const logger_instance_id _instance;
+    const std::chrono::steady_clock::duration _period;
+    std::atomic<std::chrono::steady_clock::rep> _next_report;
+    std::array<_shard, _shard_count> _shards{};
+};
+//------------------------------------------------------------------------------
+} // namespace eagine
@@ -0,0 +1,160 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module eagine.core.logging;
+
+import std;
+import eagine.core.types;
+import eagine.core.identifier;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+// log_interval_histogram
+//------------------------------------------------------------------------------
+auto log_interval_histogram::percentile(const float q) const noexcept
+  -> std::chrono::nanoseconds {
+    if(_count == 0U) {
+        return {};
+    }
+    const auto target{std::max(
+      std::uint64_t(std::ceil(double(q) * double(_count))), std::uint64_t(1U))};
+    std::uint64_t cumulative{0U};
+    for(std::size_t i = 0; i < bucket_count; ++i) {
+        cumulative += _buckets[i];
+        if(cumulative >= target) {
+            // the representative value may overshoot the actual maximum
+            return std::chrono::nanoseconds{
+              std::min(bucket_value(i), _max)};
+        }
+    }
+    return std::chrono::nanoseconds{_max};
+}
+//------------------------------------------------------------------------------
+auto log_interval_histogram::summary() const noexcept -> log_interval_summary {
+    log_interval_summary result{.count = _count};
+    if(_count > 0U) {
+        result.avg = std::chrono::nanoseconds{_sum / _count};
+        result.p50 = percentile(0.50F);
+        result.p90 = percentile(0.90F);
+        result.p99 = percentile(0.99F);
+        result.max = std::chrono::nanoseconds{_max};
+    }
+    return result;
+}
+//------------------------------------------------------------------------------
+void log_interval_histogram::reset() noexcept {
+    _buckets.fill(0U);
+    _count = 0U;
+    _sum = 0U;
+    _max = 0U;
+}
+//------------------------------------------------------------------------------
+// per-thread interval starts
+//------------------------------------------------------------------------------
+namespace {
+struct log_interval_start {
+    const log_interval_statistics* interval{nullptr};
+    std::chrono::steady_clock::time_point time{};
+};
+
+// the measured intervals are scoped, so the starts form a stack per thread
+thread_local std::array<log_interval_start, 32> log_interval_starts{};
+thread_local std::size_t log_interval_depth{0U};
+} // namespace
+//------------------------------------------------------------------------------
+// log_interval_statistics
+//------------------------------------------------------------------------------
+log_interval_statistics::log_interval_statistics(
+  const identifier tag,
+  const logger_instance_id instance,
+  const std::chrono::steady_clock::duration period) noexcept
+  : _tag{tag}
+  , _instance{instance}
+  , _period{period}
+  , _next_report{(std::chrono::steady_clock::now() + period)
+                   .time_since_epoch()
+                   .count()} {}
+//------------------------------------------------------------------------------
+auto log_interval_statistics::_shard_index() noexcept -> std::size_t {
+    static std::atomic<std::size_t> next{0U};
+    thread_local const std::size_t index{
+      next.fetch_add(1U, std::memory_order_relaxed) % _shard_count};
+    return index;
+}
+//------------------------------------------------------------------------------
+void log_interval_statistics::_record(
+  const std::chrono::nanoseconds d) noexcept {
+    using rep = std::chrono::nanoseconds::rep;
+    const auto ns{std::uint64_t(std::max(d.count(), rep(0)))};
+    auto& shard{_shards[_shard_index()]};
+    shard.buckets[log_interval_histogram::bucket_index(ns)].fetch_add(
+      1U, std::memory_order_relaxed);
+    shard.sum.fetch_add(ns, std::memory_order_relaxed);
+    auto prev{shard.max.load(std::memory_order_relaxed)};
+    while((prev < ns) and not shard.max.compare_exchange_weak(
+                            prev, ns, std::memory_order_relaxed)) {
+    }
+}
+//------------------------------------------------------------------------------
+void log_interval_statistics::begin() noexcept {
+    if(log_interval_depth < log_interval_starts.size()) {
+        log_interval_starts[log_interval_depth] = {
+          .interval = this, .time = std::chrono::steady_clock::now()};
+    }
+    ++log_interval_depth;
+}
+//------------------------------------------------------------------------------
+auto log_interval_statistics::end() noexcept -> bool {
+    const auto now{std::chrono::steady_clock::now()};
+    if(log_interval_depth == 0U) {
+        return false;
+    }
+    if(log_interval_depth > log_interval_starts.size()) {
+        // too deeply nested, the start was not recorded
+        --log_interval_depth;
+        return false;
+    }
+    // usually the innermost interval ends, but look deeper in case
+    // the begin and end calls are not properly nested
+    auto pos{log_interval_depth};
+    while(pos > 0U) {
+        --pos;
+        if(log_interval_starts[pos].interval == this) {
+            _record(now - log_interval_starts[pos].time);
+            std::copy(
+              log_interval_starts.begin() + std::ptrdiff_t(pos + 1U),
+              log_interval_starts.begin() + std::ptrdiff_t(log_interval_depth),
+              log_interval_starts.begin() + std::ptrdiff_t(pos));
+            --log_interval_depth;
+            break;
+        }
+    }
+
+    const auto now_ticks{now.time_since_epoch().count()};
+    auto next{_next_report.load(std::memory_order_relaxed)};
+    return (now_ticks >= next) and
+           _next_report.compare_exchange_strong(
+             next, now_ticks + _period.count(), std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+auto log_interval_statistics::drain() noexcept -> log_interval_summary {
+    log_interval_histogram merged;
+    for(auto& shard : _shards) {
+        for(std::size_t i = 0; i < shard.buckets.size(); ++i) {
+            if(shard.buckets[i].load(std::memory_order_relaxed) != 0U) {
+                merged.add_bucket(
+                  i, shard.buckets[i].exchange(0U, std::memory_order_relaxed));
+            }
+        }
+        merged.update_totals(
+          shard.sum.exchange(0U, std::memory_order_relaxed),
+          shard.max.exchange(0U, std::memory_order_relaxed));
+    }
+    return merged.summary();
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
@@ -0,0 +1,108 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin.hpp>
+import std;
+import eagine.core.identifier;
+import eagine.core.logging;
+//------------------------------------------------------------------------------
+void interval_histogram_bucket_value(auto& s) {
+    eagitest::case_ test{s, 1, "bucket value"};
+    auto& rg{test.random()};
+
+    using h = eagine::log_interval_histogram;
+
+    for(std::uint64_t ns = 0U; ns < h::sub_bucket_count; ++ns) {
+        test.check_equal(h::bucket_value(h::bucket_index(ns)), ns, "exact");
+    }
+    test.check_equal(
+      h::bucket_index(~std::uint64_t(0U)), h::bucket_count - 1U, "clamped");
+
+    for(unsigned k = 0; k < test.repeats(10000); ++k) {
+        const auto ns{rg.get_between<std::uint64_t>(
+          0U, std::uint64_t(1U) << h::max_exponent)};
+        const auto idx{h::bucket_index(ns)};
+        test.check(idx < h::bucket_count, "index in range");
+        const auto val{h::bucket_value(idx)};
+        test.check_equal(h::bucket_index(val), idx, "same bucket");
+        const auto err{val > ns ? val - ns : ns - val};
+        test.check(err <= ns / h::sub_bucket_count, "relative error");
+    }
+}
+//------------------------------------------------------------------------------
+void interval_histogram_percentiles(auto& s) {
+    eagitest::case_ test{s, 2, "percentiles"};
+
+    using std::chrono::nanoseconds;
+    eagine::log_interval_histogram h;
+
+    auto summary{h.summary()};
+    test.check_equal(summary.count, 0U, "empty count");
+    test.check(summary.max == nanoseconds{0}, "empty max");
+
+    for(int i = 1; i <= 1000; ++i) {
+        h.add(nanoseconds{i * 1000});
+    }
+    summary = h.summary();
+    test.check_equal(summary.count, 1000U, "count");
+    test.check(summary.avg == nanoseconds{500500}, "avg");
+    test.check(summary.max == nanoseconds{1000000}, "max");
+
+    const auto near{[](nanoseconds v, std::int64_t e) {
+        return std::abs(v.count() - e) <= e / 16;
+    }};
+    test.check(near(summary.p50, 500000), "p50");
+    test.check(near(summary.p90, 900000), "p90");
+    test.check(near(summary.p99, 990000), "p99");
+    test.check(summary.p50 <= summary.p90, "p50 <= p90");
+    test.check(summary.p90 <= summary.p99, "p90 <= p99");
+    test.check(summary.p99 <= summary.max, "p99 <= max");
+
+    h.reset();
+    test.check_equal(h.count(), 0U, "reset");
+}
+//------------------------------------------------------------------------------
+void interval_statistics_drain(auto& s) {
+    eagitest::case_ test{s, 3, "statistics drain"};
+
+    eagine::log_interval_statistics stats{
+      eagine::identifier{"test"}, 0U, std::chrono::hours{1}};
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&stats] {
+            for(int i = 0; i < 250; ++i) {
+                stats.begin();
+                stats.begin();
+                stats.end();
+                stats.end();
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto summary{stats.drain()};
+    test.check_equal(summary.count, 2000U, "count");
+    test.check(summary.avg <= summary.max, "avg <= max");
+    test.check(summary.p50 <= summary.max, "p50 <= max");
+
+    test.check_equal(stats.drain().count, 0U, "drained");
+    test.check(not stats.end(), "unbalanced end");
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagitest::suite test{argc, argv, "interval_histogram", 3};
+    test.once(interval_histogram_bucket_value);
+    test.once(interval_histogram_percentiles);
+    test.once(interval_statistics_drain);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end.hpp>
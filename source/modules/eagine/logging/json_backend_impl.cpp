@@ -15,32 +15,56 @@ import eagine.core.identifier;
 import eagine.core.reflection;
 import eagine.core.utility;
 import :backend;
+import :interval_histogram;
+import :chart_downsampler;
 
 namespace eagine {
 //------------------------------------------------------------------------------
 template <typename Lockable>
 class json_log_backend : public logger_backend {
+    static constexpr const bool _is_async{
+      std::is_same_v<Lockable, async_log_lock>};
+
+    // in async mode each thread formats its entries into its own buffers
+    auto _buf() noexcept -> std::string& {
+        if constexpr(_is_async) {
+            thread_local std::string buffer;
+            return buffer;
+        } else {
+            return _buffer;
+        }
+    }
+
+    auto _b64() noexcept -> std::string& {
+        if constexpr(_is_async) {
+            thread_local std::string b64lob;
+            return b64lob;
+        } else {
+            return _b64lob;
+        }
+    }
+
     template <std::size_t N>
     void _add(const char (&str)[N]) {
-        _buffer.append(static_cast<const char*>(str), N - 1);
+        _buf().append(static_cast<const char*>(str), N - 1);
     }
 
     void _add(const bool data);
 
     void _add(const std::string& data) {
-        _buffer.append(data);
+        _buf().append(data);
     }
 
     void _add(const std::string_view data) {
-        _buffer.append(data);
+        _buf().append(data);
     }
 
     void _add(const memory::basic_string_span<const char> data) {
-        _buffer.append(data.std_view());
+        _buf().append(data.std_view());
     }
 
     void _add(const decl_name& data) {
-        _buffer.append(data.std_view());
+        _buf().append(data.std_view());
     }
 
     template <auto M>
@@ -219,7 +243,12 @@ public:
 private:
     void _write_entry() noexcept;
 
+    void _report_dropped() noexcept;
+    void _report_interval(log_interval_statistics&) noexcept;
+    void _write_chart(const log_chart_window&) noexcept;
+
     Lockable _lockable{};
+    std::conditional_t<_is_async, std::mutex, Lockable> _registry_lockable{};
     shared_holder<log_output_stream> _output;
     const std::string _session_identity;
     const std::string _log_identity;
@@ -227,18 +256,15 @@ private:
     const std::chrono::steady_clock::time_point _start;
     std::string _buffer;
     std::string _b64lob;
-    memory::shared_byte_allocator _alloc{memory::default_byte_allocator()};
-
-    struct _interval_info {
-        identifier tag;
-        logger_instance_id log_id;
-        std::chrono::steady_clock::time_point start{};
-        std::chrono::steady_clock::duration duration{};
-        std::size_t count{0};
-    };
+    std::atomic<std::uintmax_t> _reported_drops{0U};
+    memory::shared_byte_allocator _alloc{
+      hold<memory::concurrent_arena_byte_allocator>};
 
-    std::map<std::tuple<identifier_t, logger_instance_id>, _interval_info>
+    std::map<
+      std::tuple<identifier_t, logger_instance_id>,
+      log_interval_statistics>
       _intervals;
+    log_chart_downsampler _charts;
 };
 //------------------------------------------------------------------------------
 // implementation
@@ -246,26 +272,27 @@ private:
 template <typename Lockable>
 void json_log_backend<Lockable>::_add(const bool data) {
     if(data) {
-        _buffer.append("true");
+        _buf().append("true");
     } else {
-        _buffer.append("false");
+        _buf().append("false");
     }
 }
 //------------------------------------------------------------------------------
 template <typename Lockable>
 void json_log_backend<Lockable>::_add(const memory::const_block data) {
-    _output->entry_append(_buffer);
-    _buffer.clear();
-    _b64lob.reserve(1024);
-    base64dump(data).apply([this](const char c) {
-        _b64lob.push_back(c);
-        if(_b64lob.size() >= 1024) {
-            _output->entry_append(_b64lob);
-            _b64lob.clear();
+    _output->entry_append(_buf());
+    _buf().clear();
+    auto& b64lob{_b64()};
+    b64lob.reserve(1024);
+    base64dump(data).apply([&, this](const char c) {
+        b64lob.push_back(c);
+        if(b64lob.size() >= 1024) {
+            _output->entry_append(b64lob);
+            b64lob.clear();
         }
     });
-    _output->entry_append(_b64lob);
-    _b64lob.clear();
+    _output->entry_append(b64lob);
+    b64lob.clear();
 }
 //------------------------------------------------------------------------------
 template <typename Lockable>
@@ -275,7 +302,7 @@ void json_log_backend<Lockable>::_add(const T& value) {
     const auto conv{
       std::to_chars(temp.data(), temp.data() + temp.size(), value)};
     if(conv.ec == std::error_code{}) {
-        _buffer.append(temp.data(), std::distance(temp.data(), conv.ptr));
+        _buf().append(temp.data(), std::distance(temp.data(), conv.ptr));
     }
 }
 //------------------------------------------------------------------------------
@@ -287,7 +314,8 @@ json_log_backend<Lockable>::json_log_backend(
   , _session_identity{info.session_identity}
   , _log_identity{info.log_identity}
   , _min_severity{info.min_severity}
-  , _start{std::chrono::steady_clock::now()} {
+  , _start{std::chrono::steady_clock::now()}
+  , _charts{info.chart_sample_window} {
     _buffer.reserve(1024);
 }
 //------------------------------------------------------------------------------
@@ -303,9 +331,9 @@ auto json_log_backend<Lockable>::entry_backend(
 template <typename Lockable>
 void json_log_backend<Lockable>::_write_entry() noexcept {
     _output->begin_entry();
-    _output->entry_append(_buffer);
+    _output->entry_append(_buf());
     _output->finish_entry();
-    _buffer.clear();
+    _buf().clear();
 }
 //------------------------------------------------------------------------------
 template <typename Lockable>
@@ -339,13 +367,10 @@ auto json_log_backend<Lockable>::register_time_interval(
   const logger_instance_id log_id) noexcept -> time_interval_id {
     try {
         const auto key{std::make_tuple(tag.value(), log_id)};
-        const std::lock_guard<Lockable> lock{_lockable};
-        auto pos{_intervals.find(key)};
-        if(pos == _intervals.end()) {
-            pos = _intervals
-                    .emplace(key, _interval_info{.tag = tag, .log_id = log_id})
-                    .first;
-        }
+        const std::lock_guard lock{_registry_lockable};
+        const auto pos{
+          _intervals.try_emplace(key, tag, log_id, std::chrono::seconds{10})
+            .first};
         return reinterpret_cast<time_interval_id>(&(pos->second));
     } catch(...) {
         return 0U;
@@ -355,7 +380,8 @@ auto json_log_backend<Lockable>::register_time_interval(
 template <typename Lockable>
 auto json_log_backend<Lockable>::_get_interval(
   const time_interval_id int_id) noexcept -> auto* {
-    return static_cast<_interval_info*>(reinterpret_cast<void*>(int_id));
+    return static_cast<log_interval_statistics*>(
+      reinterpret_cast<void*>(int_id));
 }
 //------------------------------------------------------------------------------
 template <typename Lockable>
@@ -363,7 +389,7 @@ void json_log_backend<Lockable>::time_interval_begin(
   const time_interval_id int_id) noexcept {
     try {
         if(const auto info{_get_interval(int_id)}) {
-            info->start = std::chrono::steady_clock::now();
+            info->begin();
         }
     } catch(...) {
     }
@@ -374,24 +400,8 @@ void json_log_backend<Lockable>::time_interval_end(
   const time_interval_id int_id) noexcept {
     try {
         if(const auto info{_get_interval(int_id)}) {
-            const auto now{std::chrono::steady_clock::now()};
-            info->count++;
-            info->duration += (now - info->start);
-
-            const auto batch{1'000U};
-            if(info->count >= batch) {
-                std::chrono::nanoseconds avg{(info->duration / batch)};
-                const std::lock_guard<Lockable> lock{_lockable};
-                _add(R"({"t":"i","iid":)");
-                _add(info->log_id);
-                _add(R"(,"tag":")");
-                _add(info->tag);
-                _add(R"(","tns":)");
-                _add(avg.count());
-                _add(R"(})");
-                _write_entry();
-                info->count = 0U;
-                info->duration = {};
+            if(info->end()) {
+                _report_interval(*info);
             }
         }
     } catch(...) {
@@ -399,6 +409,36 @@ void json_log_backend<Lockable>::time_interval_end(
 }
 //------------------------------------------------------------------------------
 template <typename Lockable>
+void json_log_backend<Lockable>::_report_interval(
+  log_interval_statistics& info) noexcept {
+    try {
+        const auto stats{info.drain()};
+        if(stats.count > 0U) {
+            const std::lock_guard<Lockable> lock{_lockable};
+            _add(R"({"t":"i","iid":)");
+            _add(info.instance());
+            _add(R"(,"tag":")");
+            _add(info.tag());
+            _add(R"(","tns":)");
+            _add(stats.avg.count());
+            _add(R"(,"cnt":)");
+            _add(stats.count);
+            _add(R"(,"p50":)");
+            _add(stats.p50.count());
+            _add(R"(,"p90":)");
+            _add(stats.p90.count());
+            _add(R"(,"p99":)");
+            _add(stats.p99.count());
+            _add(R"(,"max":)");
+            _add(stats.max.count());
+            _add(R"(})");
+            _write_entry();
+        }
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
 void json_log_backend<Lockable>::set_description(
   const identifier source,
   const logger_instance_id instance,
@@ -614,9 +654,9 @@ template <typename Lockable>
 void json_log_backend<Lockable>::finish_message() noexcept {
     try {
         _add("]}");
-        _output->entry_append(_buffer);
+        _output->entry_append(_buf());
         _output->finish_entry();
-        _buffer.clear();
+        _buf().clear();
         _lockable.unlock();
     } catch(...) {
     }
@@ -629,6 +669,81 @@ void json_log_backend<Lockable>::log_chart_sample(
   const identifier series,
   const float value) noexcept {
     try {
+        const auto now{std::chrono::steady_clock::now()};
+        if(_charts.is_enabled()) {
+            std::optional<log_chart_window> window;
+            {
+                const std::lock_guard lock{_registry_lockable};
+                window = _charts.add(source, instance, series, value, now);
+            }
+            if(window) {
+                _write_chart(*window);
+            }
+        } else {
+            _write_chart(
+              {.source = source,
+               .instance = instance,
+               .series = series,
+               .time = now,
+               .count = 1U,
+               .min = value,
+               .max = value,
+               .mean = value});
+        }
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void json_log_backend<Lockable>::_write_chart(
+  const log_chart_window& window) noexcept {
+    try {
+        const auto sec{std::chrono::duration<float>(window.time - _start)};
+        const std::lock_guard<Lockable> lock{_lockable};
+        _add(R"({"t":"c","src":")");
+        _add(window.source);
+        _add(R"(","iid":)");
+        _add(window.instance);
+        _add(R"(,"ser":")");
+        _add(window.series);
+        _add(R"(","ts":)");
+        _add(sec.count());
+        _add(R"(,"v":)");
+        _add(window.mean);
+        if(window.count != 1U) {
+            _add(R"(,"cnt":)");
+            _add(window.count);
+            _add(R"(,"min":)");
+            _add(window.min);
+            _add(R"(,"max":)");
+            _add(window.max);
+        }
+        _add(R"(})");
+        _write_entry();
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lockable>
+void json_log_backend<Lockable>::_report_dropped() noexcept {
+    try {
+        const auto dropped{_output->dropped_entries()};
+        const auto reported{_reported_drops.exchange(dropped)};
+        if(dropped > reported) {
+            const auto now{std::chrono::steady_clock::now()};
+            const auto sec{std::chrono::duration<float>(now - _start)};
+            const std::lock_guard<Lockable> lock{_lockable};
+            _add(R"({"t":"m","lvl":"warning","src":"AsyncLog")");
+            _add(R"(,"tag":"dropEntrs","iid":0,"ts":)");
+            _add(sec.count());
+            _add(R"(,"f":"dropped ${count} log entries (${total} total)")");
+            _add(R"(,"a":[null,{"n":"count","t":"int","v":)");
+            _add(dropped - reported);
+            _add(R"(},{"n":"total","t":"int","v":)");
+            _add(dropped);
+            _add(R"(}]})");
+            _write_entry();
+        }
     } catch(...) {
     }
 }
@@ -636,7 +751,15 @@ void json_log_backend<Lockable>::log_chart_sample(
 template <typename Lockable>
 void json_log_backend<Lockable>::heartbeat() noexcept {
     try {
+        _report_dropped();
         const auto now{std::chrono::steady_clock::now()};
+        if(_charts.is_enabled()) {
+            // windows of series without recent samples
+            const std::lock_guard lock{_registry_lockable};
+            for(const auto& window : _charts.flush_expired(now)) {
+                _write_chart(window);
+            }
+        }
         const auto sec{std::chrono::duration<float>(now - _start)};
         const std::lock_guard<Lockable> lock{_lockable};
         _add(R"({"t":"hb")");
@@ -651,6 +774,16 @@ void json_log_backend<Lockable>::heartbeat() noexcept {
 template <typename Lockable>
 void json_log_backend<Lockable>::finish_log() noexcept {
     try {
+        _report_dropped();
+        {
+            const std::lock_guard lock{_registry_lockable};
+            for(auto& entry : _intervals) {
+                _report_interval(entry.second);
+            }
+            for(const auto& window : _charts.flush()) {
+                _write_chart(window);
+            }
+        }
         const auto now{std::chrono::steady_clock::now()};
         const auto sec{std::chrono::duration<float>(now - _start)};
         const std::lock_guard<Lockable> lock{_lockable};
@@ -677,6 +810,11 @@ auto make_json_log_backend(
             return {hold<json_log_backend<std::mutex>>, info, std::move(out)};
         case log_backend_lock::spinlock:
             return {hold<json_log_backend<spinlock>>, info, std::move(out)};
+        case log_backend_lock::async:
+            return {
+              hold<json_log_backend<async_log_lock>>,
+              info,
+              make_async_output_stream(std::move(out), info)};
     }
 }
 //------------------------------------------------------------------------------
@@ -17,6 +17,7 @@ import eagine.core.runtime;
 import eagine.core.units;
 import :config;
 import :backend;
+import :rate_limiter;
 import :entry;
 
 namespace eagine {
@@ -40,11 +41,21 @@ public:
         return _backend;
     }
 
+    auto share_rate_limiter() const noexcept {
+        return _rate_limiter;
+    }
+
     /// @brief Returns a pointer to the back-end of this logger object.
     auto backend() const noexcept -> optional_reference<logger_backend> {
         return _backend;
     }
 
+    /// @brief Returns a pointer to the log entry rate limiter if any.
+    /// @see log_rate_limiter
+    auto rate_limiter() const noexcept -> optional_reference<log_rate_limiter> {
+        return _rate_limiter;
+    }
+
     /// @brief Indicates that this process is alive.
     void heartbeat() const noexcept;
 
@@ -78,9 +89,20 @@ protected:
     basic_logger(shared_holder<logger_backend> backend) noexcept
       : _backend{std::move(backend)} {}
 
+    basic_logger(
+      shared_holder<logger_backend> backend,
+      shared_holder<log_rate_limiter> rate_limiter) noexcept
+      : _backend{std::move(backend)}
+      , _rate_limiter{std::move(rate_limiter)} {}
+
     void begin_log() noexcept;
     void finish_log() noexcept;
 
+    /// @brief Creates the rate limiter shared by this and the derived loggers.
+    void enable_rate_limiter() noexcept {
+        _rate_limiter.ensure();
+    }
+
     void set_description(
       const identifier source,
       const string_view display_name,
@@ -101,7 +123,12 @@ protected:
       const std::true_type,
       const string_view format) const noexcept -> log_entry {
         return {
-          source, instance_id(), severity, format, _entry_backend(severity)};
+          source,
+          instance_id(),
+          severity,
+          format,
+          _limited_entry_backend(source, severity),
+          _tag_rate_limiter()};
     }
 
     constexpr auto make_log_entry(
@@ -126,7 +153,12 @@ protected:
       const log_event_severity severity,
       const string_view format) const noexcept -> log_entry {
         return {
-          source, instance_id(), severity, format, _entry_backend(severity)};
+          source,
+          instance_id(),
+          severity,
+          format,
+          _limited_entry_backend(source, severity),
+          _tag_rate_limiter()};
     }
 
     auto make_log_entry(
@@ -259,8 +291,33 @@ protected:
         return nullptr;
     }
 
+    auto _limited_entry_backend(
+      const identifier source,
+      const log_event_severity severity) const noexcept -> logger_backend* {
+        auto lbe{_entry_backend(severity)};
+        if(lbe and _rate_limiter) [[unlikely]] {
+            if(not _check_rate_limit(source, severity)) {
+                return nullptr;
+            }
+        }
+        return lbe;
+    }
+
+    auto _tag_rate_limiter() const noexcept -> log_rate_limiter* {
+        if(_rate_limiter and _rate_limiter->has_tag_limits()) [[unlikely]] {
+            return _rate_limiter.get();
+        }
+        return nullptr;
+    }
+
 private:
+    auto _check_rate_limit(
+      const identifier source,
+      const log_event_severity severity) const noexcept -> bool;
+    void _report_suppressed() const noexcept;
+
     shared_holder<logger_backend> _backend;
+    shared_holder<log_rate_limiter> _rate_limiter;
 };
 //------------------------------------------------------------------------------
 /// @brief Basic template for logging objects.
@@ -293,6 +350,15 @@ public:
       : base{std::move(backend)}
       , _object_id{id} {}
 
+    /// @brief Constructor from identifier, back-end and rate limiter objects.
+    /// @note For internal use-only.
+    named_logging_object(
+      const identifier id,
+      shared_holder<logger_backend> backend,
+      shared_holder<log_rate_limiter> rate_limiter) noexcept
+      : base{std::move(backend), std::move(rate_limiter)}
+      , _object_id{id} {}
+
     /// @brief Constructor from logger id and parent logging object.
     named_logging_object(
       const identifier id,
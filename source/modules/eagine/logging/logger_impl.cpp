@@ -49,9 +49,54 @@ auto basic_logger::configure(basic_config_intf& config) const -> bool {
     if(auto lbe{backend()}) {
         lbe->configure(config);
     }
+    if(_rate_limiter) {
+        std::chrono::seconds report_interval{60};
+        if(config.fetch("log.rate_limit.report_interval", report_interval)) {
+            _rate_limiter->set_report_interval(report_interval);
+        }
+        std::string limits;
+        if(config.fetch_string("log.rate_limits", limits)) {
+            if(not _rate_limiter->set_limits(limits)) {
+                log_entry{
+                  "LogRateLmt",
+                  instance_id(),
+                  log_event_severity::error,
+                  "skipped invalid entries in log rate limits '${limits}'",
+                  _entry_backend(log_event_severity::error)}
+                  .tag("invldLimit")
+                  .arg("limits", string_view{limits});
+            }
+        }
+    }
     return false;
 }
 //------------------------------------------------------------------------------
+auto basic_logger::_check_rate_limit(
+  const identifier source,
+  const log_event_severity severity) const noexcept -> bool {
+    const bool result{_rate_limiter->should_log(source, severity)};
+    if(_rate_limiter->should_report()) [[unlikely]] {
+        _report_suppressed();
+    }
+    return result;
+}
+//------------------------------------------------------------------------------
+void basic_logger::_report_suppressed() const noexcept {
+    for(const auto& suppressed : _rate_limiter->take_suppressed()) {
+        // not using make_log_entry to avoid limiting this entry
+        log_entry{
+          "LogRateLmt",
+          instance_id(),
+          log_event_severity::warning,
+          "suppressed ${count} log entries from ${source} tagged ${tag}",
+          _entry_backend(log_event_severity::warning)}
+          .tag("suppressed")
+          .arg("count", suppressed.count)
+          .arg("source", suppressed.source)
+          .arg("tag", suppressed.tag);
+    }
+}
+//------------------------------------------------------------------------------
 void basic_logger::set_description(
   const identifier source,
   const string_view display_name,
@@ -9,7 +9,11 @@ export module eagine.core.logging;
 
 export import :config;
 export import :backend;
+export import :interval_histogram;
+export import :chart_downsampler;
+export import :rate_limiter;
 export import :entry_arg;
+export import :entry_arg_buffer;
 export import :entry;
 export import :logger;
 export import :root_logger;
@@ -25,6 +25,341 @@ import :backend;
 
 namespace eagine {
 //------------------------------------------------------------------------------
+/// @brief Bounded buffer storing log calls made before the backend is chosen.
+///
+/// The calls are stored in a compact binary form, in a fixed-size storage,
+/// and replayed to the actual backend once it is configured. Messages that
+/// do not fit into the remaining space are dropped as a whole and counted.
+class proxy_log_preinit_buffer {
+public:
+    enum class op : std::uint8_t {
+        begin_log,
+        set_description,
+        declare_state,
+        active_state,
+        begin_message,
+        add_nothing,
+        add_identifier,
+        add_message_id,
+        add_bool,
+        add_integer,
+        add_unsigned,
+        add_float,
+        add_float_range,
+        add_duration,
+        add_string,
+        add_blob,
+        finish_message,
+        chart_sample,
+        heartbeat,
+        finish_log
+    };
+
+    auto is_active() const noexcept -> bool {
+        return _active;
+    }
+
+    auto dropped_entries() const noexcept -> std::uintmax_t {
+        return _dropped;
+    }
+
+    template <typename... T>
+    void add(const op o, const T&... values) noexcept {
+        if(_active and not _put(0, o, values...)) [[unlikely]] {
+            ++_dropped;
+        }
+    }
+
+    template <typename... T>
+    auto begin_message(const T&... values) noexcept -> bool {
+        if(not _active) [[unlikely]] {
+            return false;
+        }
+        _message_start = _size;
+        if(_put(1, op::begin_message, values...)) [[likely]] {
+            return true;
+        }
+        ++_dropped;
+        return false;
+    }
+
+    template <typename... T>
+    void add_arg(const op o, const T&... values) noexcept {
+        if(_active and not _dropping) [[likely]] {
+            if(not _put(1, o, values...)) [[unlikely]] {
+                _size = _message_start;
+                _dropping = true;
+            }
+        }
+    }
+
+    void finish_message() noexcept {
+        if(_dropping) [[unlikely]] {
+            _dropping = false;
+            ++_dropped;
+        } else if(_active) [[likely]] {
+            _put(0, op::finish_message);
+        }
+    }
+
+    void replay(logger_backend& backend) noexcept;
+
+private:
+    static constexpr const span_size_t _capacity{64 * 1024};
+
+    template <typename T>
+    static constexpr auto _size_of(const T&) noexcept -> span_size_t {
+        return span_size_of<T>();
+    }
+
+    static auto _size_of(const identifier&) noexcept -> span_size_t {
+        return span_size_of<identifier_t>();
+    }
+
+    static auto _size_of(const message_id&) noexcept -> span_size_t {
+        return 2 * span_size_of<identifier_t>();
+    }
+
+    static auto _size_of(const string_view& str) noexcept -> span_size_t {
+        return span_size_of<std::uint32_t>() + str.size();
+    }
+
+    static auto _size_of(const memory::const_block& blk) noexcept
+      -> span_size_t {
+        return span_size_of<std::uint32_t>() + blk.size();
+    }
+
+    template <typename T>
+    void _write(const T& value) noexcept {
+        std::memcpy(std::next(_storage.data(), _size), &value, sizeof(T));
+        _size += span_size_of<T>();
+    }
+
+    void _write(const identifier& id) noexcept {
+        _write(id.value());
+    }
+
+    void _write(const message_id& msg_id) noexcept {
+        _write(msg_id.class_id());
+        _write(msg_id.method_id());
+    }
+
+    void _write(const memory::const_block& blk) noexcept {
+        _write(limit_cast<std::uint32_t>(blk.size()));
+        std::copy(blk.begin(), blk.end(), std::next(_storage.data(), _size));
+        _size += blk.size();
+    }
+
+    void _write(const string_view& str) noexcept {
+        _write(as_bytes(str));
+    }
+
+    template <typename... T>
+    auto _put(
+      const span_size_t reserved,
+      const op o,
+      const T&... values) noexcept -> bool {
+        const auto needed{span_size_of<op>() + (0 + ... + _size_of(values))};
+        if(_size + needed + reserved > _capacity) [[unlikely]] {
+            return false;
+        }
+        _write(o);
+        (_write(values), ...);
+        return true;
+    }
+
+    std::array<byte, std_size(_capacity)> _storage;
+    span_size_t _size{0};
+    span_size_t _message_start{0};
+    std::uintmax_t _dropped{0U};
+    bool _dropping{false};
+    bool _active{true};
+};
+//------------------------------------------------------------------------------
+class proxy_log_preinit_reader {
+public:
+    proxy_log_preinit_reader(const memory::const_block data) noexcept
+      : _data{data} {}
+
+    auto at_end() const noexcept -> bool {
+        return _pos >= _data.size();
+    }
+
+    template <typename T>
+    auto get() noexcept -> T {
+        assert(_pos + span_size_of<T>() <= _data.size());
+        T result;
+        std::memcpy(&result, std::next(_data.data(), _pos), sizeof(T));
+        _pos += span_size_of<T>();
+        return result;
+    }
+
+    auto get_id() noexcept -> identifier {
+        return identifier{get<identifier_t>()};
+    }
+
+    auto get_msg_id() noexcept -> message_id {
+        const auto class_id{get<identifier_t>()};
+        return {class_id, get<identifier_t>()};
+    }
+
+    auto get_block() noexcept -> memory::const_block {
+        const auto size{span_size(get<std::uint32_t>())};
+        assert(_pos + size <= _data.size());
+        const auto result{head(skip(_data, _pos), size)};
+        _pos += size;
+        return result;
+    }
+
+    auto get_string() noexcept -> string_view {
+        return as_chars(get_block());
+    }
+
+private:
+    memory::const_block _data;
+    span_size_t _pos{0};
+};
+//------------------------------------------------------------------------------
+void proxy_log_preinit_buffer::replay(logger_backend& backend) noexcept {
+    proxy_log_preinit_reader r{memory::const_block{_storage.data(), _size}};
+    while(not r.at_end()) {
+        switch(r.get<op>()) {
+            case op::begin_log:
+                backend.begin_log();
+                break;
+            case op::set_description: {
+                const auto source{r.get_id()};
+                const auto instance{r.get<logger_instance_id>()};
+                const auto name{r.get_string()};
+                const auto desc{r.get_string()};
+                backend.set_description(source, instance, name, desc);
+                break;
+            }
+            case op::declare_state: {
+                const auto source{r.get_id()};
+                const auto state_tag{r.get_id()};
+                const auto begin_tag{r.get_id()};
+                const auto end_tag{r.get_id()};
+                backend.declare_state(source, state_tag, begin_tag, end_tag);
+                break;
+            }
+            case op::active_state: {
+                const auto source{r.get_id()};
+                backend.active_state(source, r.get_id());
+                break;
+            }
+            case op::begin_message: {
+                const auto source{r.get_id()};
+                const auto tag{r.get_id()};
+                const auto instance{r.get<logger_instance_id>()};
+                const auto severity{r.get<log_event_severity>()};
+                const auto format{r.get_string()};
+                backend.begin_message(source, tag, instance, severity, format);
+                break;
+            }
+            case op::add_nothing: {
+                const auto arg{r.get_id()};
+                backend.add_nothing(arg, r.get_id());
+                break;
+            }
+            case op::add_identifier: {
+                const auto arg{r.get_id()};
+                const auto tag{r.get_id()};
+                backend.add_identifier(arg, tag, r.get_id());
+                break;
+            }
+            case op::add_message_id: {
+                const auto arg{r.get_id()};
+                const auto tag{r.get_id()};
+                backend.add_message_id(arg, tag, r.get_msg_id());
+                break;
+            }
+            case op::add_bool: {
+                const auto arg{r.get_id()};
+                const auto tag{r.get_id()};
+                backend.add_bool(arg, tag, r.get<bool>());
+                break;
+            }
+            case op::add_integer: {
+                const auto arg{r.get_id()};
+                const auto tag{r.get_id()};
+                backend.add_integer(arg, tag, r.get<std::intmax_t>());
+                break;
+            }
+            case op::add_unsigned: {
+                const auto arg{r.get_id()};
+                const auto tag{r.get_id()};
+                backend.add_unsigned(arg, tag, r.get<std::uintmax_t>());
+                break;
+            }
+            case op::add_float: {
+                const auto arg{r.get_id()};
+                const auto tag{r.get_id()};
+                backend.add_float(arg, tag, r.get<float>());
+                break;
+            }
+            case op::add_float_range: {
+                const auto arg{r.get_id()};
+                const auto tag{r.get_id()};
+                const auto min{r.get<float>()};
+                const auto value{r.get<float>()};
+                backend.add_float(arg, tag, min, value, r.get<float>());
+                break;
+            }
+            case op::add_duration: {
+                const auto arg{r.get_id()};
+                const auto tag{r.get_id()};
+                backend.add_duration(
+                  arg, tag, std::chrono::duration<float>{r.get<float>()});
+                break;
+            }
+            case op::add_string: {
+                const auto arg{r.get_id()};
+                const auto tag{r.get_id()};
+                backend.add_string(arg, tag, r.get_string());
+                break;
+            }
+            case op::add_blob: {
+                const auto arg{r.get_id()};
+                const auto tag{r.get_id()};
+                backend.add_blob(arg, tag, r.get_block());
+                break;
+            }
+            case op::finish_message:
+                backend.finish_message();
+                break;
+            case op::chart_sample: {
+                const auto source{r.get_id()};
+                const auto instance{r.get<logger_instance_id>()};
+                const auto series{r.get_id()};
+                backend.log_chart_sample(
+                  source, instance, series, r.get<float>());
+                break;
+            }
+            case op::heartbeat:
+                backend.heartbeat();
+                break;
+            case op::finish_log:
+                backend.finish_log();
+                break;
+        }
+    }
+    _size = 0;
+    _active = false;
+
+    if(_dropped > 0U) {
+        if(backend.begin_message(
+             "LogProxy",
+             "dropped",
+             0U,
+             log_event_severity::warning,
+             "dropped ${count} log entries before configuration")) {
+            backend.add_unsigned("count", "int64", _dropped);
+            backend.finish_message();
+        }
+    }
+}
+//------------------------------------------------------------------------------
 class proxy_log_backend final : public logger_backend {
 public:
     proxy_log_backend(log_stream_info info) noexcept
@@ -141,9 +476,10 @@ public:
     void finish_log() noexcept final;
 
 private:
+    using _op = proxy_log_preinit_buffer::op;
+
     unique_holder<logger_backend> _delegate;
-    unique_holder<std::vector<std::function<void()>>> _delayed{
-      default_selector};
+    proxy_log_preinit_buffer _delayed;
     log_stream_info _info;
 };
 //------------------------------------------------------------------------------
@@ -184,9 +520,8 @@ void proxy_log_backend::make_less_verbose() noexcept {
 void proxy_log_backend::begin_log() noexcept {
     if(_delegate) {
         _delegate->begin_log();
-    } else if(_delayed) {
-        assert(not _delegate);
-        _delayed->emplace_back([this]() { _delegate->begin_log(); });
+    } else {
+        _delayed.add(_op::begin_log);
     }
 }
 //------------------------------------------------------------------------------
@@ -218,16 +553,7 @@ void proxy_log_backend::set_description(
   const logger_instance_id instance,
   const string_view name,
   const string_view desc) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this,
-                                source,
-                                instance,
-                                name{to_string(name)},
-                                desc{to_string(desc)}]() {
-            _delegate->set_description(source, instance, name, desc);
-        });
-    }
+    _delayed.add(_op::set_description, source, instance, name, desc);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::declare_state(
@@ -235,23 +561,13 @@ void proxy_log_backend::declare_state(
   const identifier state_tag,
   const identifier begin_tag,
   const identifier end_tag) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this, source, state_tag, begin_tag, end_tag]() {
-            _delegate->declare_state(source, state_tag, begin_tag, end_tag);
-        });
-    }
+    _delayed.add(_op::declare_state, source, state_tag, begin_tag, end_tag);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::active_state(
   const identifier source,
   const identifier state_tag) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this, source, state_tag]() {
-            _delegate->active_state(source, state_tag);
-        });
-    }
+    _delayed.add(_op::active_state, source, state_tag);
 }
 //------------------------------------------------------------------------------
 auto proxy_log_backend::begin_message(
@@ -260,95 +576,55 @@ auto proxy_log_backend::begin_message(
   const logger_instance_id instance,
   const log_event_severity severity,
   const string_view format) noexcept -> bool {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back(
-          [this, source, tag, instance, severity, format{to_string(format)}]() {
-              _delegate->begin_message(source, tag, instance, severity, format);
-          });
-        return true;
-    }
-    return false;
+    return _delayed.begin_message(source, tag, instance, severity, format);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::add_nothing(
   const identifier arg,
   const identifier tag) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back(
-          [this, arg, tag]() { _delegate->add_nothing(arg, tag); });
-    }
+    _delayed.add_arg(_op::add_nothing, arg, tag);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::add_identifier(
   const identifier arg,
   const identifier tag,
   const identifier value) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this, arg, tag, value]() {
-            _delegate->add_identifier(arg, tag, value);
-        });
-    }
+    _delayed.add_arg(_op::add_identifier, arg, tag, value);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::add_message_id(
   const identifier arg,
   const identifier tag,
   const message_id value) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this, arg, tag, value]() {
-            _delegate->add_message_id(arg, tag, value);
-        });
-    }
+    _delayed.add_arg(_op::add_message_id, arg, tag, value);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::add_bool(
   const identifier arg,
   const identifier tag,
   const bool value) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back(
-          [this, arg, tag, value]() { _delegate->add_bool(arg, tag, value); });
-    }
+    _delayed.add_arg(_op::add_bool, arg, tag, value);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::add_integer(
   const identifier arg,
   const identifier tag,
   const std::intmax_t value) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this, arg, tag, value]() {
-            _delegate->add_integer(arg, tag, value);
-        });
-    }
+    _delayed.add_arg(_op::add_integer, arg, tag, value);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::add_unsigned(
   const identifier arg,
   const identifier tag,
   const std::uintmax_t value) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this, arg, tag, value]() {
-            _delegate->add_unsigned(arg, tag, value);
-        });
-    }
+    _delayed.add_arg(_op::add_unsigned, arg, tag, value);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::add_float(
   const identifier arg,
   const identifier tag,
   const float value) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back(
-          [this, arg, tag, value]() { _delegate->add_float(arg, tag, value); });
-    }
+    _delayed.add_arg(_op::add_float, arg, tag, value);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::add_float(
@@ -357,59 +633,32 @@ void proxy_log_backend::add_float(
   const float min,
   const float value,
   const float max) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this, arg, tag, min, value, max]() {
-            _delegate->add_float(arg, tag, min, value, max);
-        });
-    }
+    _delayed.add_arg(_op::add_float_range, arg, tag, min, value, max);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::add_duration(
   const identifier arg,
   const identifier tag,
   const std::chrono::duration<float> value) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this, arg, tag, value]() {
-            _delegate->add_duration(arg, tag, value);
-        });
-    }
+    _delayed.add_arg(_op::add_duration, arg, tag, value.count());
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::add_string(
   const identifier arg,
   const identifier tag,
   const string_view value) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this, arg, tag, value{to_string(value)}]() {
-            _delegate->add_string(arg, tag, value);
-        });
-    }
+    _delayed.add_arg(_op::add_string, arg, tag, value);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::add_blob(
   const identifier arg,
   const identifier tag,
   const memory::const_block value) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back(
-          [this,
-           arg,
-           tag,
-           value{std::vector<byte>(value.begin(), value.end())}]() {
-              _delegate->add_blob(arg, tag, view(value));
-          });
-    }
+    _delayed.add_arg(_op::add_blob, arg, tag, value);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::finish_message() noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this]() { _delegate->finish_message(); });
-    }
+    _delayed.finish_message();
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::log_chart_sample(
@@ -417,30 +666,21 @@ void proxy_log_backend::log_chart_sample(
   const logger_instance_id instance,
   const identifier series,
   const float value) noexcept {
-    if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this, source, instance, series, value]() {
-            _delegate->log_chart_sample(source, instance, series, value);
-        });
-    }
+    _delayed.add(_op::chart_sample, source, instance, series, value);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::heartbeat() noexcept {
     if(_delegate) [[likely]] {
         return _delegate->heartbeat();
-    } else if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this]() { _delegate->heartbeat(); });
     }
+    _delayed.add(_op::heartbeat);
 }
 //------------------------------------------------------------------------------
 void proxy_log_backend::finish_log() noexcept {
     if(_delegate) [[likely]] {
         return _delegate->finish_log();
-    } else if(_delayed) [[likely]] {
-        assert(not _delegate);
-        _delayed->emplace_back([this]() { _delegate->finish_log(); });
     }
+    _delayed.add(_op::finish_log);
 }
 //------------------------------------------------------------------------------
 auto proxy_log_choose_backend(
@@ -510,15 +750,17 @@ auto proxy_log_backend::configure(basic_config_intf& config) -> bool {
     std::string backend_name;
     config.fetch_string("log.backend", backend_name);
     config.fetch("log.severity", _info.min_severity);
+    config.fetch("log.async.overflow", _info.overflow_policy);
+    config.fetch("log.async.ring_size", _info.async_ring_size);
+    config.fetch("log.sender.background", _info.background_sender);
+    config.fetch("log.sender.queue_size", _info.sender_queue_size);
+    config.fetch("log.sender.reconnect_buffer", _info.reconnect_buffer_size);
     try {
         _delegate = proxy_log_choose_backend(config, backend_name, _info);
         if(_delegate) {
             _delegate->configure(config);
-            if(_delayed) {
-                for(auto& op : *_delayed) {
-                    op();
-                }
-                _delayed.reset();
+            if(_delayed.is_active()) {
+                _delayed.replay(*_delegate);
             }
             return true;
         }
@@ -0,0 +1,161 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+export module eagine.core.logging:rate_limiter;
+
+import std;
+import eagine.core.types;
+import eagine.core.identifier;
+import :backend;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+/// @brief Parameters of the rate limit of log entries.
+/// @ingroup logging
+/// @see log_rate_limiter
+export struct log_rate_limit {
+    /// @brief The sustained number of entries per second (zero is unlimited).
+    float rate{0.F};
+    /// @brief The maximum number of entries logged in a burst.
+    float burst{1.F};
+    /// @brief Only every N-th entry (passing the rate limit) is logged.
+    std::uint32_t sample_every{1U};
+    /// @brief Entries more severe than this are never limited.
+    log_event_severity max_severity{log_event_severity::stat};
+};
+//------------------------------------------------------------------------------
+/// @brief The number of entries suppressed by a rate limit.
+/// @ingroup logging
+/// @see log_rate_limiter
+export struct log_suppressed_entries {
+    /// @brief The source of the limited entries, empty if any.
+    identifier source;
+    /// @brief The tag of the limited entries, empty if any.
+    identifier tag;
+    /// @brief The number of entries suppressed since the last report.
+    std::uint64_t count{0U};
+};
+//------------------------------------------------------------------------------
+/// @brief Thread-safe token-bucket and 1-in-N sampling limiter of log entries.
+/// @ingroup logging
+/// @see log_rate_limit
+///
+/// The limits are keyed by the source logger identifier and the entry tag,
+/// and either of them can be empty to match any source or any entry tag.
+/// Limits with an empty tag are checked when the entry is created, limits
+/// with a specific tag when the entry is tagged, in both cases before any
+/// arguments are captured. An entry has to pass both checks to be logged.
+/// The limit applying to a source and tag is looked up once and then cached
+/// in one of several shards picked by the source, so the checks neither
+/// serialize all logging threads nor repeat the wildcard lookups.
+export class log_rate_limiter {
+public:
+    /// @brief Sets the limit of entries from the specified source and tag.
+    void set_limit(
+      const identifier source,
+      const identifier tag,
+      const log_rate_limit limit) noexcept;
+
+    /// @brief Removes the limit of entries from the specified source and tag.
+    void remove_limit(const identifier source, const identifier tag) noexcept;
+
+    /// @brief Removes all limits.
+    void clear() noexcept;
+
+    /// @brief Parses and sets the limits from the specified string.
+    /// @see set_limit
+    ///
+    /// The limits are separated by semicolons, each has the form
+    /// source[/tag]:param=value[,param=value...], where source and tag
+    /// can be '*' and the params are rate, burst, every and severity.
+    /// For example "Renderer/frameTime:rate=10,burst=20;*:every=100".
+    /// Invalid limits are skipped and false is returned in such case.
+    auto set_limits(const string_view spec) noexcept -> bool;
+
+    /// @brief Sets the interval in which the suppressed counts are reported.
+    void set_report_interval(const std::chrono::seconds interval) noexcept {
+        _report_interval.store(interval.count(), std::memory_order_relaxed);
+    }
+
+    /// @brief Indicates if there are limits not specific to entry tags.
+    auto has_source_limits() const noexcept -> bool {
+        return _has_source_limits.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Indicates if there are limits specific to entry tags.
+    auto has_tag_limits() const noexcept -> bool {
+        return _has_tag_limits.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Checks the limits not specific to entry tags.
+    auto should_log(
+      const identifier source,
+      const log_event_severity severity) noexcept -> bool {
+        return not has_source_limits() or _check(source, {}, severity);
+    }
+
+    /// @brief Checks the limits specific to the specified entry tag.
+    auto should_log(
+      const identifier source,
+      const identifier tag,
+      const log_event_severity severity) noexcept -> bool {
+        return not has_tag_limits() or not tag or _check(source, tag, severity);
+    }
+
+    /// @brief Indicates that the suppressed entry counts should be reported.
+    /// @see take_suppressed
+    auto should_report() noexcept -> bool;
+
+    /// @brief Returns the non-zero suppressed entry counts and resets them.
+    auto take_suppressed() noexcept -> std::vector<log_suppressed_entries>;
+
+private:
+    using _clock = std::chrono::steady_clock;
+    using _key_t = std::tuple<identifier_t, identifier_t>;
+
+    // generic cell rate algorithm, equivalent to a token bucket
+    // but with the whole bucket state kept in a single atomic
+    struct _state {
+        _state(const log_rate_limit) noexcept;
+        auto check(const log_event_severity severity) noexcept -> bool;
+
+        const log_rate_limit limit;
+        const _clock::rep interval;
+        const _clock::rep tolerance;
+        std::atomic<_clock::rep> arrival{0};
+        std::atomic<std::uint64_t> sampled{0U};
+        std::atomic<std::uint64_t> suppressed{0U};
+    };
+
+    // limits resolved for the (source, tag) pairs seen so far,
+    // including null for the ones that are not limited
+    struct _shard {
+        std::shared_mutex mutex;
+        std::map<_key_t, std::shared_ptr<_state>> resolved;
+    };
+    static constexpr const std::size_t _shard_count{16U};
+
+    auto _shard_of(const identifier source) noexcept -> _shard&;
+    auto _check(
+      const identifier source,
+      const identifier tag,
+      const log_event_severity severity) noexcept -> bool;
+    auto _resolve(_shard&, const _key_t key) noexcept
+      -> std::shared_ptr<_state>;
+    void _update_flags() noexcept;
+
+    std::mutex _mutex;
+    std::map<_key_t, std::shared_ptr<_state>> _limits;
+    std::array<_shard, _shard_count> _shards;
+    std::atomic<bool> _has_source_limits{false};
+    std::atomic<bool> _has_tag_limits{false};
+    std::atomic<std::uint64_t> _suppressed{0U};
+    std::atomic<std::chrono::seconds::rep> _report_interval{60};
+    std::atomic<_clock::rep> _next_report{0};
+};
+//------------------------------------------------------------------------------
+} // namespace eagine
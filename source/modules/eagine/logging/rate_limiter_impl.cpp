@@ -0,0 +1,261 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module eagine.core.logging;
+
+import std;
+import eagine.core.types;
+import eagine.core.memory;
+import eagine.core.string;
+import eagine.core.identifier;
+import eagine.core.reflection;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+log_rate_limiter::_state::_state(const log_rate_limit l) noexcept
+  : limit{[&] {
+      auto result{l};
+      result.burst = std::max(l.burst, 1.F);
+      result.sample_every = std::max(l.sample_every, 1U);
+      return result;
+  }()}
+  , interval{
+      limit.rate > 0.F
+        ? std::chrono::duration_cast<_clock::duration>(
+            std::chrono::duration<float>{1.F / limit.rate})
+            .count()
+        : 0}
+  , tolerance{_clock::rep(float(interval) * (limit.burst - 1.F))} {}
+//------------------------------------------------------------------------------
+auto log_rate_limiter::_state::check(
+  const log_event_severity severity) noexcept -> bool {
+    if(severity > limit.max_severity) {
+        return true;
+    }
+    if(interval > 0) {
+        const auto now{_clock::now().time_since_epoch().count()};
+        auto expected{arrival.load(std::memory_order_relaxed)};
+        while(true) {
+            const auto start{std::max(expected, now)};
+            if(start - now > tolerance) {
+                suppressed.fetch_add(1U, std::memory_order_relaxed);
+                return false;
+            }
+            if(arrival.compare_exchange_weak(
+                 expected, start + interval, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+    }
+    if(limit.sample_every > 1U) {
+        const auto nth{sampled.fetch_add(1U, std::memory_order_relaxed)};
+        if(nth % limit.sample_every != 0U) {
+            suppressed.fetch_add(1U, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+void log_rate_limiter::_update_flags() noexcept {
+    for(auto& shard : _shards) {
+        const std::unique_lock lock{shard.mutex};
+        shard.resolved.clear();
+    }
+    bool has_source_limits{false};
+    bool has_tag_limits{false};
+    for(const auto& entry : _limits) {
+        if(std::get<1>(entry.first) == identifier_t{}) {
+            has_source_limits = true;
+        } else {
+            has_tag_limits = true;
+        }
+    }
+    _has_source_limits.store(has_source_limits, std::memory_order_relaxed);
+    _has_tag_limits.store(has_tag_limits, std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+void log_rate_limiter::set_limit(
+  const identifier source,
+  const identifier tag,
+  const log_rate_limit limit) noexcept {
+    try {
+        const std::lock_guard lock{_mutex};
+        auto& state{_limits[_key_t{source.value(), tag.value()}]};
+        auto suppressed{
+          state ? state->suppressed.load(std::memory_order_relaxed) : 0U};
+        state = std::make_shared<_state>(limit);
+        state->suppressed.store(suppressed, std::memory_order_relaxed);
+        _update_flags();
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+void log_rate_limiter::remove_limit(
+  const identifier source,
+  const identifier tag) noexcept {
+    const std::lock_guard lock{_mutex};
+    _limits.erase(_key_t{source.value(), tag.value()});
+    _update_flags();
+}
+//------------------------------------------------------------------------------
+void log_rate_limiter::clear() noexcept {
+    const std::lock_guard lock{_mutex};
+    _limits.clear();
+    _update_flags();
+}
+//------------------------------------------------------------------------------
+auto log_rate_limiter::set_limits(const string_view spec) noexcept -> bool {
+    const auto parse_id{[](string_view str, identifier& id) {
+        if(str == string_view{"*"}) {
+            id = {};
+            return true;
+        }
+        if(identifier::can_be_encoded(str)) {
+            id = identifier{str};
+            return true;
+        }
+        return false;
+    }};
+
+    bool result{true};
+    for_each_delimited(spec, string_view{";"}, [&](string_view entry) {
+        if(entry.empty()) {
+            return;
+        }
+        const auto [ids, params]{split_by_first(entry, string_view{":"})};
+        const auto [src_str, tag_str]{split_by_first(ids, string_view{"/"})};
+        identifier source;
+        identifier tag;
+        if(not parse_id(src_str, source) or not parse_id(tag_str, tag)) {
+            result = false;
+            return;
+        }
+        log_rate_limit limit{};
+        bool valid{true};
+        for_each_delimited(params, string_view{","}, [&](string_view param) {
+            const auto [name, value]{split_by_first(param, string_view{"="})};
+            if(name == string_view{"rate"}) {
+                if(const auto rate{from_string<float>(value)}) {
+                    limit.rate = *rate;
+                    return;
+                }
+            } else if(name == string_view{"burst"}) {
+                if(const auto burst{from_string<float>(value)}) {
+                    limit.burst = *burst;
+                    return;
+                }
+            } else if(name == string_view{"every"}) {
+                if(const auto every{from_string<std::uint32_t>(value)}) {
+                    limit.sample_every = *every;
+                    return;
+                }
+            } else if(name == string_view{"severity"}) {
+                if(const auto sev{from_string<log_event_severity>(value)}) {
+                    limit.max_severity = *sev;
+                    return;
+                }
+            }
+            valid = false;
+        });
+        // partially parsed limits are not applied
+        if(valid) {
+            set_limit(source, tag, limit);
+        } else {
+            result = false;
+        }
+    });
+    return result;
+}
+//------------------------------------------------------------------------------
+auto log_rate_limiter::_shard_of(const identifier source) noexcept
+  -> _shard& {
+    const auto hash{source.value() * 0x9E37'79B9'7F4A'7C15U};
+    return _shards[std::size_t(hash >> 32U) % _shard_count];
+}
+//------------------------------------------------------------------------------
+auto log_rate_limiter::_resolve(_shard& shard, const _key_t key) noexcept
+  -> std::shared_ptr<_state> {
+    const std::lock_guard lock{_mutex};
+    auto pos{_limits.find(key)};
+    if(pos == _limits.end()) {
+        pos = _limits.find(_key_t{identifier_t{}, std::get<1>(key)});
+    }
+    std::shared_ptr<_state> state;
+    if(pos != _limits.end()) {
+        state = pos->second;
+    }
+    try {
+        const std::unique_lock shard_lock{shard.mutex};
+        shard.resolved.try_emplace(key, state);
+    } catch(...) {
+    }
+    return state;
+}
+//------------------------------------------------------------------------------
+auto log_rate_limiter::_check(
+  const identifier source,
+  const identifier tag,
+  const log_event_severity severity) noexcept -> bool {
+    const auto passes{[&](_state* state) {
+        if(not state or state->check(severity)) {
+            return true;
+        }
+        _suppressed.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }};
+    auto& shard{_shard_of(source)};
+    const _key_t key{source.value(), tag.value()};
+    {
+        const std::shared_lock lock{shard.mutex};
+        const auto pos{shard.resolved.find(key)};
+        if(pos != shard.resolved.end()) {
+            return passes(pos->second.get());
+        }
+    }
+    return passes(_resolve(shard, key).get());
+}
+//------------------------------------------------------------------------------
+auto log_rate_limiter::should_report() noexcept -> bool {
+    if(_suppressed.load(std::memory_order_relaxed) == 0U) {
+        return false;
+    }
+    const auto now{_clock::now().time_since_epoch().count()};
+    auto next{_next_report.load(std::memory_order_relaxed)};
+    if(now < next) {
+        return false;
+    }
+    const std::chrono::seconds interval{
+      _report_interval.load(std::memory_order_relaxed)};
+    const auto then{now + std::chrono::duration_cast<_clock::duration>(interval)
+                            .count()};
+    return _next_report.compare_exchange_strong(
+      next, then, std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+auto log_rate_limiter::take_suppressed() noexcept
+  -> std::vector<log_suppressed_entries> {
+    std::vector<log_suppressed_entries> result;
+    try {
+        const std::lock_guard lock{_mutex};
+        _suppressed.store(0U, std::memory_order_relaxed);
+        for(auto& [key, state] : _limits) {
+            const auto count{
+              state->suppressed.exchange(0U, std::memory_order_relaxed)};
+            if(count > 0U) {
+                result.push_back(
+                  {.source = identifier{std::get<0>(key)},
+                   .tag = identifier{std::get<1>(key)},
+                   .count = count});
+            }
+        }
+    } catch(...) {
+    }
+    return result;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
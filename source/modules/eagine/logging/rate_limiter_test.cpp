@@ -0,0 +1,157 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin.hpp>
+import std;
+import eagine.core.identifier;
+import eagine.core.logging;
+//------------------------------------------------------------------------------
+void rate_limiter_none(auto& s) {
+    eagitest::case_ test{s, 1, "no limits"};
+
+    using les = eagine::log_event_severity;
+    eagine::log_rate_limiter limiter;
+
+    test.check(not limiter.has_source_limits(), "no source limits");
+    test.check(not limiter.has_tag_limits(), "no tag limits");
+    for(int i = 0; i < 100; ++i) {
+        test.check(limiter.should_log("Source", les::debug), "source");
+        test.check(limiter.should_log("Source", "tag", les::debug), "tag");
+    }
+    test.check(not limiter.should_report(), "nothing to report");
+}
+//------------------------------------------------------------------------------
+void rate_limiter_sampling(auto& s) {
+    eagitest::case_ test{s, 2, "sampling"};
+
+    using les = eagine::log_event_severity;
+    eagine::log_rate_limiter limiter;
+    limiter.set_limit("Source", {}, {.sample_every = 10U});
+    test.check(limiter.has_source_limits(), "has source limits");
+
+    int passed{0};
+    for(int i = 0; i < 1000; ++i) {
+        if(limiter.should_log("Source", les::debug)) {
+            ++passed;
+        }
+    }
+    test.check_equal(passed, 100, "1 in 10");
+
+    for(int i = 0; i < 100; ++i) {
+        test.check(limiter.should_log("Other", les::debug), "other source");
+        test.check(limiter.should_log("Source", les::warning), "severity");
+    }
+
+    const auto suppressed{limiter.take_suppressed()};
+    test.ensure(suppressed.size() == 1U, "suppressed");
+    test.check(suppressed.front().source == "Source", "source");
+    test.check_equal(
+      suppressed.front().count, std::uint64_t{900U}, "count");
+    test.check(limiter.take_suppressed().empty(), "reset");
+}
+//------------------------------------------------------------------------------
+void rate_limiter_token_bucket(auto& s) {
+    eagitest::case_ test{s, 3, "token bucket"};
+
+    using les = eagine::log_event_severity;
+    eagine::log_rate_limiter limiter;
+    limiter.set_limit({}, "hotTag", {.rate = 0.001F, .burst = 5.F});
+    test.check(not limiter.has_source_limits(), "no source limits");
+    test.check(limiter.has_tag_limits(), "has tag limits");
+
+    int passed{0};
+    for(int i = 0; i < 100; ++i) {
+        if(limiter.should_log("Source", "hotTag", les::stat)) {
+            ++passed;
+        }
+    }
+    test.check_equal(passed, 5, "burst");
+    test.check(limiter.should_log("Source", "coldTag", les::stat), "other");
+
+    limiter.remove_limit({}, "hotTag");
+    test.check(not limiter.has_tag_limits(), "removed");
+    test.check(limiter.should_log("Source", "hotTag", les::stat), "passes");
+}
+//------------------------------------------------------------------------------
+void rate_limiter_parse(auto& s) {
+    eagitest::case_ test{s, 4, "parse"};
+
+    using les = eagine::log_event_severity;
+    eagine::log_rate_limiter limiter;
+
+    test.check(
+      limiter.set_limits("Source/tag:every=2,severity=info;*:every=3"),
+      "valid");
+    test.check(limiter.has_source_limits(), "source limits");
+    test.check(limiter.has_tag_limits(), "tag limits");
+
+    test.check(limiter.should_log("Source", "tag", les::info), "1st");
+    test.check(not limiter.should_log("Source", "tag", les::info), "2nd");
+    test.check(limiter.should_log("Source", "tag", les::change), "change");
+
+    test.check(limiter.should_log("Any", les::debug), "1st of 3");
+    test.check(not limiter.should_log("Any", les::debug), "2nd of 3");
+    test.check(not limiter.should_log("Any", les::debug), "3rd of 3");
+    test.check(limiter.should_log("Any", les::debug), "4th");
+
+    limiter.clear();
+    test.check(not limiter.set_limits("Source:bogus=1"), "invalid");
+    test.check(not limiter.has_source_limits(), "invalid skipped");
+
+    test.check(
+      not limiter.set_limits("Source:every=2,rate=x;Other:every=2"),
+      "partially invalid");
+    test.check(limiter.should_log("Source", les::debug), "skipped 1st");
+    test.check(limiter.should_log("Source", les::debug), "skipped 2nd");
+    test.check(limiter.should_log("Other", les::debug), "valid 1st");
+    test.check(not limiter.should_log("Other", les::debug), "valid 2nd");
+}
+//------------------------------------------------------------------------------
+void rate_limiter_threads(auto& s) {
+    eagitest::case_ test{s, 5, "threads"};
+
+    using les = eagine::log_event_severity;
+    eagine::log_rate_limiter limiter;
+    limiter.set_limit({}, {}, {.sample_every = 10U});
+
+    std::atomic<int> passed{0};
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&limiter, &passed] {
+            const eagine::identifier sources[2]{"Source1", "Source2"};
+            for(int i = 0; i < 500; ++i) {
+                for(const auto source : sources) {
+                    if(limiter.should_log(source, les::debug)) {
+                        ++passed;
+                    }
+                }
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    test.check_equal(passed.load(), 400, "1 in 10");
+
+    const auto suppressed{limiter.take_suppressed()};
+    test.ensure(suppressed.size() == 1U, "suppressed");
+    test.check_equal(
+      suppressed.front().count, std::uint64_t{3600U}, "count");
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagitest::suite test{argc, argv, "rate_limiter", 5};
+    test.once(rate_limiter_none);
+    test.once(rate_limiter_sampling);
+    test.once(rate_limiter_token_bucket);
+    test.once(rate_limiter_parse);
+    test.once(rate_limiter_threads);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end.hpp>
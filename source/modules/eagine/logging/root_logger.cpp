@@ -12,6 +12,7 @@ import eagine.core.types;
 import eagine.core.identifier;
 import eagine.core.runtime;
 import :backend;
+import :rate_limiter;
 import :logger;
 
 namespace eagine {
@@ -67,6 +68,18 @@ public:
     void make_more_verbose() noexcept;
     void make_less_verbose() noexcept;
 
+    /// @brief Sets the rate limit of entries from the specified source and tag.
+    /// @see log_rate_limiter
+    void set_rate_limit(
+      const identifier source,
+      const identifier tag,
+      const log_rate_limit limit) noexcept;
+
+    /// @brief Removes the rate limit of entries from the source and tag.
+    void remove_rate_limit(
+      const identifier source,
+      const identifier tag) noexcept;
+
 private:
     void _init(root_logger_signals&) noexcept;
     void _reset(root_logger_signals&) noexcept;
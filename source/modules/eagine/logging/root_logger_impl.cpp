@@ -58,6 +58,8 @@ auto root_logger_choose_backend(
         lock_type = log_backend_lock::spinlock;
     } else if(args.has("--log-use-no-lock")) {
         lock_type = log_backend_lock::none;
+    } else if(args.has("--log-use-async")) {
+        lock_type = log_backend_lock::async;
     }
 
     auto format{log_data_format::json};
@@ -65,6 +67,8 @@ auto root_logger_choose_backend(
         format = log_data_format::json;
     } else if(args.has("--log-format-xml")) {
         format = log_data_format::xml;
+    } else if(args.has("--log-format-binary")) {
+        format = log_data_format::binary;
     }
 
     for(auto& arg : args) {
@@ -136,6 +140,28 @@ auto root_logger_init_backend(
             if(assign_if_fits(arg.next(), info.session_identity)) {
                 arg = arg.next();
             }
+        } else if(arg.is_long_tag("log-async-overflow")) {
+            if(assign_if_fits(arg.next(), info.overflow_policy)) {
+                arg = arg.next();
+            }
+        } else if(arg.is_long_tag("log-async-ring-size")) {
+            if(assign_if_fits(arg.next(), info.async_ring_size)) {
+                arg = arg.next();
+            }
+        } else if(arg.is_long_tag("log-background-sender")) {
+            info.background_sender = true;
+        } else if(arg.is_long_tag("log-sender-queue-size")) {
+            if(assign_if_fits(arg.next(), info.sender_queue_size)) {
+                arg = arg.next();
+            }
+        } else if(arg.is_long_tag("log-reconnect-buffer-size")) {
+            if(assign_if_fits(arg.next(), info.reconnect_buffer_size)) {
+                arg = arg.next();
+            }
+        } else if(arg.is_long_tag("log-chart-sample-window")) {
+            if(assign_if_fits(arg.next(), info.chart_sample_window)) {
+                arg = arg.next();
+            }
         }
     }
 
@@ -305,6 +331,23 @@ void root_logger::make_less_verbose() noexcept {
     backend().member(&logger_backend::make_less_verbose);
 }
 //------------------------------------------------------------------------------
+void root_logger::set_rate_limit(
+  const identifier source,
+  const identifier tag,
+  const log_rate_limit limit) noexcept {
+    if(auto limiter{rate_limiter()}) {
+        limiter->set_limit(source, tag, limit);
+    }
+}
+//------------------------------------------------------------------------------
+void root_logger::remove_rate_limit(
+  const identifier source,
+  const identifier tag) noexcept {
+    if(auto limiter{rate_limiter()}) {
+        limiter->remove_limit(source, tag);
+    }
+}
+//------------------------------------------------------------------------------
 static root_logger_signals _root_logger_signals{};
 //------------------------------------------------------------------------------
 root_logger::root_logger(
@@ -312,6 +355,7 @@ root_logger::root_logger(
   const program_args& args,
   root_logger_options& opts) noexcept
   : logger{logger_id, {root_logger_init_backend(args, opts)}} {
+    enable_rate_limiter();
     _init(_root_logger_signals);
     begin_log();
 
@@ -371,6 +371,9 @@ auto make_syslog_log_backend(
             return {hold<syslog_log_backend<std::mutex>>, info};
         case log_backend_lock::spinlock:
             return {hold<syslog_log_backend<spinlock>>, info};
+        case log_backend_lock::async:
+            // syslog does its own buffering, just serialize the callers
+            return {hold<syslog_log_backend<std::mutex>>, info};
     }
 }
 //------------------------------------------------------------------------------
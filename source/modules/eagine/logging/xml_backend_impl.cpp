@@ -34,6 +34,8 @@ auto make_xml_log_backend(
             return {};
         case log_backend_lock::spinlock:
             return {};
+        case log_backend_lock::async:
+            return {};
     }
 }
 //------------------------------------------------------------------------------
@@ -41,7 +41,8 @@ auto main_ctx_object::_make_base(
         return base{obj_id, static_cast<const base&>(parent.object())};
     }
     if(parent.has_context()) {
-        return base{obj_id, parent.context().log().share_backend()};
+        const auto& log{parent.context().log()};
+        return base{obj_id, log.share_backend(), log.share_rate_limiter()};
     }
     return base{obj_id};
 }
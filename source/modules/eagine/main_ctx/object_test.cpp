@@ -0,0 +1,185 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin_ctx.hpp>
+import std;
+import eagine.core.types;
+import eagine.core.memory;
+import eagine.core.identifier;
+import eagine.core.logging;
+import eagine.core.console;
+import eagine.core.main_ctx;
+//------------------------------------------------------------------------------
+namespace eagine {
+static const identifier counted_source{"TestObject"};
+static std::atomic<int> counted_messages{0};
+//------------------------------------------------------------------------------
+// counts the messages from the counted source
+//------------------------------------------------------------------------------
+struct counting_log_backend final : logger_backend {
+
+    auto entry_backend(const log_event_severity) noexcept
+      -> logger_backend* final {
+        return this;
+    }
+
+    auto allocator() noexcept -> memory::shared_byte_allocator final {
+        return {};
+    }
+
+    auto type_id() noexcept -> identifier final {
+        return "Counting";
+    }
+
+    void make_more_verbose() noexcept final {}
+    void make_less_verbose() noexcept final {}
+
+    void begin_log() noexcept final {}
+
+    auto register_time_interval(
+      const identifier tag,
+      const logger_instance_id) noexcept -> time_interval_id final {
+        return 0U;
+    }
+
+    void time_interval_begin(time_interval_id) noexcept final {}
+
+    void time_interval_end(time_interval_id) noexcept final {}
+
+    void set_description(
+      const identifier,
+      const logger_instance_id,
+      const string_view,
+      const string_view) noexcept final {}
+
+    void declare_state(
+      const identifier source,
+      const identifier state_tag,
+      const identifier begin_tag,
+      const identifier end_tag) noexcept final {}
+
+    void active_state(
+      const identifier source,
+      const identifier state_tag) noexcept final {}
+
+    auto begin_message(
+      const identifier source,
+      const identifier,
+      const logger_instance_id,
+      const log_event_severity,
+      const string_view) noexcept -> bool final {
+        if(source == counted_source) {
+            ++counted_messages;
+        }
+        return false;
+    }
+
+    void add_nothing(const identifier, const identifier) noexcept final {}
+
+    void add_identifier(
+      const identifier,
+      const identifier,
+      const identifier) noexcept final {}
+
+    void add_message_id(
+      const identifier,
+      const identifier,
+      const message_id) noexcept final {}
+
+    void add_bool(const identifier, const identifier, const bool) noexcept
+      final {}
+
+    void add_integer(
+      const identifier,
+      const identifier,
+      const std::intmax_t) noexcept final {}
+
+    void add_unsigned(
+      const identifier,
+      const identifier,
+      const std::uintmax_t) noexcept final {}
+
+    void add_float(const identifier, const identifier, const float) noexcept
+      final {}
+
+    void add_float(
+      const identifier,
+      const identifier,
+      const float,
+      const float,
+      const float) noexcept final {}
+
+    void add_duration(
+      const identifier,
+      const identifier,
+      const std::chrono::duration<float>) noexcept final {}
+
+    void add_string(
+      const identifier,
+      const identifier,
+      const string_view) noexcept final {}
+
+    void add_blob(
+      const identifier,
+      const identifier,
+      const memory::const_block) noexcept final {}
+
+    void finish_message() noexcept final {}
+
+    void log_chart_sample(
+      const identifier,
+      const logger_instance_id,
+      const identifier,
+      const float) noexcept final {}
+
+    void heartbeat() noexcept final {}
+
+    void finish_log() noexcept final {}
+};
+} // namespace eagine
+//------------------------------------------------------------------------------
+void main_ctx_object_rate_limit(auto& s) {
+    eagitest::case_ test{s, 1, "rate limit"};
+
+    auto& ctx{s.context()};
+    const auto limiter{ctx.log().rate_limiter()};
+    test.ensure(limiter.has_value(), "has rate limiter");
+    limiter->set_limit(
+      eagine::counted_source,
+      {},
+      {.sample_every = 10U,
+       .max_severity = eagine::log_event_severity::warning});
+
+    eagine::main_ctx_object object{eagine::counted_source, ctx};
+    test.check(object.rate_limiter().has_value(), "object has rate limiter");
+
+    const auto before{eagine::counted_messages.load()};
+    for(int i = 0; i < 100; ++i) {
+        object.log_warning("repeated message");
+    }
+    test.check_equal(
+      eagine::counted_messages.load() - before, 10, "suppressed");
+
+    limiter->remove_limit(eagine::counted_source, {});
+}
+//------------------------------------------------------------------------------
+auto test_main(eagine::test_ctx& ctx) -> int {
+    eagitest::ctx_suite test{ctx, "object", 1};
+    test.once(main_ctx_object_rate_limit);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagine::main_ctx_options options{};
+    options.logger_opts.forced_backend = {
+      eagine::hold<eagine::counting_log_backend>};
+    options.console_opts.forced_backend = eagine::make_null_console_backend();
+    return eagine::main_impl(argc, argv, options, test_main);
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end_ctx.hpp>
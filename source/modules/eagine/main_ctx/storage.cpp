@@ -12,6 +12,7 @@ module;
 export module eagine.core.main_ctx:storage;
 
 import std;
+import eagine.core.build_config;
 import eagine.core.build_info;
 import eagine.core.types;
 import eagine.core.memory;
@@ -199,9 +200,12 @@ public:
     }
 
 private:
+    static auto _make_default_alloc() -> memory::shared_byte_allocator;
+    void _setup_memory_tracking();
+    auto _report_memory_stats() noexcept -> bool;
+
     const process_instance_id_t _instance_id{process_instance_id()};
-    memory::shared_byte_allocator _default_alloc{
-      memory::default_byte_allocator()};
+    memory::shared_byte_allocator _default_alloc{_make_default_alloc()};
     program_args _args;
     build_info _bld_info;
     compiler_info _cmplr_info;
@@ -259,6 +263,80 @@ main_ctx_storage::main_ctx_storage(
     _log_root.info("using ${init} to initialize random generator")
       .tag("rndGenSeed")
       .arg("init", _rand_init);
+
+    _setup_memory_tracking();
+}
+//------------------------------------------------------------------------------
+auto main_ctx_storage::_make_default_alloc() -> memory::shared_byte_allocator {
+    if constexpr(low_profile_build) {
+        return {memory::default_byte_allocator()};
+    } else {
+        return {
+          hold<memory::tracking_byte_allocator>,
+          "mainCtx",
+          memory::shared_byte_allocator{memory::default_byte_allocator()}};
+    }
+}
+//------------------------------------------------------------------------------
+void main_ctx_storage::_setup_memory_tracking() {
+    if constexpr(not low_profile_build) {
+        const auto sampling{_app_config.get<std::uint32_t>(
+          "application.memory.stack_sample_interval")};
+        if(sampling) {
+            memory::set_tracking_stack_sampling(*sampling);
+        }
+        const auto interval{
+          _app_config.get<float>("application.memory.report_interval")};
+        if(interval and (*interval > 0.F)) {
+            _scheduler.schedule_repeated(
+              "memStats",
+              std::chrono::duration_cast<action_scheduler::duration_type>(
+                std::chrono::duration<float>(*interval)),
+              [this] { return _report_memory_stats(); });
+        }
+    }
+}
+//------------------------------------------------------------------------------
+auto main_ctx_storage::_report_memory_stats() noexcept -> bool {
+    try {
+        const bool to_console{
+          _app_config.get<bool>("application.memory.console_stats")
+            .value_or(false)};
+        for(const auto& stats : memory::tracking_allocator_stats()) {
+            _log_root.stat("allocator ${name}: ${liveBytes} live")
+              .tag("memStats")
+              .arg("name", stats.name)
+              .arg("liveBytes", "ByteSize", stats.live_bytes)
+              .arg("peakBytes", "ByteSize", stats.peak_bytes)
+              .arg("allocCount", stats.allocations)
+              .arg("freeCount", stats.deallocations)
+              .arg("reallocCnt", stats.reallocations)
+              .arg("failCount", stats.failures)
+              .arg("sizeHisto", memory::view(stats.size_histogram));
+            for(const auto& sample : stats.stack_samples) {
+                _log_root.stat("sampled ${size} allocation in ${name}")
+                  .tag("memSample")
+                  .arg("name", stats.name)
+                  .arg("size", "ByteSize", sample.size)
+                  .arg("stack", sample.stack);
+            }
+            if(to_console) {
+                _console
+                  .print(
+                    "Memory",
+                    "${name}: ${live} bytes live, ${peak} peak, "
+                    "${allocs} allocations, ${frees} deallocations")
+                  .arg("name", stats.name)
+                  .arg("live", stats.live_bytes)
+                  .arg("peak", stats.peak_bytes)
+                  .arg("allocs", stats.allocations)
+                  .arg("frees", stats.deallocations);
+            }
+        }
+    } catch(...) {
+        return false;
+    }
+    return true;
 }
 //------------------------------------------------------------------------------
 } // namespace eagine
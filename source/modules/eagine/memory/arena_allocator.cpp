@@ -0,0 +1,245 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+export module eagine.core.memory:arena_allocator;
+
+import std;
+import eagine.core.types;
+import :span;
+import :byte_allocator;
+
+namespace eagine::memory {
+//------------------------------------------------------------------------------
+// arena_byte_allocator
+//------------------------------------------------------------------------------
+/// @brief Growing monotonic arena allocator chaining blocks from upstream.
+/// @ingroup memory
+/// @see concurrent_arena_byte_allocator
+///
+/// Allocations are carved sequentially from chunks obtained from the upstream
+/// allocator. Deallocation of the most recent allocation releases its space,
+/// other deallocations only decrement the count of live allocations and when
+/// it drops to zero the whole arena is rewound. The chunks are kept for reuse
+/// and returned to the upstream allocator in release or in the destructor.
+/// This allocator is not thread-safe.
+export class arena_byte_allocator final : public byte_allocator {
+public:
+    using value_type = byte;
+    using size_type = span_size_t;
+
+    /// @brief Position in the arena, that the arena can be rewound to.
+    /// @see mark
+    /// @see rewind
+    struct marker {
+        span_size_t chunk{0};
+        span_size_t used{0};
+        span_size_t live{0};
+    };
+
+    /// @brief Rewinds the arena to the position at construction when destroyed.
+    class scope {
+    public:
+        scope(arena_byte_allocator& arena) noexcept
+          : _arena{arena}
+          , _marker{arena.mark()} {}
+
+        scope(scope&&) = delete;
+        scope(const scope&) = delete;
+        auto operator=(scope&&) = delete;
+        auto operator=(const scope&) = delete;
+
+        ~scope() noexcept {
+            _arena.rewind(_marker);
+        }
+
+    private:
+        arena_byte_allocator& _arena;
+        const marker _marker;
+    };
+
+    /// @brief Default chunk size.
+    static constexpr const span_size_t default_chunk_size{64 * 1024};
+
+    /// @brief Construction with upstream allocator and chunk size.
+    arena_byte_allocator(
+      shared_byte_allocator upstream,
+      span_size_t chunk_size = default_chunk_size) noexcept;
+
+    /// @brief Construction using the default shared allocator as upstream.
+    arena_byte_allocator() noexcept;
+
+    arena_byte_allocator(arena_byte_allocator&&) noexcept = default;
+    arena_byte_allocator(const arena_byte_allocator&) = delete;
+    auto operator=(arena_byte_allocator&&) = delete;
+    auto operator=(const arena_byte_allocator&) = delete;
+    ~arena_byte_allocator() noexcept final;
+
+    auto equal(byte_allocator* a) const noexcept -> bool final {
+        return a == this;
+    }
+
+    auto max_size(size_type a) noexcept -> size_type final {
+        return _upstream.max_size(a) > a ? _upstream.max_size(a) - a : 0;
+    }
+
+    auto has_allocated(const owned_block& b, size_type) noexcept
+      -> tribool final;
+
+    auto allocate(size_type n, size_type a) noexcept -> owned_block final;
+
+    void deallocate(owned_block&& b, size_type) noexcept final;
+
+    /// @brief Returns the current position in the arena.
+    auto mark() const noexcept -> marker {
+        if(_chunks.empty()) {
+            return {};
+        }
+        return {_current, _chunks[std_size(_current)].used, _live};
+    }
+
+    /// @brief Releases everything allocated after the specified marker.
+    /// @pre The marker was obtained from this arena and was not rewound past.
+    void rewind(const marker&) noexcept;
+
+    /// @brief Releases all allocations but keeps the chunks for reuse.
+    void reset() noexcept {
+        rewind({});
+    }
+
+    /// @brief Releases all allocations and returns the chunks to upstream.
+    void release() noexcept;
+
+    /// @brief Returns the number of allocations that were not deallocated.
+    auto live_count() const noexcept -> span_size_t {
+        return _live;
+    }
+
+    /// @brief Returns the number of used bytes in all chunks, with padding.
+    auto used_size() const noexcept -> span_size_t;
+
+    /// @brief Returns the total size of the chunks obtained from upstream.
+    auto reserved_size() const noexcept -> span_size_t;
+
+    /// @brief Returns the number of chunks obtained from upstream.
+    auto chunk_count() const noexcept -> span_size_t {
+        return span_size(_chunks.size());
+    }
+
+private:
+    struct _chunk {
+        owned_block blk;
+        span_size_t used{0};
+    };
+
+    auto _try_allocate(_chunk&, size_type n, size_type a) noexcept
+      -> owned_block;
+    auto _add_chunk(size_type n, size_type a) noexcept -> bool;
+
+    shared_byte_allocator _upstream;
+    std::vector<_chunk> _chunks;
+    span_size_t _chunk_size;
+    span_size_t _current{0};
+    span_size_t _live{0};
+};
+//------------------------------------------------------------------------------
+// concurrent_arena_byte_allocator
+//------------------------------------------------------------------------------
+/// @brief Arena allocator that can be shared by multiple threads.
+/// @ingroup memory
+/// @see arena_byte_allocator
+///
+/// Each thread allocates from its own arena_byte_allocator sub-arena,
+/// so allocations done by different threads do not contend. Blocks can be
+/// deallocated by any thread. The sub-arena of an exited thread, including
+/// its still live blocks, is handed over to the next thread that starts
+/// using the allocator, so the number of sub-arenas is bounded by the number
+/// of threads using the allocator at the same time. Use
+/// basic_shared_byte_alloc constructed with
+/// hold<concurrent_arena_byte_allocator> to share an instance.
+export class concurrent_arena_byte_allocator final : public byte_allocator {
+public:
+    using value_type = byte;
+    using size_type = span_size_t;
+
+    /// @brief Construction with upstream allocator and sub-arena chunk size.
+    concurrent_arena_byte_allocator(
+      shared_byte_allocator upstream,
+      span_size_t chunk_size =
+        arena_byte_allocator::default_chunk_size) noexcept;
+
+    /// @brief Construction using the default shared allocator as upstream.
+    concurrent_arena_byte_allocator() noexcept;
+
+    concurrent_arena_byte_allocator(concurrent_arena_byte_allocator&&) = delete;
+    concurrent_arena_byte_allocator(const concurrent_arena_byte_allocator&) =
+      delete;
+    auto operator=(concurrent_arena_byte_allocator&&) = delete;
+    auto operator=(const concurrent_arena_byte_allocator&) = delete;
+    ~concurrent_arena_byte_allocator() noexcept final = default;
+
+    auto equal(byte_allocator* a) const noexcept -> bool final {
+        return a == this;
+    }
+
+    auto max_size(size_type a) noexcept -> size_type final {
+        return _upstream.max_size(a) > a ? _upstream.max_size(a) - a : 0;
+    }
+
+    auto has_allocated(const owned_block& b, size_type) noexcept
+      -> tribool final;
+
+    auto allocate(size_type n, size_type a) noexcept -> owned_block final;
+
+    void deallocate(owned_block&& b, size_type) noexcept final;
+
+    /// @brief Releases all allocations in all sub-arenas, keeping the chunks.
+    /// @pre No other thread is using this allocator.
+    void reset() noexcept;
+
+    /// @brief Releases all allocations and returns the chunks to upstream.
+    /// @pre No other thread is using this allocator.
+    void release() noexcept;
+
+    /// @brief Returns the number of per-thread sub-arenas, including unused.
+    auto sub_arena_count() const noexcept -> span_size_t;
+
+    /// @brief Returns the total size of the chunks in all sub-arenas.
+    auto reserved_size() const noexcept -> span_size_t;
+
+private:
+    struct _sub_arena {
+        _sub_arena(const shared_byte_allocator&, span_size_t) noexcept;
+
+        std::mutex mutex;
+        arena_byte_allocator arena;
+    };
+
+    // outlives the allocator if some thread cache still refers to it
+    struct _arena_list {
+        auto acquire(const shared_byte_allocator&, span_size_t) noexcept
+          -> _sub_arena*;
+        void give_back(_sub_arena*) noexcept;
+
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<_sub_arena>> all;
+        std::vector<_sub_arena*> unused;
+    };
+
+    struct _thread_cache;
+
+    auto _this_thread_arena() noexcept -> _sub_arena*;
+    auto _owner_of(const owned_block&) noexcept -> _sub_arena*;
+
+    static auto _next_id() noexcept -> std::uint64_t;
+
+    const std::uint64_t _id{_next_id()};
+    shared_byte_allocator _upstream;
+    const span_size_t _chunk_size;
+    const std::shared_ptr<_arena_list> _arenas;
+};
+//------------------------------------------------------------------------------
+} // namespace eagine::memory
@@ -0,0 +1,374 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module;
+
+#include <cassert>
+
+module eagine.core.memory;
+
+import std;
+import eagine.core.types;
+
+namespace eagine::memory {
+//------------------------------------------------------------------------------
+// arena_byte_allocator
+//------------------------------------------------------------------------------
+arena_byte_allocator::arena_byte_allocator(
+  shared_byte_allocator upstream,
+  span_size_t chunk_size) noexcept
+  : _upstream{std::move(upstream)}
+  , _chunk_size{chunk_size} {
+    assert(_chunk_size > 0);
+}
+//------------------------------------------------------------------------------
+arena_byte_allocator::arena_byte_allocator() noexcept
+  : arena_byte_allocator{default_shared_allocator()} {}
+//------------------------------------------------------------------------------
+arena_byte_allocator::~arena_byte_allocator() noexcept {
+    release();
+}
+//------------------------------------------------------------------------------
+auto arena_byte_allocator::has_allocated(
+  const owned_block& b,
+  size_type) noexcept -> tribool {
+    if(b.empty()) {
+        return indeterminate;
+    }
+    for(const auto& chunk : _chunks) {
+        if(const_block{chunk.blk.data(), chunk.used}.contains(b)) {
+            return true;
+        }
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto arena_byte_allocator::_try_allocate(
+  _chunk& chunk,
+  size_type n,
+  size_type a) noexcept -> owned_block {
+    const auto mis{misalignment(chunk.blk.data() + chunk.used, a)};
+    const auto pad{mis ? a - mis : 0};
+    if(pad + n > chunk.blk.size() - chunk.used) {
+        return {};
+    }
+    const auto ptr{chunk.blk.data() + chunk.used + pad};
+    chunk.used += pad + n;
+    ++_live;
+    return acquire_block({ptr, n});
+}
+//------------------------------------------------------------------------------
+auto arena_byte_allocator::_add_chunk(size_type n, size_type a) noexcept
+  -> bool {
+    try {
+        _chunks.reserve(_chunks.size() + 1U);
+    } catch(...) {
+        return false;
+    }
+    auto blk{_upstream.allocate(
+      std::max(_chunk_size, safe_add(n, a)),
+      span_align_of<std::max_align_t>())};
+    if(blk.empty()) [[unlikely]] {
+        return false;
+    }
+    _chunks.push_back({.blk = std::move(blk), .used = 0});
+    _current = span_size(_chunks.size() - 1U);
+    return true;
+}
+//------------------------------------------------------------------------------
+auto arena_byte_allocator::allocate(size_type n, size_type a) noexcept
+  -> owned_block {
+    assert(a > 0);
+    if(n <= 0) [[unlikely]] {
+        return {};
+    }
+    while(std_size(_current) < _chunks.size()) {
+        if(auto b{_try_allocate(_chunks[std_size(_current)], n, a)}) {
+            return b;
+        }
+        if(std_size(_current) + 1U == _chunks.size()) {
+            break;
+        }
+        // chunks past the current one are not used
+        ++_current;
+    }
+    if(_add_chunk(n, a)) [[likely]] {
+        return _try_allocate(_chunks.back(), n, a);
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
+void arena_byte_allocator::deallocate(owned_block&& b, size_type) noexcept {
+    if(b.empty()) [[unlikely]] {
+        return;
+    }
+    assert(has_allocated(b, 0));
+    assert(_live > 0);
+    if(--_live == 0) {
+        reset();
+    } else if(not _chunks.empty()) {
+        auto& chunk{_chunks[std_size(_current)]};
+        if(b.end() == chunk.blk.data() + chunk.used) {
+            chunk.used = b.data() - chunk.blk.data();
+        }
+    }
+    release_block(std::move(b));
+}
+//------------------------------------------------------------------------------
+void arena_byte_allocator::rewind(const marker& m) noexcept {
+    if(_chunks.empty()) {
+        return;
+    }
+    assert(m.chunk <= _current);
+    for(auto c{m.chunk}; c <= _current; ++c) {
+        _chunks[std_size(c)].used = 0;
+    }
+    _chunks[std_size(m.chunk)].used = m.used;
+    _current = m.chunk;
+    _live = m.live;
+}
+//------------------------------------------------------------------------------
+void arena_byte_allocator::release() noexcept {
+    for(auto& chunk : _chunks) {
+        _upstream.deallocate(
+          std::move(chunk.blk), span_align_of<std::max_align_t>());
+    }
+    _chunks.clear();
+    _current = 0;
+    _live = 0;
+}
+//------------------------------------------------------------------------------
+auto arena_byte_allocator::used_size() const noexcept -> span_size_t {
+    span_size_t result{0};
+    for(const auto& chunk : _chunks) {
+        result += chunk.used;
+    }
+    return result;
+}
+//------------------------------------------------------------------------------
+auto arena_byte_allocator::reserved_size() const noexcept -> span_size_t {
+    span_size_t result{0};
+    for(const auto& chunk : _chunks) {
+        result += chunk.blk.size();
+    }
+    return result;
+}
+//------------------------------------------------------------------------------
+// concurrent_arena_byte_allocator
+//------------------------------------------------------------------------------
+concurrent_arena_byte_allocator::_sub_arena::_sub_arena(
+  const shared_byte_allocator& upstream,
+  span_size_t chunk_size) noexcept
+  : arena{upstream, chunk_size} {}
+//------------------------------------------------------------------------------
+auto concurrent_arena_byte_allocator::_arena_list::acquire(
+  const shared_byte_allocator& upstream,
+  span_size_t chunk_size) noexcept -> _sub_arena* {
+    const std::lock_guard lock{mutex};
+    if(not unused.empty()) {
+        auto* sub{unused.back()};
+        unused.pop_back();
+        return sub;
+    }
+    try {
+        // give_back must not allocate
+        unused.reserve(all.size() + 1U);
+        return all
+          .emplace_back(std::make_unique<_sub_arena>(upstream, chunk_size))
+          .get();
+    } catch(...) {
+        return nullptr;
+    }
+}
+//------------------------------------------------------------------------------
+void concurrent_arena_byte_allocator::_arena_list::give_back(
+  _sub_arena* sub) noexcept {
+    const std::lock_guard lock{mutex};
+    unused.push_back(sub);
+}
+//------------------------------------------------------------------------------
+// the sub-arenas used by the current thread, keyed by the allocator id,
+// handed back to the allocators when the thread exits
+struct concurrent_arena_byte_allocator::_thread_cache {
+    struct entry {
+        std::uint64_t id;
+        _sub_arena* sub;
+        std::weak_ptr<_arena_list> arenas;
+    };
+
+    _thread_cache() noexcept = default;
+    _thread_cache(_thread_cache&&) = delete;
+    _thread_cache(const _thread_cache&) = delete;
+    auto operator=(_thread_cache&&) = delete;
+    auto operator=(const _thread_cache&) = delete;
+
+    ~_thread_cache() noexcept {
+        for(auto& e : entries) {
+            if(const auto arenas{e.arenas.lock()}) {
+                arenas->give_back(e.sub);
+            }
+        }
+        entries.clear();
+        destroyed = true;
+    }
+
+    auto find(const std::uint64_t id) noexcept -> _sub_arena* {
+        for(auto pos{entries.begin()}; pos != entries.end(); ++pos) {
+            if(pos->id == id) {
+                // keep the most recently used allocator first
+                std::iter_swap(entries.begin(), pos);
+                return entries.front().sub;
+            }
+        }
+        return nullptr;
+    }
+
+    auto insert(
+      const std::uint64_t id,
+      _sub_arena* sub,
+      const std::shared_ptr<_arena_list>& arenas) noexcept -> bool {
+        std::erase_if(
+          entries, [](const auto& e) { return e.arenas.expired(); });
+        try {
+            entries.push_back({.id = id, .sub = sub, .arenas = arenas});
+            std::swap(entries.front(), entries.back());
+            return true;
+        } catch(...) {
+            return false;
+        }
+    }
+
+    std::vector<entry> entries;
+    // set after the destructor ran, for allocations during thread exit
+    static thread_local bool destroyed;
+};
+//------------------------------------------------------------------------------
+thread_local bool concurrent_arena_byte_allocator::_thread_cache::destroyed{
+  false};
+//------------------------------------------------------------------------------
+concurrent_arena_byte_allocator::concurrent_arena_byte_allocator(
+  shared_byte_allocator upstream,
+  span_size_t chunk_size) noexcept
+  : _upstream{std::move(upstream)}
+  , _chunk_size{chunk_size}
+  , _arenas{std::make_shared<_arena_list>()} {}
+//------------------------------------------------------------------------------
+concurrent_arena_byte_allocator::concurrent_arena_byte_allocator() noexcept
+  : concurrent_arena_byte_allocator{default_shared_allocator()} {}
+//------------------------------------------------------------------------------
+auto concurrent_arena_byte_allocator::_next_id() noexcept -> std::uint64_t {
+    static std::atomic<std::uint64_t> id{0U};
+    return ++id;
+}
+//------------------------------------------------------------------------------
+auto concurrent_arena_byte_allocator::_this_thread_arena() noexcept
+  -> _sub_arena* {
+    if(_thread_cache::destroyed) [[unlikely]] {
+        // the thread is exiting, share some arena without keeping it
+        auto* sub{_arenas->acquire(_upstream, _chunk_size)};
+        if(sub) {
+            _arenas->give_back(sub);
+        }
+        return sub;
+    }
+    // the unique instance id is never reused, so a stale cache entry
+    // of a destroyed allocator is never matched
+    static thread_local _thread_cache cache;
+    if(auto* sub{cache.find(_id)}) [[likely]] {
+        return sub;
+    }
+    auto* sub{_arenas->acquire(_upstream, _chunk_size)};
+    if(sub and not cache.insert(_id, sub, _arenas)) [[unlikely]] {
+        _arenas->give_back(sub);
+    }
+    return sub;
+}
+//------------------------------------------------------------------------------
+auto concurrent_arena_byte_allocator::_owner_of(const owned_block& b) noexcept
+  -> _sub_arena* {
+    const std::lock_guard lock{_arenas->mutex};
+    for(auto& sub : _arenas->all) {
+        const std::lock_guard sub_lock{sub->mutex};
+        if(sub->arena.has_allocated(b, 0)) {
+            return sub.get();
+        }
+    }
+    return nullptr;
+}
+//------------------------------------------------------------------------------
+auto concurrent_arena_byte_allocator::has_allocated(
+  const owned_block& b,
+  size_type) noexcept -> tribool {
+    if(b.empty()) {
+        return indeterminate;
+    }
+    return _owner_of(b) != nullptr;
+}
+//------------------------------------------------------------------------------
+auto concurrent_arena_byte_allocator::allocate(
+  size_type n,
+  size_type a) noexcept -> owned_block {
+    if(auto* sub{_this_thread_arena()}) [[likely]] {
+        const std::lock_guard lock{sub->mutex};
+        return sub->arena.allocate(n, a);
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
+void concurrent_arena_byte_allocator::deallocate(
+  owned_block&& b,
+  size_type a) noexcept {
+    if(b.empty()) [[unlikely]] {
+        return;
+    }
+    if(auto* sub{_this_thread_arena()}) [[likely]] {
+        const std::lock_guard lock{sub->mutex};
+        if(sub->arena.has_allocated(b, a)) [[likely]] {
+            sub->arena.deallocate(std::move(b), a);
+            return;
+        }
+    }
+    auto* owner{_owner_of(b)};
+    assert(owner);
+    const std::lock_guard lock{owner->mutex};
+    owner->arena.deallocate(std::move(b), a);
+}
+//------------------------------------------------------------------------------
+void concurrent_arena_byte_allocator::reset() noexcept {
+    const std::lock_guard lock{_arenas->mutex};
+    for(auto& sub : _arenas->all) {
+        const std::lock_guard sub_lock{sub->mutex};
+        sub->arena.reset();
+    }
+}
+//------------------------------------------------------------------------------
+void concurrent_arena_byte_allocator::release() noexcept {
+    const std::lock_guard lock{_arenas->mutex};
+    for(auto& sub : _arenas->all) {
+        const std::lock_guard sub_lock{sub->mutex};
+        sub->arena.release();
+    }
+}
+//------------------------------------------------------------------------------
+auto concurrent_arena_byte_allocator::sub_arena_count() const noexcept
+  -> span_size_t {
+    const std::lock_guard lock{_arenas->mutex};
+    return span_size(_arenas->all.size());
+}
+//------------------------------------------------------------------------------
+auto concurrent_arena_byte_allocator::reserved_size() const noexcept
+  -> span_size_t {
+    span_size_t result{0};
+    const std::lock_guard lock{_arenas->mutex};
+    for(const auto& sub : _arenas->all) {
+        const std::lock_guard sub_lock{sub->mutex};
+        result += sub->arena.reserved_size();
+    }
+    return result;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine::memory
@@ -0,0 +1,180 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin.hpp>
+import std;
+import eagine.core.types;
+import eagine.core.memory;
+//------------------------------------------------------------------------------
+void arena_allocator_basic(auto& s) {
+    eagitest::case_ test{s, 1, "basic"};
+    auto& rg{test.random()};
+    using namespace eagine;
+
+    memory::arena_byte_allocator a{memory::default_shared_allocator(), 1024};
+    test.check_equal(a.chunk_count(), 0, "no chunks");
+
+    std::vector<memory::owned_block> blks;
+    for(unsigned i = 0; i < test.repeats(1000); ++i) {
+        const auto sz{rg.get_span_size(1, 256)};
+        const span_size_t ao{span_size_t(1) << rg.get_int(0, 6)};
+        blks.push_back(a.allocate(sz, ao));
+        test.ensure(not blks.back().empty(), "allocated");
+        test.check_equal(blks.back().size(), sz, "size is ok");
+        test.check(is_aligned_to(blks.back().addr(), ao), "is aligned");
+        test.check(bool(a.has_allocated(blks.back(), ao)), "has allocated");
+    }
+    test.check_equal(a.live_count(), span_size(blks.size()), "live count");
+    test.check(a.chunk_count() > 1, "has more chunks");
+
+    auto large{a.allocate(4096, 8)};
+    test.check_equal(large.size(), 4096, "large allocation");
+    a.deallocate(std::move(large), 8);
+
+    std::shuffle(blks.begin(), blks.end(), std::default_random_engine{});
+    for(auto& blk : blks) {
+        a.deallocate(std::move(blk), 1);
+    }
+    test.check_equal(a.live_count(), 0, "nothing live");
+    test.check_equal(a.used_size(), 0, "all rewound");
+
+    const auto reserved{a.reserved_size()};
+    a.deallocate(a.allocate(64, 8), 8);
+    test.check_equal(a.reserved_size(), reserved, "chunks reused");
+
+    a.release();
+    test.check_equal(a.chunk_count(), 0, "released");
+}
+//------------------------------------------------------------------------------
+struct forgotten_block : eagine::memory::block_owner {
+    static void forget(eagine::memory::owned_block&& blk) noexcept {
+        release_block(std::move(blk));
+    }
+};
+//------------------------------------------------------------------------------
+void arena_allocator_scope(auto& s) {
+    eagitest::case_ test{s, 2, "scope"};
+    using namespace eagine;
+
+    memory::arena_byte_allocator a{memory::default_shared_allocator(), 256};
+    auto keep{a.allocate(96, 16)};
+    const auto used{a.used_size()};
+
+    {
+        const memory::arena_byte_allocator::scope scope{a};
+        for(int i = 0; i < 100; ++i) {
+            auto blk{a.allocate(64, 16)};
+            test.check(not blk.empty(), "allocated");
+            a.deallocate(std::move(blk), 16);
+        }
+        test.check_equal(a.used_size(), used, "last one released");
+        for(int i = 0; i < 100; ++i) {
+            auto blk{a.allocate(64, 16)};
+            test.check(not blk.empty(), "allocated");
+            // left to be released by the scope
+            forgotten_block::forget(std::move(blk));
+        }
+        test.check_equal(a.live_count(), 101, "live in scope");
+    }
+
+    test.check_equal(a.live_count(), 1, "rewound live count");
+    test.check_equal(a.used_size(), used, "rewound used size");
+    test.check(bool(a.has_allocated(keep, 16)), "kept");
+    a.deallocate(std::move(keep), 16);
+}
+//------------------------------------------------------------------------------
+void arena_allocator_shared(auto& s) {
+    eagitest::case_ test{s, 3, "shared"};
+    using namespace eagine;
+
+    memory::shared_byte_allocator a{
+      hold<memory::concurrent_arena_byte_allocator>,
+      memory::default_shared_allocator(),
+      4096};
+    test.check(bool(a), "is set");
+    test.check(a == a, "is equal");
+
+    std::atomic<int> errors{0};
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([a, &errors]() mutable {
+            std::vector<memory::owned_block> blks;
+            for(int r = 0; r < 10; ++r) {
+                for(int i = 0; i < 200; ++i) {
+                    blks.push_back(a.allocate(32 + i, 8));
+                    if(blks.back().size() != 32 + i) {
+                        ++errors;
+                    }
+                }
+                for(auto& blk : blks) {
+                    a.deallocate(std::move(blk), 8);
+                }
+                blks.clear();
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    test.check_equal(errors.load(), 0, "no errors");
+
+    auto& arena{a.as<memory::concurrent_arena_byte_allocator>()};
+    test.check(arena.sub_arena_count() > 0, "sub arenas");
+    test.check(arena.reserved_size() > 0, "reserved");
+
+    // deallocation from other thread than the allocating one
+    auto blk{a.allocate(128, 8)};
+    std::thread{[&] { a.deallocate(std::move(blk), 8); }}.join();
+    test.check(blk.empty(), "deallocated");
+
+    arena.release();
+    test.check_equal(arena.reserved_size(), 0, "released");
+}
+//------------------------------------------------------------------------------
+void arena_allocator_reuse(auto& s) {
+    eagitest::case_ test{s, 4, "reuse"};
+    using namespace eagine;
+
+    memory::concurrent_arena_byte_allocator a;
+    memory::concurrent_arena_byte_allocator b;
+
+    std::vector<memory::owned_block> blks;
+    for(int t = 0; t < 8; ++t) {
+        std::thread{[&] {
+            for(int i = 0; i < 10; ++i) {
+                // alternate the allocators used by the same thread
+                blks.push_back(a.allocate(64, 8));
+                blks.push_back(b.allocate(64, 8));
+            }
+        }}.join();
+    }
+    test.check_equal(a.sub_arena_count(), 1, "a reused");
+    test.check_equal(b.sub_arena_count(), 1, "b reused");
+
+    for(std::size_t i = 0; i < blks.size(); ++i) {
+        test.check_equal(blks[i].size(), 64, "allocated");
+        if(i % 2U == 0U) {
+            test.check(bool(a.has_allocated(blks[i], 8)), "from a");
+            a.deallocate(std::move(blks[i]), 8);
+        } else {
+            test.check(bool(b.has_allocated(blks[i], 8)), "from b");
+            b.deallocate(std::move(blks[i]), 8);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagitest::suite test{argc, argv, "arena_allocator", 4};
+    test.once(arena_allocator_basic);
+    test.once(arena_allocator_scope);
+    test.once(arena_allocator_shared);
+    test.once(arena_allocator_reuse);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end.hpp>
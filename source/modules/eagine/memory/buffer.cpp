@@ -250,45 +250,129 @@ export auto append_to(const const_block source, buffer& dest) noexcept
 // buffer pool
 //------------------------------------------------------------------------------
 export class buffer_pool;
+/// @brief Statistics of a single size class of a buffer_pool.
+/// @ingroup memory
+/// @see buffer_pool_stats
+export class buffer_pool_class_stats {
+public:
+    /// @brief Returns the number of buffer requests in this size class.
+    auto number_of_gets() const noexcept -> std::uintmax_t {
+        return _gets.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the number of requests satisfied by a pooled buffer.
+    auto number_of_hits() const noexcept -> std::uintmax_t {
+        return _hits.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the ratio of hits to gets in this size class.
+    auto hit_rate() const noexcept -> float {
+        const auto gets{number_of_gets()};
+        return gets > 0U ? float(number_of_hits()) / float(gets) : 0.F;
+    }
+
+    /// @brief Returns the number of bytes currently retained in this class.
+    auto bytes_retained() const noexcept -> std::size_t {
+        return _bytes.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class buffer_pool;
+    std::atomic<std::uintmax_t> _gets{0U};
+    std::atomic<std::uintmax_t> _hits{0U};
+    std::atomic<std::size_t> _bytes{0U};
+};
+//------------------------------------------------------------------------------
 export class buffer_pool_stats {
 public:
-    auto number_of_gets() const noexcept {
-        return _gets;
+    /// @brief The number of power-of-two buffer size classes.
+    static constexpr const std::size_t size_class_count{26U};
+
+    /// @brief The base-2 logarithm of the capacity of the smallest class.
+    static constexpr const std::size_t min_size_class_bits{4U};
+
+    auto number_of_gets() const noexcept -> std::uintmax_t {
+        return _gets.load(std::memory_order_relaxed);
+    }
+
+    auto number_of_hits() const noexcept -> std::uintmax_t {
+        return _hits.load(std::memory_order_relaxed);
+    }
+
+    auto number_of_eats() const noexcept -> std::uintmax_t {
+        return _eats.load(std::memory_order_relaxed);
     }
 
-    auto number_of_hits() const noexcept {
-        return _hits;
+    auto number_of_discards() const noexcept -> std::uintmax_t {
+        return _dscs.load(std::memory_order_relaxed);
     }
 
-    auto number_of_eats() const noexcept {
-        return _eats;
+    auto max_buffer_count() const noexcept -> std::size_t {
+        return _maxc.load(std::memory_order_relaxed);
     }
 
-    auto number_of_discards() const noexcept {
-        return _dscs;
+    auto max_buffer_size() const noexcept -> std::size_t {
+        return _maxs.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the ratio of hits to gets over all size classes.
+    auto hit_rate() const noexcept -> float {
+        const auto gets{number_of_gets()};
+        return gets > 0U ? float(number_of_hits()) / float(gets) : 0.F;
+    }
+
+    /// @brief Returns the number of bytes retained over all size classes.
+    auto bytes_retained() const noexcept -> std::size_t {
+        std::size_t result{0U};
+        for(const auto& cls : _classes) {
+            result += cls.bytes_retained();
+        }
+        return result;
     }
 
-    auto max_buffer_count() const noexcept {
-        return _maxc;
+    /// @brief Returns the minimum buffer capacity in the specified size class.
+    static constexpr auto size_class_capacity(const std::size_t index) noexcept
+      -> std::size_t {
+        return std::size_t(1U) << (index + min_size_class_bits);
     }
 
-    auto max_buffer_size() const noexcept {
-        return _maxs;
+    /// @brief Returns the statistics of the specified size class.
+    /// @pre index < size_class_count
+    auto size_class(const std::size_t index) const noexcept
+      -> const buffer_pool_class_stats& {
+        return _classes[index];
     }
 
 private:
     friend class buffer_pool;
-    std::uintmax_t _hits{0};
-    std::uintmax_t _gets{0};
-    std::uintmax_t _eats{0};
-    std::uintmax_t _dscs{0};
-    std::size_t _maxc{0};
-    std::size_t _maxs{0};
+
+    static void _update_max(
+      std::atomic<std::size_t>& max,
+      const std::size_t value) noexcept {
+        auto prev{max.load(std::memory_order_relaxed)};
+        while((prev < value) and not max.compare_exchange_weak(
+                                   prev, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::atomic<std::uintmax_t> _hits{0U};
+    std::atomic<std::uintmax_t> _gets{0U};
+    std::atomic<std::uintmax_t> _eats{0U};
+    std::atomic<std::uintmax_t> _dscs{0U};
+    std::atomic<std::size_t> _maxc{0U};
+    std::atomic<std::size_t> _maxs{0U};
+    std::array<buffer_pool_class_stats, size_class_count> _classes{};
 };
 //------------------------------------------------------------------------------
 /// @brief Class storing multiple reusable memory buffer instances.
 /// @ingroup memory
 /// @see buffer
+///
+/// The pooled buffers are sorted into power-of-two capacity size classes,
+/// so that a request is only satisfied by a buffer large enough for it.
+/// The pool is thread-safe. Each thread uses one of several small per-class
+/// magazines selected by the thread id. The magazines are backed by a
+/// shared depot.
 export class buffer_pool {
 public:
     /// @brief Default constructors.
@@ -298,51 +382,25 @@ public:
     explicit buffer_pool(const std::size_t max) noexcept
       : _max{max} {}
 
+    /// @brief Not moveable.
+    buffer_pool(buffer_pool&&) = delete;
+    /// @brief Not copyable.
+    buffer_pool(const buffer_pool&) = delete;
+    /// @brief Not move assignable.
+    auto operator=(buffer_pool&&) = delete;
+    /// @brief Not copy assignable.
+    auto operator=(const buffer_pool&) = delete;
+
+    ~buffer_pool() noexcept = default;
+
     /// @brief Gets a buffer with the specified required size.
     /// @param req_size The returned buffer will have at least this number of bytes.
     /// @see eat
-    auto get(const span_size_t req_size = 0) -> memory::buffer {
-        memory::buffer result{};
-        if constexpr(not low_profile_build) {
-            _stats._maxc = std::max(_stats._maxc, _pool.size());
-            ++_stats._gets;
-        }
-        if(not _pool.empty()) [[likely]] {
-            if constexpr(not low_profile_build) {
-                ++_stats._hits;
-            }
-            result = std::move(_pool.back());
-            _pool.pop_back();
-        }
-        result.resize(req_size);
-        return result;
-    }
+    auto get(const span_size_t req_size = 0) -> memory::buffer;
 
     /// @brief Returns the specified buffer back to the pool for further reuse.
     /// @see get
-    void eat(memory::buffer used) noexcept {
-        if(const auto old_cap{std_size(used.capacity())}; old_cap >= 16)
-          [[likely]] {
-            if(_pool.size() < _max) [[likely]] {
-                try {
-                    _pool.emplace_back(std::move(used));
-                } catch(...) {
-                }
-            } else {
-                if constexpr(not low_profile_build) {
-                    ++_stats._dscs;
-                }
-            }
-            if constexpr(not low_profile_build) {
-                ++_stats._eats;
-                _stats._maxs = std::max(_stats._maxs, old_cap);
-            }
-        } else {
-            if constexpr(not low_profile_build) {
-                ++_stats._dscs;
-            }
-        }
-    }
+    void eat(memory::buffer used) noexcept;
 
     auto eat_later(memory::buffer& buf) noexcept {
         struct _cleanup {
@@ -372,8 +430,30 @@ public:
     }
 
 private:
+    static constexpr const std::size_t _class_count{
+      buffer_pool_stats::size_class_count};
+    static constexpr const std::size_t _shard_count{8U};
+    static constexpr const std::size_t _magazine_size{4U};
+
+    using _buffers_t = std::vector<memory::buffer>;
+    using _classes_t = std::array<_buffers_t, _class_count>;
+
+    struct alignas(64) _magazine {
+        std::mutex mutex;
+        _classes_t classes;
+    };
+
+    static auto _request_class(const span_size_t) noexcept -> std::size_t;
+    static auto _capacity_class(const span_size_t) noexcept -> std::size_t;
+    auto _magazine_of_this_thread() noexcept -> _magazine&;
+    auto _take(const std::size_t cls) noexcept -> std::optional<memory::buffer>;
+    auto _store(const std::size_t cls, memory::buffer&) noexcept -> bool;
+
     std::size_t _max{1024};
-    std::vector<memory::buffer> _pool;
+    std::atomic<std::size_t> _count{0U};
+    std::array<_magazine, _shard_count> _magazines;
+    std::mutex _depot_mutex;
+    _classes_t _depot;
     [[no_unique_address]] not_in_low_profile<buffer_pool_stats> _stats{};
 };
 //------------------------------------------------------------------------------
@@ -0,0 +1,155 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module eagine.core.memory;
+
+import std;
+import eagine.core.build_config;
+import eagine.core.types;
+
+namespace eagine::memory {
+//------------------------------------------------------------------------------
+// buffer_pool
+//------------------------------------------------------------------------------
+auto buffer_pool::_request_class(const span_size_t req_size) noexcept
+  -> std::size_t {
+    constexpr const auto min_bits{buffer_pool_stats::min_size_class_bits};
+    const auto size{std_size(req_size)};
+    if(size <= (std::size_t(1U) << min_bits)) {
+        return 0U;
+    }
+    return std::min(
+      std::size_t(std::bit_width(size - 1U)) - min_bits, _class_count);
+}
+//------------------------------------------------------------------------------
+auto buffer_pool::_capacity_class(const span_size_t capacity) noexcept
+  -> std::size_t {
+    constexpr const auto min_bits{buffer_pool_stats::min_size_class_bits};
+    const auto size{std_size(capacity)};
+    if(size < (std::size_t(1U) << min_bits)) {
+        return _class_count;
+    }
+    return std::min(
+      std::size_t(std::bit_width(size)) - 1U - min_bits, _class_count);
+}
+//------------------------------------------------------------------------------
+auto buffer_pool::_magazine_of_this_thread() noexcept -> _magazine& {
+    static thread_local const std::size_t index{
+      std::hash<std::thread::id>{}(std::this_thread::get_id()) % _shard_count};
+    return _magazines[index];
+}
+//------------------------------------------------------------------------------
+auto buffer_pool::_take(const std::size_t cls) noexcept
+  -> std::optional<memory::buffer> {
+    const auto pop{[&](_buffers_t& buffers, const std::size_t from)
+                     -> std::optional<memory::buffer> {
+        if(buffers.empty()) {
+            return {};
+        }
+        std::optional<memory::buffer> result{std::move(buffers.back())};
+        buffers.pop_back();
+        _count.fetch_sub(1U, std::memory_order_relaxed);
+        if constexpr(not low_profile_build) {
+            _stats._hits.fetch_add(1U, std::memory_order_relaxed);
+            _stats._classes[cls]._hits.fetch_add(1U, std::memory_order_relaxed);
+            _stats._classes[from]._bytes.fetch_sub(
+              std_size(result->capacity()), std::memory_order_relaxed);
+        }
+        return result;
+    }};
+
+    const auto end{std::min(cls + 2U, _class_count)};
+    {
+        auto& magazine{_magazine_of_this_thread()};
+        const std::lock_guard lock{magazine.mutex};
+        for(auto from{cls}; from < end; ++from) {
+            if(auto found{pop(magazine.classes[from], from)}) {
+                return found;
+            }
+        }
+    }
+    const std::lock_guard lock{_depot_mutex};
+    for(auto from{cls}; from < end; ++from) {
+        if(auto found{pop(_depot[from], from)}) {
+            return found;
+        }
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
+auto buffer_pool::_store(const std::size_t cls, memory::buffer& used) noexcept
+  -> bool {
+    try {
+        {
+            auto& magazine{_magazine_of_this_thread()};
+            const std::lock_guard lock{magazine.mutex};
+            auto& buffers{magazine.classes[cls]};
+            if(buffers.size() < _magazine_size) [[likely]] {
+                buffers.push_back(std::move(used));
+                return true;
+            }
+        }
+        const std::lock_guard lock{_depot_mutex};
+        _depot[cls].push_back(std::move(used));
+        return true;
+    } catch(...) {
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto buffer_pool::get(const span_size_t req_size) -> memory::buffer {
+    const auto cls{_request_class(req_size)};
+    if constexpr(not low_profile_build) {
+        buffer_pool_stats::_update_max(
+          _stats._maxc, _count.load(std::memory_order_relaxed));
+        _stats._gets.fetch_add(1U, std::memory_order_relaxed);
+        if(cls < _class_count) {
+            _stats._classes[cls]._gets.fetch_add(1U, std::memory_order_relaxed);
+        }
+    }
+    memory::buffer result{};
+    if(cls < _class_count) [[likely]] {
+        if(auto pooled{_take(cls)}) {
+            result = std::move(*pooled);
+        } else if(req_size > 0) {
+            result.reserve(
+              span_size(buffer_pool_stats::size_class_capacity(cls)));
+        }
+    }
+    result.resize(req_size);
+    return result;
+}
+//------------------------------------------------------------------------------
+void buffer_pool::eat(memory::buffer used) noexcept {
+    const auto capacity{std_size(used.capacity())};
+    const auto cls{_capacity_class(used.capacity())};
+    if(cls < _class_count) [[likely]] {
+        if constexpr(not low_profile_build) {
+            _stats._eats.fetch_add(1U, std::memory_order_relaxed);
+            buffer_pool_stats::_update_max(_stats._maxs, capacity);
+        }
+        if(_count.fetch_add(1U, std::memory_order_relaxed) < _max) [[likely]] {
+            if constexpr(not low_profile_build) {
+                _stats._classes[cls]._bytes.fetch_add(
+                  capacity, std::memory_order_relaxed);
+            }
+            if(_store(cls, used)) [[likely]] {
+                return;
+            }
+            if constexpr(not low_profile_build) {
+                _stats._classes[cls]._bytes.fetch_sub(
+                  capacity, std::memory_order_relaxed);
+            }
+        }
+        _count.fetch_sub(1U, std::memory_order_relaxed);
+    }
+    if constexpr(not low_profile_build) {
+        _stats._dscs.fetch_add(1U, std::memory_order_relaxed);
+    }
+}
+//------------------------------------------------------------------------------
+} // namespace eagine::memory
@@ -7,6 +7,7 @@
 ///
 
 #include <eagine/testing/unit_begin.hpp>
+import std;
 import eagine.core.types;
 import eagine.core.memory;
 //------------------------------------------------------------------------------
@@ -149,12 +150,87 @@ void buffer_enlarge_by(unsigned, auto& s) {
     }
 }
 //------------------------------------------------------------------------------
+void buffer_pool_size_classes(auto& s) {
+    eagitest::case_ test{s, 5, "pool size classes"};
+    using namespace eagine;
+
+    memory::buffer_pool pool;
+
+    auto small{pool.get(100)};
+    test.check_equal(small.size(), 100, "small size");
+    test.check_equal(small.capacity(), 128, "small capacity");
+    auto large{pool.get(5000)};
+    test.check_equal(large.capacity(), 8192, "large capacity");
+
+    pool.eat(std::move(large));
+    pool.eat(std::move(small));
+
+    auto reused{pool.get(120)};
+    test.check_equal(reused.size(), 120, "reused size");
+    test.check_equal(reused.capacity(), 128, "small buffer reused");
+
+    auto other{pool.get(3000)};
+    test.check_equal(other.capacity(), 8192, "larger class reused");
+
+    auto fresh{pool.get(100000)};
+    test.check(fresh.capacity() >= 100000, "fresh capacity");
+
+    if(const auto stats{pool.stats()}) {
+        test.check_equal(stats->number_of_gets(), 5U, "gets");
+        test.check_equal(stats->number_of_hits(), 2U, "hits");
+        test.check_equal(stats->number_of_eats(), 2U, "eats");
+        test.check_equal(stats->bytes_retained(), 0U, "nothing retained");
+        test.check_equal(stats->size_class(3).hit_rate(), 0.5F, "hit rate");
+    }
+
+    pool.eat(std::move(fresh));
+    if(const auto stats{pool.stats()}) {
+        test.check_equal(
+          stats->bytes_retained(),
+          memory::buffer_pool_stats::size_class_capacity(13),
+          "retained");
+    }
+}
+//------------------------------------------------------------------------------
+void buffer_pool_threads(auto& s) {
+    eagitest::case_ test{s, 6, "pool threads"};
+    using namespace eagine;
+
+    memory::buffer_pool pool;
+    std::atomic<int> errors{0};
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, &errors, t] {
+            for(int i = 0; i < 1000; ++i) {
+                const auto size{span_size_t(16 << ((i + t) % 12))};
+                auto buf{pool.get(size)};
+                if(buf.size() != size or buf.capacity() < size) {
+                    ++errors;
+                }
+                pool.eat(std::move(buf));
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    test.check_equal(errors.load(), 0, "no errors");
+    if(const auto stats{pool.stats()}) {
+        test.check_equal(stats->number_of_gets(), 4000U, "gets");
+        test.check(stats->hit_rate() > 0.5F, "hit rate");
+    }
+}
+//------------------------------------------------------------------------------
 auto main(int argc, const char** argv) -> int {
-    eagitest::suite test{argc, argv, "buffer", 4};
+    eagitest::suite test{argc, argv, "buffer", 6};
     test.once(buffer_default_construct);
     test.repeat(10, buffer_resize);
     test.repeat(10, buffer_ensure);
     test.repeat(10, buffer_enlarge_by);
+    test.once(buffer_pool_size_classes);
+    test.once(buffer_pool_threads);
     return test.exit_code();
 }
 //------------------------------------------------------------------------------
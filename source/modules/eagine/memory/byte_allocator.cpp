@@ -159,6 +159,11 @@ public:
     basic_shared_byte_alloc(X&& x) noexcept
       : _pballoc{hold<X>, std::forward<X>(x)} {}
 
+    /// @brief Construction with allocator of type X constructed in-place.
+    template <std::derived_from<byte_allocator> X, typename... Args>
+    basic_shared_byte_alloc(hold_t<X> h, Args&&... args)
+      : _pballoc{h, std::forward<Args>(args)...} {}
+
     auto operator=(basic_shared_byte_alloc&& that) noexcept
       -> basic_shared_byte_alloc& = default;
 
@@ -256,7 +261,7 @@ public:
 
     template <typename ByteAlloc>
     auto as() -> ByteAlloc& {
-        auto* pa = dynamic_cast<ByteAlloc*>(_pballoc);
+        auto* pa = dynamic_cast<ByteAlloc*>(_pballoc.get());
         if(pa == nullptr) [[unlikely]] {
             throw std::bad_cast();
         }
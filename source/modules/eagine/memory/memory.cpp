@@ -28,6 +28,8 @@ export import :flatten;
 export import :edit_distance;
 export import :byte_allocator;
 export import :stack_allocator;
+export import :arena_allocator;
+export import :tracking_allocator;
 export import :std_allocator;
 export import :buffer;
 export import :object_storage;
@@ -7,10 +7,25 @@
 ///
 module eagine.core.memory;
 
+import std;
+import eagine.core.build_config;
+import eagine.core.types;
+
 namespace eagine::memory {
 
+static auto make_default_shared_allocator() -> shared_byte_allocator {
+    if constexpr(low_profile_build) {
+        return {default_byte_allocator()};
+    } else {
+        return {
+          hold<tracking_byte_allocator>,
+          "default",
+          shared_byte_allocator{default_byte_allocator()}};
+    }
+}
+
 auto default_shared_allocator() -> shared_byte_allocator {
-    static const shared_byte_allocator alloc{default_byte_allocator()};
+    static const shared_byte_allocator alloc{make_default_shared_allocator()};
     return alloc;
 }
 
@@ -0,0 +1,167 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+export module eagine.core.memory:tracking_allocator;
+
+import std;
+import eagine.core.types;
+import :span;
+import :byte_allocator;
+
+namespace eagine::memory {
+//------------------------------------------------------------------------------
+/// @brief Stack trace captured for a sampled allocation.
+/// @ingroup memory
+/// @see tracking_byte_allocator
+export struct allocation_stack_sample {
+    /// @brief The size of the sampled allocation.
+    span_size_t size{0};
+    /// @brief The formatted stack trace of the sampled allocation.
+    std::string stack;
+};
+//------------------------------------------------------------------------------
+/// @brief Snapshot of the statistics of a tracking_byte_allocator.
+/// @ingroup memory
+/// @see tracking_byte_allocator
+/// @see tracking_allocator_stats
+export struct allocation_tracking_stats {
+    /// @brief The number of buckets in the allocation size histogram.
+    static constexpr const std::size_t histogram_size{32U};
+
+    /// @brief The name of the tracked allocator.
+    std::string name;
+    /// @brief The number of currently allocated bytes.
+    span_size_t live_bytes{0};
+    /// @brief The maximum number of simultaneously allocated bytes.
+    span_size_t peak_bytes{0};
+    /// @brief The number of successful allocations.
+    std::uint64_t allocations{0U};
+    /// @brief The number of deallocations.
+    std::uint64_t deallocations{0U};
+    /// @brief The number of reallocations.
+    std::uint64_t reallocations{0U};
+    /// @brief The number of failed allocations.
+    std::uint64_t failures{0U};
+    /// @brief Allocation counts, bucket i counts sizes in [2^(i-1), 2^i).
+    std::array<std::uint64_t, histogram_size> size_histogram{};
+    /// @brief The most recent sampled allocation stack traces.
+    std::vector<allocation_stack_sample> stack_samples;
+};
+//------------------------------------------------------------------------------
+/// @brief Byte allocator decorator tracking the allocations of another one.
+/// @ingroup memory
+/// @see allocation_tracking_stats
+/// @see tracking_allocator_stats
+///
+/// Instances register themselves in a process-wide registry, so that the
+/// statistics of all tracked allocators can be reported at once.
+export class tracking_byte_allocator final : public byte_allocator {
+public:
+    using value_type = byte;
+    using size_type = span_size_t;
+
+    /// @brief The maximum number of kept stack trace samples.
+    static constexpr const std::size_t max_stack_samples{16U};
+
+    /// @brief Construction with allocator name and the tracked allocator.
+    tracking_byte_allocator(
+      std::string name,
+      shared_byte_allocator upstream) noexcept;
+
+    tracking_byte_allocator(tracking_byte_allocator&&) = delete;
+    tracking_byte_allocator(const tracking_byte_allocator&) = delete;
+    auto operator=(tracking_byte_allocator&&) = delete;
+    auto operator=(const tracking_byte_allocator&) = delete;
+    ~tracking_byte_allocator() noexcept final;
+
+    /// @brief Returns the name of this allocator.
+    auto name() const noexcept -> string_view {
+        return {_name};
+    }
+
+    auto equal(byte_allocator* a) const noexcept -> bool final {
+        return a == this;
+    }
+
+    auto max_size(size_type a) noexcept -> size_type final {
+        return _upstream.max_size(a);
+    }
+
+    auto has_allocated(const owned_block& b, size_type a) noexcept
+      -> tribool final {
+        return _upstream.has_allocated(b, a);
+    }
+
+    auto allocate(size_type n, size_type a) noexcept -> owned_block final;
+
+    void deallocate(owned_block&& b, size_type a) noexcept final;
+
+    auto can_reallocate(const owned_block& b, size_type n, size_type a) noexcept
+      -> bool final {
+        return _upstream.can_reallocate(b, n, a);
+    }
+
+    auto reallocate(owned_block&& b, size_type n, size_type a) noexcept
+      -> owned_block final;
+
+    /// @brief Returns the number of currently allocated bytes.
+    auto live_bytes() const noexcept -> span_size_t {
+        return _live.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the maximum number of simultaneously allocated bytes.
+    auto peak_bytes() const noexcept -> span_size_t {
+        return _peak.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Captures stack traces of every n-th allocation, zero disables.
+    /// @see can_capture_stacks
+    void set_stack_sampling(std::uint32_t interval) noexcept {
+        _sample_interval.store(interval, std::memory_order_relaxed);
+    }
+
+    /// @brief Indicates if stack traces can be captured in this build.
+    static auto can_capture_stacks() noexcept -> bool;
+
+    /// @brief Returns a snapshot of the statistics of this allocator.
+    auto stats() const -> allocation_tracking_stats;
+
+private:
+    void _on_acquire(span_size_t size) noexcept;
+    void _on_release(span_size_t size) noexcept;
+    void _sample(span_size_t size) noexcept;
+
+    const std::string _name;
+    shared_byte_allocator _upstream;
+    std::atomic<span_size_t> _live{0};
+    std::atomic<span_size_t> _peak{0};
+    std::atomic<std::uint64_t> _allocs{0U};
+    std::atomic<std::uint64_t> _deallocs{0U};
+    std::atomic<std::uint64_t> _reallocs{0U};
+    std::atomic<std::uint64_t> _failures{0U};
+    std::array<
+      std::atomic<std::uint64_t>,
+      allocation_tracking_stats::histogram_size>
+      _histogram{};
+    std::atomic<std::uint32_t> _sample_interval{0U};
+    mutable std::mutex _sample_mutex;
+    std::vector<allocation_stack_sample> _samples;
+    std::size_t _next_sample{0U};
+};
+//------------------------------------------------------------------------------
+/// @brief Returns statistics snapshots of all existing tracking allocators.
+/// @ingroup memory
+/// @see tracking_byte_allocator
+export auto tracking_allocator_stats()
+  -> std::vector<allocation_tracking_stats>;
+
+/// @brief Sets the stack sampling interval in all existing tracking allocators.
+/// @ingroup memory
+/// @see tracking_byte_allocator
+export void set_tracking_stack_sampling(std::uint32_t interval) noexcept;
+//------------------------------------------------------------------------------
+} // namespace eagine::memory
@@ -0,0 +1,193 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module;
+
+#include <version>
+
+#if defined(EAGINE_TRACK_ALLOCATION_STACKS) && defined(__cpp_lib_stacktrace)
+#define EAGINE_MEMORY_CAPTURE_STACKS 1
+#else
+#define EAGINE_MEMORY_CAPTURE_STACKS 0
+#endif
+
+module eagine.core.memory;
+
+import std;
+import eagine.core.types;
+
+namespace eagine::memory {
+//------------------------------------------------------------------------------
+// registry
+//------------------------------------------------------------------------------
+class tracking_allocator_registry {
+public:
+    static auto get() noexcept -> tracking_allocator_registry& {
+        static tracking_allocator_registry registry;
+        return registry;
+    }
+
+    auto add(tracking_byte_allocator& alloc) noexcept -> std::uint32_t {
+        const std::lock_guard lock{_mutex};
+        try {
+            _allocators.push_back(&alloc);
+        } catch(...) {
+        }
+        return _sample_interval;
+    }
+
+    void remove(tracking_byte_allocator& alloc) noexcept {
+        const std::lock_guard lock{_mutex};
+        std::erase(_allocators, &alloc);
+    }
+
+    void set_stack_sampling(std::uint32_t interval) noexcept {
+        const std::lock_guard lock{_mutex};
+        _sample_interval = interval;
+        for(auto* alloc : _allocators) {
+            alloc->set_stack_sampling(interval);
+        }
+    }
+
+    auto stats() -> std::vector<allocation_tracking_stats> {
+        std::vector<allocation_tracking_stats> result;
+        const std::lock_guard lock{_mutex};
+        result.reserve(_allocators.size());
+        for(const auto* alloc : _allocators) {
+            result.push_back(alloc->stats());
+        }
+        return result;
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<tracking_byte_allocator*> _allocators;
+    std::uint32_t _sample_interval{0U};
+};
+//------------------------------------------------------------------------------
+auto tracking_allocator_stats() -> std::vector<allocation_tracking_stats> {
+    return tracking_allocator_registry::get().stats();
+}
+//------------------------------------------------------------------------------
+void set_tracking_stack_sampling(std::uint32_t interval) noexcept {
+    tracking_allocator_registry::get().set_stack_sampling(interval);
+}
+//------------------------------------------------------------------------------
+// tracking_byte_allocator
+//------------------------------------------------------------------------------
+tracking_byte_allocator::tracking_byte_allocator(
+  std::string name,
+  shared_byte_allocator upstream) noexcept
+  : _name{std::move(name)}
+  , _upstream{std::move(upstream)} {
+    set_stack_sampling(tracking_allocator_registry::get().add(*this));
+}
+//------------------------------------------------------------------------------
+tracking_byte_allocator::~tracking_byte_allocator() noexcept {
+    tracking_allocator_registry::get().remove(*this);
+}
+//------------------------------------------------------------------------------
+auto tracking_byte_allocator::can_capture_stacks() noexcept -> bool {
+    return EAGINE_MEMORY_CAPTURE_STACKS != 0;
+}
+//------------------------------------------------------------------------------
+void tracking_byte_allocator::_sample(
+  [[maybe_unused]] span_size_t size) noexcept {
+#if EAGINE_MEMORY_CAPTURE_STACKS
+    try {
+        auto stack{std::to_string(std::stacktrace::current(2U, 32U))};
+        const std::lock_guard lock{_sample_mutex};
+        if(_samples.size() < max_stack_samples) {
+            _samples.push_back({.size = size, .stack = std::move(stack)});
+        } else {
+            _samples[_next_sample] = {.size = size, .stack = std::move(stack)};
+        }
+        _next_sample = (_next_sample + 1U) % max_stack_samples;
+    } catch(...) {
+    }
+#endif
+}
+//------------------------------------------------------------------------------
+void tracking_byte_allocator::_on_acquire(span_size_t size) noexcept {
+    const auto live{_live.fetch_add(size, std::memory_order_relaxed) + size};
+    auto peak{_peak.load(std::memory_order_relaxed)};
+    while(peak < live) {
+        if(_peak.compare_exchange_weak(
+             peak, live, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    const auto bucket{std::min(
+      std::size_t(std::bit_width(std_size(size))),
+      allocation_tracking_stats::histogram_size - 1U)};
+    _histogram[bucket].fetch_add(1U, std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+void tracking_byte_allocator::_on_release(span_size_t size) noexcept {
+    _live.fetch_sub(size, std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+auto tracking_byte_allocator::allocate(size_type n, size_type a) noexcept
+  -> owned_block {
+    auto result{_upstream.allocate(n, a)};
+    if(result) [[likely]] {
+        _on_acquire(result.size());
+        const auto count{_allocs.fetch_add(1U, std::memory_order_relaxed)};
+        const auto interval{_sample_interval.load(std::memory_order_relaxed)};
+        if((interval > 0U) and (count % interval == 0U)) [[unlikely]] {
+            _sample(result.size());
+        }
+    } else if(n > 0) {
+        _failures.fetch_add(1U, std::memory_order_relaxed);
+    }
+    return result;
+}
+//------------------------------------------------------------------------------
+void tracking_byte_allocator::deallocate(
+  owned_block&& b,
+  size_type a) noexcept {
+    if(b) [[likely]] {
+        const auto size{b.size()};
+        _upstream.deallocate(std::move(b), a);
+        _on_release(size);
+        _deallocs.fetch_add(1U, std::memory_order_relaxed);
+    }
+}
+//------------------------------------------------------------------------------
+auto tracking_byte_allocator::reallocate(
+  owned_block&& b,
+  size_type n,
+  size_type a) noexcept -> owned_block {
+    const auto old_size{b.size()};
+    auto result{_upstream.reallocate(std::move(b), n, a)};
+    _on_release(old_size);
+    if(result) {
+        _on_acquire(result.size());
+    }
+    _reallocs.fetch_add(1U, std::memory_order_relaxed);
+    return result;
+}
+//------------------------------------------------------------------------------
+auto tracking_byte_allocator::stats() const -> allocation_tracking_stats {
+    allocation_tracking_stats result{
+      .name = _name,
+      .live_bytes = _live.load(std::memory_order_relaxed),
+      .peak_bytes = _peak.load(std::memory_order_relaxed),
+      .allocations = _allocs.load(std::memory_order_relaxed),
+      .deallocations = _deallocs.load(std::memory_order_relaxed),
+      .reallocations = _reallocs.load(std::memory_order_relaxed),
+      .failures = _failures.load(std::memory_order_relaxed)};
+    for(std::size_t i = 0; i < result.size_histogram.size(); ++i) {
+        result.size_histogram[i] =
+          _histogram[i].load(std::memory_order_relaxed);
+    }
+    const std::lock_guard lock{_sample_mutex};
+    result.stack_samples = _samples;
+    return result;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine::memory
@@ -0,0 +1,112 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin.hpp>
+import std;
+import eagine.core.types;
+import eagine.core.memory;
+//------------------------------------------------------------------------------
+void tracking_allocator_counts(auto& s) {
+    eagitest::case_ test{s, 1, "counts"};
+    auto& rg{test.random()};
+    using namespace eagine;
+
+    memory::tracking_byte_allocator a{
+      "test", memory::shared_byte_allocator{memory::c_byte_reallocator{}}};
+    test.check(a.name() == "test", "name");
+    test.check_equal(a.live_bytes(), 0, "nothing live");
+
+    std::vector<memory::owned_block> blks;
+    span_size_t total{0};
+    for(unsigned i = 0; i < test.repeats(100); ++i) {
+        const auto sz{rg.get_span_size(1, 5000)};
+        blks.push_back(a.allocate(sz, 8));
+        test.ensure(not blks.back().empty(), "allocated");
+        total += blks.back().size();
+    }
+    test.check_equal(a.live_bytes(), total, "live bytes");
+    test.check_equal(a.peak_bytes(), total, "peak bytes");
+
+    const auto stats{a.stats()};
+    test.check(stats.name == "test", "stats name");
+    test.check_equal(stats.allocations, std::uint64_t(blks.size()), "count");
+    test.check_equal(
+      std::accumulate(
+        stats.size_histogram.begin(),
+        stats.size_histogram.end(),
+        std::uint64_t(0U)),
+      std::uint64_t(blks.size()),
+      "histogram");
+
+    for(auto& blk : blks) {
+        a.deallocate(std::move(blk), 8);
+    }
+    test.check_equal(a.live_bytes(), 0, "nothing live");
+    test.check_equal(a.peak_bytes(), total, "peak kept");
+    test.check_equal(
+      a.stats().deallocations, std::uint64_t(blks.size()), "dealloc count");
+}
+//------------------------------------------------------------------------------
+void tracking_allocator_reallocate(auto& s) {
+    eagitest::case_ test{s, 2, "reallocate"};
+    using namespace eagine;
+
+    memory::tracking_byte_allocator a{
+      "realloc", memory::shared_byte_allocator{memory::c_byte_reallocator{}}};
+
+    auto blk{a.allocate(100, 8)};
+    test.check_equal(a.live_bytes(), 100, "allocated");
+    blk = a.reallocate(std::move(blk), 1000, 8);
+    test.check_equal(a.live_bytes(), 1000, "reallocated up");
+    test.check_equal(a.peak_bytes(), 1000, "peak up");
+    blk = a.reallocate(std::move(blk), 10, 8);
+    test.check_equal(a.live_bytes(), 10, "reallocated down");
+    test.check_equal(a.stats().reallocations, std::uint64_t(2U), "count");
+    a.deallocate(std::move(blk), 8);
+    test.check_equal(a.live_bytes(), 0, "deallocated");
+}
+//------------------------------------------------------------------------------
+void tracking_allocator_registry(auto& s) {
+    eagitest::case_ test{s, 3, "registry"};
+    using namespace eagine;
+
+    const auto has{[](string_view name) {
+        const auto all{memory::tracking_allocator_stats()};
+        return std::any_of(all.begin(), all.end(), [&](const auto& stats) {
+            return stats.name == name;
+        });
+    }};
+
+    {
+        memory::shared_byte_allocator a{
+          hold<memory::tracking_byte_allocator>,
+          "registered",
+          memory::shared_byte_allocator{memory::c_byte_reallocator{}}};
+        test.check(has("registered"), "is registered");
+
+        memory::set_tracking_stack_sampling(1U);
+        a.deallocate(a.allocate(64, 8), 8);
+        const auto& tracking{a.as<memory::tracking_byte_allocator>()};
+        test.check_equal(
+          tracking.stats().stack_samples.empty(),
+          not memory::tracking_byte_allocator::can_capture_stacks(),
+          "samples");
+        memory::set_tracking_stack_sampling(0U);
+    }
+    test.check(not has("registered"), "is unregistered");
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagitest::suite test{argc, argv, "tracking_allocator", 3};
+    test.once(tracking_allocator_counts);
+    test.once(tracking_allocator_reallocate);
+    test.once(tracking_allocator_registry);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end.hpp>
@@ -38,16 +38,19 @@ export enum class data_compression_method : std::uint8_t {
     /// @brief No compression.
     none = 1U << 0U,
     /// @brief ZLIB compression.
-    zlib = 1U << 1U
+    zlib = 1U << 1U,
+    /// @brief GZIP compression (for example for HTTP content encoding).
+    gzip = 1U << 2U
 };
 
 export template <>
 struct enumerator_traits<data_compression_method> {
     static constexpr auto mapping() noexcept {
-        return enumerator_map_type<data_compression_method, 3>{
+        return enumerator_map_type<data_compression_method, 4>{
           {{"unknown", data_compression_method::unknown},
            {"none", data_compression_method::none},
-           {"zlib", data_compression_method::zlib}}};
+           {"zlib", data_compression_method::zlib},
+           {"gzip", data_compression_method::gzip}}};
     }
 };
 
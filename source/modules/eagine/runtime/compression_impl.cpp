@@ -233,6 +233,10 @@ static auto zlib_compression_header() noexcept -> memory::const_block {
     static const std::array<byte, 1> header{{0x01U}};
     return view(header);
 }
+static auto gzip_compression_header() noexcept -> memory::const_block {
+    static const std::array<byte, 1> header{{0x02U}};
+    return view(header);
+}
 class zlib_data_compressor_impl : public buffered_data_compressor_impl {
 private:
     memory::buffer _temp;
@@ -241,6 +245,22 @@ private:
     int _zd_lvl{Z_DEFAULT_COMPRESSION};
     int _zd_res{Z_STREAM_END};
     int _zi_res{Z_STREAM_END};
+    int _zd_wbits{MAX_WBITS};
+    int _zi_wbits{MAX_WBITS};
+
+    static constexpr auto _window_bits(
+      const data_compression_method method) noexcept -> int {
+        // zlib writes the gzip wrapper instead of the zlib one
+        // if 16 is added to the window bits
+        return method == data_compression_method::gzip ? MAX_WBITS + 16
+                                                       : MAX_WBITS;
+    }
+
+    auto _is_supported(const data_compression_method method) const noexcept
+      -> bool {
+        return (method == data_compression_method::zlib) or
+               (method == data_compression_method::gzip);
+    }
 
     static constexpr auto _translate(const data_compression_level level) noexcept
       -> int {
@@ -286,22 +306,43 @@ public:
         return data_compression_method::zlib;
     }
 
-    auto method_header([[maybe_unused]] data_compression_method method)
-      const noexcept -> memory::const_block final {
-        assert(method == default_method());
+    auto supported_methods() const noexcept -> data_compression_methods final {
+        return data_compression_method::zlib | data_compression_method::gzip;
+    }
+
+    auto method_header(data_compression_method method) const noexcept
+      -> memory::const_block final {
+        assert(_is_supported(method));
+        if(method == data_compression_method::gzip) {
+            return gzip_compression_header();
+        }
         return zlib_compression_header();
     }
 
+    auto supported_method_from_header(
+      const memory::const_block input) const noexcept
+      -> std::tuple<data_compression_method, memory::const_block> final {
+        for(const auto method :
+            {data_compression_method::zlib, data_compression_method::gzip}) {
+            const auto header{method_header(method)};
+            if(are_equal(head(input, header.size()), header)) {
+                return {method, skip(input, header.size())};
+            }
+        }
+        return {data_compression_method::unknown, input};
+    }
+
     auto compress_begin(
       const data_compression_method method,
       const data_compression_level level) noexcept -> bool final {
-        if(method != default_method()) [[unlikely]] {
+        if(not _is_supported(method)) [[unlikely]] {
             return false;
         }
         if(_zd_res != Z_STREAM_END) [[unlikely]] {
             return false;
         }
         _zd_lvl = _translate(level);
+        _zd_wbits = _window_bits(method);
 
         return true;
     }
@@ -328,7 +369,8 @@ public:
         _zsd.avail_out = limit_cast<unsigned>(_temp.size());
 
         if(_zd_res == Z_STREAM_END) {
-            _zd_res = ::deflateInit(&_zsd, _zd_lvl);
+            _zd_res = ::deflateInit2(
+              &_zsd, _zd_lvl, Z_DEFLATED, _zd_wbits, 8, Z_DEFAULT_STRATEGY);
         }
 
         if(_zd_res != Z_OK) [[unlikely]] {
@@ -382,12 +424,13 @@ public:
 
     auto decompress_begin(const data_compression_method method) noexcept
       -> bool {
-        if(method != default_method()) [[unlikely]] {
+        if(not _is_supported(method)) [[unlikely]] {
             return false;
         }
         if(_zi_res != Z_STREAM_END) [[unlikely]] {
             return false;
         }
+        _zi_wbits = _window_bits(method);
 
         return _zi_res != Z_OK;
     }
@@ -414,7 +457,7 @@ public:
         _zsi.avail_out = limit_cast<unsigned>(_temp.size());
 
         if(_zi_res == Z_STREAM_END) {
-            _zi_res = ::inflateInit(&_zsi);
+            _zi_res = ::inflateInit2(&_zsi, _zi_wbits);
         }
 
         if(_zi_res != Z_OK) [[unlikely]] {
@@ -493,6 +536,7 @@ static inline auto make_data_compressor_impl_for_method(
         case data_compression_method::none:
             return {hold<noop_data_compressor_impl>, buffers};
         case data_compression_method::zlib:
+        case data_compression_method::gzip:
 #if EAGINE_USE_ZLIB
             return {hold<zlib_data_compressor_impl>, buffers};
 #else
@@ -536,6 +580,9 @@ auto data_compression_method_from_header(const memory::const_block data) noexcep
     if(const auto header{zlib_compression_header()}; header_match(header)) {
         return {data_compression_method::zlib, skip_header(header)};
     }
+    if(const auto header{gzip_compression_header()}; header_match(header)) {
+        return {data_compression_method::gzip, skip_header(header)};
+    }
 #endif
     if(const auto header{none_compression_header()}; header_match(header)) {
         return {data_compression_method::none, skip_header(header)};
@@ -54,14 +54,57 @@ void compress_roundtrip_default_highest(auto& s) {
       test, eagine::data_compression_level::highest);
 }
 //------------------------------------------------------------------------------
+void compress_roundtrip_gzip(auto& s) {
+    eagitest::case_ test{s, 5, "round-trip gzip"};
+    auto& rg{test.random()};
+
+    eagine::memory::buffer_pool buffers;
+    eagine::data_compressor compress{buffers};
+    if(not compress.supported_methods().has(
+         eagine::data_compression_method::gzip)) {
+        return;
+    }
+    const auto method{eagine::data_compression_method::gzip};
+
+    for(unsigned r = 0; r < test.repeats(100); ++r) {
+        auto orig{buffers.get(rg.get_span_size(r * 1024, 128 * 1024))};
+        const eagine::memory::block orig_blk{orig};
+        rg.fill_with_bytes(orig_blk);
+
+        auto pckd{buffers.get()};
+        compress.compress(
+          method, orig_blk, pckd, eagine::data_compression_level::normal);
+        // gzip magic number
+        test.check(pckd.size() > 2, "has header");
+        test.check_equal(
+          unsigned(eagine::memory::view(pckd)[0]),
+          0x1FU,
+          "magic 0");
+        test.check_equal(
+          unsigned(eagine::memory::view(pckd)[1]),
+          0x8BU,
+          "magic 1");
+
+        auto copy{buffers.get()};
+        compress.decompress(method, eagine::memory::view(pckd), copy);
+        const eagine::memory::const_block copy_blk{copy};
+
+        test.check(eagine::are_equal(orig_blk, copy_blk), "same content");
+        buffers.eat(std::move(copy));
+        buffers.eat(std::move(pckd));
+        buffers.eat(std::move(orig));
+    }
+}
+//------------------------------------------------------------------------------
 // main
 //------------------------------------------------------------------------------
 auto main(int argc, const char** argv) -> int {
-    eagitest::suite test{argc, argv, "compression", 4};
+    eagitest::suite test{argc, argv, "compression", 5};
     test.once(compress_roundtrip_default_none);
     test.once(compress_roundtrip_default_lowest);
     test.once(compress_roundtrip_default_normal);
     test.once(compress_roundtrip_default_highest);
+    test.once(compress_roundtrip_gzip);
     return test.exit_code();
 }
 //------------------------------------------------------------------------------
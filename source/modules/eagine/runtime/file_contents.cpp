@@ -20,9 +20,21 @@ export class temporary_chunk_storage {
 public:
     temporary_chunk_storage() noexcept;
 
+    /// @brief Construction with the maximum number of stored bytes.
+    /// @see dropped_count
+    ///
+    /// Chunks that would make the storage exceed the limit are dropped.
+    temporary_chunk_storage(span_size_t max_size) noexcept;
+
     /// @brief Indicates if the storage is empty.
     auto empty() const noexcept -> bool;
 
+    /// @brief Returns the number of currently stored bytes.
+    auto size() const noexcept -> span_size_t;
+
+    /// @brief Returns the number of chunks dropped because of the size limit.
+    auto dropped_count() const noexcept -> span_size_t;
+
     /// @brief Adds a new chunk to the storage.
     auto add_chunk(memory::const_block) noexcept -> temporary_chunk_storage&;
 
@@ -44,6 +56,33 @@ export auto read_stream_data(std::istream&, memory::buffer& dest) noexcept
 export auto read_file_data(const string_view path, memory::buffer& dest) noexcept
   -> bool;
 //------------------------------------------------------------------------------
+/// @brief Enumeration of expected file contents access patterns.
+/// @see file_contents_options
+export enum class file_access_pattern : std::uint8_t {
+    /// @brief No specific access pattern.
+    normal,
+    /// @brief The contents are going to be read from the start to the end.
+    sequential,
+    /// @brief The contents are going to be accessed in random order.
+    random
+};
+//------------------------------------------------------------------------------
+/// @brief Options controlling how file contents are loaded.
+/// @see file_contents
+export struct file_contents_options {
+    /// @brief Files at least this large are memory-mapped where supported.
+    ///
+    /// Smaller files, files that cannot be mapped and non-regular files
+    /// are read into a buffer.
+    span_size_t map_threshold{256 * 1024};
+
+    /// @brief The expected access pattern, used as a hint for mapped files.
+    file_access_pattern access{file_access_pattern::normal};
+
+    /// @brief Indicates if all pages of mapped files should be read in advance.
+    bool prefault{false};
+};
+//------------------------------------------------------------------------------
 /// @brief Interface for file content getter implementations.
 /// @see file_contents
 export struct file_contents_intf : interface<file_contents_intf> {
@@ -62,6 +101,13 @@ public:
     /// @brief Constructor that opens and loads contents of file at the given path.
     file_contents(const string_view path);
 
+    /// @brief Constructor that opens and loads contents of file at the given path.
+    ///
+    /// The block viewing the contents of memory-mapped files stays valid
+    /// as long as this object (or its copies) exist. The file should not be
+    /// truncated by other processes during that time.
+    file_contents(const string_view path, const file_contents_options&);
+
     /// @brief Checks if the contents were loaded.
     /// @see block
     auto is_loaded() const noexcept -> bool {
@@ -9,6 +9,21 @@ module;
 
 #include <cstdio>
 
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && \
+  __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifndef EAGINE_POSIX
+#define EAGINE_POSIX 1
+#endif
+#else
+#ifndef EAGINE_POSIX
+#define EAGINE_POSIX 0
+#endif
+#endif
+
 module eagine.core.runtime;
 
 import std;
@@ -24,7 +39,12 @@ namespace eagine {
 //------------------------------------------------------------------------------
 class temporary_chunk_storage_impl {
 public:
+    temporary_chunk_storage_impl(std::size_t max_size) noexcept
+      : _max_size{max_size} {}
+
     auto empty() noexcept -> bool;
+    auto size() noexcept -> span_size_t;
+    auto dropped_count() noexcept -> span_size_t;
     void add_chunk(memory::const_block) noexcept;
     void for_each_chunk(callable_ref<void(memory::const_block)>);
     void clear() noexcept;
@@ -37,6 +57,8 @@ private:
       std::tmpfile(),
       &std::fclose};
     std::size_t _done{0U};
+    std::size_t _max_size;
+    span_size_t _dropped{0};
 };
 //------------------------------------------------------------------------------
 void temporary_chunk_storage_impl::_write(memory::const_block blk) noexcept {
@@ -47,10 +69,22 @@ auto temporary_chunk_storage_impl::empty() noexcept -> bool {
     return _done == 0U;
 }
 //------------------------------------------------------------------------------
+auto temporary_chunk_storage_impl::size() noexcept -> span_size_t {
+    return span_size(_done);
+}
+//------------------------------------------------------------------------------
+auto temporary_chunk_storage_impl::dropped_count() noexcept -> span_size_t {
+    return _dropped;
+}
+//------------------------------------------------------------------------------
 void temporary_chunk_storage_impl::add_chunk(
   memory::const_block chunk) noexcept {
     if(_store) {
         std::array<byte, 8> header{};
+        if(_done + header.size() + chunk.std_size() > _max_size) {
+            ++_dropped;
+            return;
+        }
         using multi_byte::code_point;
 
         if(const ok size_cp{limit_cast<code_point>(chunk.size())}) {
@@ -108,17 +142,29 @@ void temporary_chunk_storage_impl::for_each_chunk(
 //------------------------------------------------------------------------------
 void temporary_chunk_storage_impl::clear() noexcept {
     _store.reset(std::tmpfile());
+    _done = 0U;
 }
 //------------------------------------------------------------------------------
 // temporary_chunk_storage
 //------------------------------------------------------------------------------
 temporary_chunk_storage::temporary_chunk_storage() noexcept
-  : _impl{hold<temporary_chunk_storage_impl>} {}
+  : temporary_chunk_storage{std::numeric_limits<span_size_t>::max()} {}
+//------------------------------------------------------------------------------
+temporary_chunk_storage::temporary_chunk_storage(span_size_t max_size) noexcept
+  : _impl{hold<temporary_chunk_storage_impl>, std_size(max_size)} {}
 //------------------------------------------------------------------------------
 auto temporary_chunk_storage::empty() const noexcept -> bool {
     return _impl->empty();
 }
 //------------------------------------------------------------------------------
+auto temporary_chunk_storage::size() const noexcept -> span_size_t {
+    return _impl->size();
+}
+//------------------------------------------------------------------------------
+auto temporary_chunk_storage::dropped_count() const noexcept -> span_size_t {
+    return _impl->dropped_count();
+}
+//------------------------------------------------------------------------------
 auto temporary_chunk_storage::add_chunk(memory::const_block chunk) noexcept
   -> temporary_chunk_storage& {
     _impl->add_chunk(chunk);
@@ -196,9 +242,90 @@ public:
     }
 };
 //------------------------------------------------------------------------------
-static inline auto make_file_contents_impl(const string_view path)
+#if EAGINE_POSIX
+class mapped_file_contents : public file_contents_intf {
+public:
+    mapped_file_contents(void* addr, std::size_t size) noexcept
+      : _addr{addr}
+      , _size{size} {}
+
+    mapped_file_contents(mapped_file_contents&&) = delete;
+    mapped_file_contents(const mapped_file_contents&) = delete;
+    auto operator=(mapped_file_contents&&) = delete;
+    auto operator=(const mapped_file_contents&) = delete;
+
+    ~mapped_file_contents() noexcept override {
+        ::munmap(_addr, _size);
+    }
+
+    auto block() noexcept -> memory::const_block override {
+        return {static_cast<const byte*>(_addr), span_size(_size)};
+    }
+
+    static auto map(int fd, std::size_t size, const file_contents_options& opts)
+      -> void* {
+        int flags{MAP_PRIVATE};
+#ifdef MAP_POPULATE
+        if(opts.prefault) {
+            flags |= MAP_POPULATE;
+        }
+#endif
+        void* addr{::mmap(nullptr, size, PROT_READ, flags, fd, 0)};
+        if(addr == MAP_FAILED) {
+            return nullptr;
+        }
+        switch(opts.access) {
+            case file_access_pattern::sequential:
+                ::posix_madvise(addr, size, POSIX_MADV_SEQUENTIAL);
+                break;
+            case file_access_pattern::random:
+                ::posix_madvise(addr, size, POSIX_MADV_RANDOM);
+                break;
+            case file_access_pattern::normal:
+                break;
+        }
+        return addr;
+    }
+
+private:
+    void* _addr;
+    std::size_t _size;
+};
+//------------------------------------------------------------------------------
+static inline auto map_file_contents(
+  const string_view path,
+  const file_contents_options& opts) -> shared_holder<file_contents_intf> {
+    const int fd{::open(c_str(path), O_RDONLY | O_CLOEXEC)};
+    if(fd < 0) {
+        return {};
+    }
+    const auto close_fd{finally([fd] { ::close(fd); })};
+    struct ::stat st{};
+    if((::fstat(fd, &st) != 0) or not S_ISREG(st.st_mode)) {
+        return {};
+    }
+    // empty files cannot be mapped
+    if((st.st_size <= 0) or (st.st_size < opts.map_threshold)) {
+        return {};
+    }
+    const auto size{std::size_t(st.st_size)};
+    if(void* addr{mapped_file_contents::map(fd, size, opts)}) {
+        return {hold<mapped_file_contents>, addr, size};
+    }
+    return {};
+}
+#endif
+//------------------------------------------------------------------------------
+static inline auto make_file_contents_impl(
+  const string_view path,
+  [[maybe_unused]] const file_contents_options& opts)
   -> shared_holder<file_contents_intf> {
     try {
+#if EAGINE_POSIX
+        if(auto mapped{map_file_contents(path, opts)}) {
+            return mapped;
+        }
+#endif
         return {hold<buffered_file_contents>, path};
     } catch(const std::system_error&) {
         return {};
@@ -208,6 +335,11 @@ static inline auto make_file_contents_impl(const string_view path)
 // file_contents::file_contents
 //------------------------------------------------------------------------------
 file_contents::file_contents(const string_view path)
-  : _impl{make_file_contents_impl(path)} {}
+  : file_contents{path, file_contents_options{}} {}
+//------------------------------------------------------------------------------
+file_contents::file_contents(
+  const string_view path,
+  const file_contents_options& opts)
+  : _impl{make_file_contents_impl(path, opts)} {}
 //------------------------------------------------------------------------------
 } // namespace eagine
@@ -0,0 +1,105 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin.hpp>
+import std;
+import eagine.core.types;
+import eagine.core.memory;
+import eagine.core.runtime;
+//------------------------------------------------------------------------------
+auto write_temporary_file(
+  auto& test,
+  const char* name,
+  std::size_t size,
+  std::vector<char>& data) -> std::filesystem::path {
+    auto& rg{test.random()};
+    data.resize(size);
+    for(auto& c : data) {
+        c = rg.template get_between<char>('!', '~');
+    }
+    const auto path{std::filesystem::temp_directory_path() / name};
+    std::ofstream file{path, std::ios::out | std::ios::binary};
+    file.write(data.data(), std::streamsize(data.size()));
+    return path;
+}
+//------------------------------------------------------------------------------
+void check_contents(
+  auto& test,
+  const eagine::file_contents& contents,
+  const std::vector<char>& data) {
+    test.ensure(bool(contents), "is loaded");
+    const auto blk{contents.block()};
+    test.check_equal(blk.size(), eagine::span_size(data.size()), "size");
+    test.check(
+      std::equal(
+        blk.begin(),
+        blk.end(),
+        data.begin(),
+        data.end(),
+        [](eagine::byte b, char c) { return b == eagine::byte(c); }),
+      "same contents");
+}
+//------------------------------------------------------------------------------
+void file_contents_buffered(auto& s) {
+    eagitest::case_ test{s, 1, "buffered"};
+    std::vector<char> data;
+    const auto path{
+      write_temporary_file(test, "eagine-file-contents-small", 1000, data)};
+
+    check_contents(test, eagine::file_contents{path.string()}, data);
+    std::filesystem::remove(path);
+}
+//------------------------------------------------------------------------------
+void file_contents_mapped(auto& s) {
+    eagitest::case_ test{s, 2, "mapped"};
+    using eagine::file_access_pattern;
+    std::vector<char> data;
+    const auto path{write_temporary_file(
+      test, "eagine-file-contents-large", 1024 * 1024 + 17, data)};
+
+    for(const auto access :
+        {file_access_pattern::normal,
+         file_access_pattern::sequential,
+         file_access_pattern::random}) {
+        for(const bool prefault : {false, true}) {
+            const eagine::file_contents contents{
+              path.string(),
+              {.map_threshold = 4096, .access = access, .prefault = prefault}};
+            check_contents(test, contents, data);
+
+            // the block is valid as long as any copy exists
+            eagine::file_contents copy{contents};
+            check_contents(test, copy, data);
+        }
+    }
+    std::filesystem::remove(path);
+}
+//------------------------------------------------------------------------------
+void file_contents_empty(auto& s) {
+    eagitest::case_ test{s, 3, "empty"};
+    std::vector<char> data;
+    const auto path{
+      write_temporary_file(test, "eagine-file-contents-empty", 0, data)};
+
+    const eagine::file_contents contents{path.string(), {.map_threshold = 0}};
+    test.check(bool(contents), "is loaded");
+    test.check(contents.block().empty(), "is empty");
+    std::filesystem::remove(path);
+}
+//------------------------------------------------------------------------------
+// main
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagitest::suite test{argc, argv, "file_contents", 3};
+    test.once(file_contents_buffered);
+    test.once(file_contents_mapped);
+    test.once(file_contents_empty);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end.hpp>
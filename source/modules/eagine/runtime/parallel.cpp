@@ -0,0 +1,376 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+export module eagine.core.runtime:parallel;
+
+import std;
+import eagine.core.types;
+import :workshop;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+// Shared state of a set of work units processing numbered chunks of work.
+// The unit for chunk k initially covers only that chunk, the first unit
+// covers all of them. Units split the covered chunks in halves and enqueue
+// the unit for the first chunk of the second half, so each unit is enqueued
+// at most once and idle workers can take the larger halves.
+// Each chunk is claimed by exactly one thread, either by a worker running
+// the unit of the chunk or by the calling thread, which runs the chunks not
+// claimed yet instead of just waiting. The units still queued afterwards
+// only refer to this state, the caller helps the workshop to run them, so it
+// does not depend on idle workers, even when it is a worker itself.
+template <typename ChunkFunction>
+class parallel_chunks {
+public:
+    parallel_chunks(
+      workshop& ws,
+      std::size_t count,
+      const ChunkFunction& function)
+      : _workshop{ws}
+      , _function{function}
+      , _completed{limit_cast<std::ptrdiff_t>(count)}
+      , _units(count) {
+        for(const auto k : integer_range(count)) {
+            _units[k].bind(*this, k);
+        }
+    }
+
+    parallel_chunks(parallel_chunks&&) = delete;
+    parallel_chunks(const parallel_chunks&) = delete;
+    auto operator=(parallel_chunks&&) = delete;
+    auto operator=(const parallel_chunks&) = delete;
+    ~parallel_chunks() noexcept = default;
+
+    // runs the first unit and then the unclaimed chunks in the calling thread
+    // helps the workshop until the chunks claimed by other threads are done
+    // and the queued units were run, the threads running the claimed chunks
+    // may themselves wait for work queued behind the units of this call
+    void run() {
+        _units.front().cover(_units.size()).do_it();
+        for(auto& unit : _units) {
+            unit.run_chunk();
+        }
+        while(
+          not _completed.try_wait() or
+          (_queued.load(std::memory_order_acquire) > 0U)) {
+            if(not _workshop.help()) {
+                std::this_thread::yield();
+            }
+        }
+        if(_error) {
+            std::rethrow_exception(_error);
+        }
+    }
+
+private:
+    class _unit : public work_unit {
+    public:
+        void bind(parallel_chunks& parent, std::size_t index) noexcept {
+            _parent = &parent;
+            _index = index;
+            _end = index + 1U;
+        }
+
+        auto cover(std::size_t end) noexcept -> _unit& {
+            _end = end;
+            return *this;
+        }
+
+        auto do_it() noexcept -> bool final {
+            while(_end - _index > 1U) {
+                const auto middle{_index + (_end - _index) / 2U};
+                _parent->_enqueue(_parent->_units[middle].cover(_end));
+                _end = middle;
+            }
+            run_chunk();
+            return true;
+        }
+
+        void deliver() noexcept final {
+            _parent->_queued.fetch_sub(1U, std::memory_order_release);
+        }
+
+        void run_chunk() noexcept {
+            if(not _claimed.test_and_set(std::memory_order_relaxed)) {
+                _parent->_call(_index);
+                _parent->_completed.count_down();
+            }
+        }
+
+    private:
+        parallel_chunks* _parent{nullptr};
+        std::size_t _index{0U};
+        std::size_t _end{0U};
+        std::atomic_flag _claimed{};
+    };
+
+    void _enqueue(_unit& unit) noexcept {
+        _queued.fetch_add(1U, std::memory_order_relaxed);
+        try {
+            _workshop.enqueue(unit);
+        } catch(...) {
+            unit.do_it();
+            unit.deliver();
+        }
+    }
+
+    void _call(std::size_t index) noexcept {
+        if(not _failed.test(std::memory_order_relaxed)) [[likely]] {
+            try {
+                _function(index);
+            } catch(...) {
+                if(not _failed.test_and_set()) {
+                    _error = std::current_exception();
+                }
+            }
+        }
+    }
+
+    workshop& _workshop;
+    const ChunkFunction& _function;
+    std::latch _completed;
+    std::vector<_unit> _units;
+    std::atomic<std::size_t> _queued{0U};
+    std::exception_ptr _error;
+    std::atomic_flag _failed{};
+};
+//------------------------------------------------------------------------------
+/// @brief Returns the chunk size used by parallel_for if none is specified.
+/// @ingroup workshop
+export template <std::integral I>
+auto default_parallel_grain(I count) noexcept -> I {
+    // several chunks per thread for load balancing
+    const auto chunks{
+      8U * std::max(std::thread::hardware_concurrency(), 1U)};
+    return std::max(I(std::size_t(count) / chunks), I(1));
+}
+//------------------------------------------------------------------------------
+/// @brief Calls a function on all integers in a range, in parallel.
+/// @ingroup workshop
+/// @see parallel_reduce
+/// @see task_graph
+///
+/// The range is split into chunks of (at most) grain integers. The chunks
+/// are processed by the workers of the workshop and by the calling thread,
+/// which returns when all of them are done. The function is called either
+/// with individual integers or, if it does not accept them, with whole chunk
+/// ranges.
+/// If the function throws then the remaining chunks are skipped and the first
+/// exception is rethrown.
+/// The calling thread runs the chunks that no worker took yet, so this can
+/// be called also from the work units executed by the same workshop.
+export template <std::integral I, typename Function>
+void parallel_for(
+  workshop& ws,
+  std::ranges::iota_view<I, I> range,
+  I grain,
+  Function function) {
+    const auto begin{*range.begin()};
+    const auto end{*range.end()};
+    if(begin >= end) {
+        return;
+    }
+    grain = std::max(grain, I(1));
+    const auto call{[&](I first, I last) {
+        if constexpr(std::is_invocable_v<Function&, I>) {
+            for(I i = first; i < last; ++i) {
+                function(i);
+            }
+        } else {
+            function(std::ranges::iota_view<I, I>{first, last});
+        }
+    }};
+
+    const auto size{std::size_t(grain)};
+    const auto chunk_count{(std::size_t(end - begin) + size - 1U) / size};
+    if(chunk_count < 2U) {
+        call(begin, end);
+        return;
+    }
+    const auto chunk{[&](std::size_t k) {
+        const auto first{I(begin + I(k * size))};
+        call(first, I(first + std::min(I(end - first), grain)));
+    }};
+    parallel_chunks<decltype(chunk)>{ws, chunk_count, chunk}.run();
+}
+
+/// @brief Calls a function on all integers in a range, in parallel.
+/// @ingroup workshop
+/// @see default_parallel_grain
+export template <std::integral I, typename Function>
+void parallel_for(
+  workshop& ws,
+  std::ranges::iota_view<I, I> range,
+  Function function) {
+    parallel_for(
+      ws,
+      range,
+      default_parallel_grain(I(range.size())),
+      std::move(function));
+}
+//------------------------------------------------------------------------------
+/// @brief Reduces the integers in a range to a single value, in parallel.
+/// @ingroup workshop
+/// @see parallel_for
+///
+/// The range is split into chunks like in parallel_for. For each chunk
+/// a partial result is initialized with the identity value and updated with
+/// function(partial, i) for each integer i in the chunk. The partial results
+/// are then combined with combine(result, partial) in the order of chunks,
+/// so the result is deterministic if combine is associative.
+export template <
+  std::integral I,
+  typename T,
+  typename Function,
+  typename Combine>
+auto parallel_reduce(
+  workshop& ws,
+  std::ranges::iota_view<I, I> range,
+  I grain,
+  T identity,
+  Function function,
+  Combine combine) -> T {
+    const auto count{range.size()};
+    grain = std::max(grain, I(1));
+    const auto chunk_count{
+      (std::size_t(count) + std::size_t(grain) - 1U) / std::size_t(grain)};
+    std::vector<std::optional<T>> partials(chunk_count);
+
+    const auto begin{*range.begin()};
+    const auto end{*range.end()};
+    parallel_for(
+      ws, integer_range(chunk_count), std::size_t(1U), [&](std::size_t k) {
+          const auto first{I(begin + I(k * std::size_t(grain)))};
+          const auto last{I(first + std::min(I(end - first), grain))};
+          T partial{identity};
+          for(I i = first; i < last; ++i) {
+              partial = function(std::move(partial), i);
+          }
+          partials[k].emplace(std::move(partial));
+      });
+
+    for(auto& partial : partials) {
+        identity = combine(std::move(identity), std::move(*partial));
+    }
+    return identity;
+}
+
+/// @brief Reduces the integers in a range to a single value, in parallel.
+/// @ingroup workshop
+/// @see default_parallel_grain
+export template <
+  std::integral I,
+  typename T,
+  typename Function,
+  typename Combine>
+auto parallel_reduce(
+  workshop& ws,
+  std::ranges::iota_view<I, I> range,
+  T identity,
+  Function function,
+  Combine combine) -> T {
+    return parallel_reduce(
+      ws,
+      range,
+      default_parallel_grain(I(range.size())),
+      std::move(identity),
+      std::move(function),
+      std::move(combine));
+}
+//------------------------------------------------------------------------------
+/// @brief Graph of tasks with dependencies, executed by a workshop.
+/// @ingroup workshop
+/// @see parallel_for
+///
+/// Each task runs after all of its predecessors finished. Tasks without
+/// predecessors start immediately and finished tasks enqueue their
+/// successors that have no other unfinished predecessors, so no thread
+/// waits for individual tasks. A graph can be run repeatedly.
+export class task_graph {
+public:
+    /// @brief Type of the identifiers of tasks in this graph.
+    using task_id = std::size_t;
+
+    /// @brief Adds a new task without predecessors.
+    auto add(std::function<void()> function) -> task_id;
+
+    /// @brief Adds a new task that runs after the specified predecessors.
+    auto add(
+      std::function<void()> function,
+      std::span<const task_id> predecessors) -> task_id;
+
+    /// @brief Adds a new task that runs after the specified predecessors.
+    auto add(
+      std::function<void()> function,
+      std::initializer_list<task_id> predecessors) -> task_id {
+        return add(std::move(function), std::span{predecessors});
+    }
+
+    /// @brief Adds a new task that runs after the specified task.
+    /// @see precede
+    auto then(task_id predecessor, std::function<void()> function)
+      -> task_id {
+        return add(std::move(function), {predecessor});
+    }
+
+    /// @brief Specifies that task before must finish before task after starts.
+    /// @pre before < size() and after < size()
+    auto precede(task_id before, task_id after) -> task_graph&;
+
+    /// @brief Returns the number of tasks in this graph.
+    auto size() const noexcept -> span_size_t {
+        return span_size(_tasks.size());
+    }
+
+    /// @brief Indicates if this graph has no tasks.
+    auto empty() const noexcept -> bool {
+        return _tasks.empty();
+    }
+
+    /// @brief Indicates if there are no cyclic dependencies between tasks.
+    auto is_acyclic() const -> bool;
+
+    /// @brief Runs all tasks in the specified workshop and waits until done.
+    /// @returns false, without running any task, if the graph has cycles.
+    ///
+    /// If some tasks throw then their successors are not run and the first
+    /// exception is rethrown after the remaining tasks finish.
+    /// The calling thread helps to run the queued tasks instead of blocking
+    /// until all tasks finish, so this can be called also from the work units
+    /// executed by the same workshop.
+    auto run(workshop& ws) -> bool;
+
+private:
+    class _task : public work_unit {
+    public:
+        _task(task_graph& parent, std::function<void()> function) noexcept;
+
+        auto do_it() noexcept -> bool final;
+        void deliver() noexcept final;
+
+    private:
+        friend class task_graph;
+
+        task_graph* _parent;
+        std::function<void()> _function;
+        std::vector<task_id> _successors;
+        std::size_t _predecessors{0U};
+        std::atomic<std::size_t> _remaining{0U};
+        std::atomic<bool> _skipped{false};
+    };
+
+    void _enqueue(_task&) noexcept;
+    void _record_error(std::exception_ptr) noexcept;
+
+    std::deque<_task> _tasks;
+    workshop* _workshop{nullptr};
+    std::optional<std::latch> _completed;
+    std::mutex _error_lockable;
+    std::exception_ptr _error;
+};
+//------------------------------------------------------------------------------
+} // namespace eagine
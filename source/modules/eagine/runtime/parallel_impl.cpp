@@ -0,0 +1,154 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module;
+
+#include <cassert>
+
+module eagine.core.runtime;
+
+import std;
+import eagine.core.types;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+// task_graph::_task
+//------------------------------------------------------------------------------
+task_graph::_task::_task(
+  task_graph& parent,
+  std::function<void()> function) noexcept
+  : _parent{&parent}
+  , _function{std::move(function)} {}
+//------------------------------------------------------------------------------
+auto task_graph::_task::do_it() noexcept -> bool {
+    // the successors of tasks that failed or were skipped are skipped too
+    bool skip{_skipped.load(std::memory_order_relaxed)};
+    if(not skip) {
+        try {
+            _function();
+        } catch(...) {
+            _parent->_record_error(std::current_exception());
+            skip = true;
+        }
+    }
+    for(const auto index : _successors) {
+        auto& successor{_parent->_tasks[index]};
+        if(skip) {
+            successor._skipped.store(true, std::memory_order_relaxed);
+        }
+        auto& remaining{successor._remaining};
+        if(remaining.fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+            _parent->_enqueue(successor);
+        }
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+void task_graph::_task::deliver() noexcept {
+    _parent->_completed->count_down();
+}
+//------------------------------------------------------------------------------
+// task_graph
+//------------------------------------------------------------------------------
+auto task_graph::add(std::function<void()> function) -> task_id {
+    _tasks.emplace_back(*this, std::move(function));
+    return _tasks.size() - 1U;
+}
+//------------------------------------------------------------------------------
+auto task_graph::add(
+  std::function<void()> function,
+  std::span<const task_id> predecessors) -> task_id {
+    const auto id{add(std::move(function))};
+    for(const auto predecessor : predecessors) {
+        precede(predecessor, id);
+    }
+    return id;
+}
+//------------------------------------------------------------------------------
+auto task_graph::precede(task_id before, task_id after) -> task_graph& {
+    assert(before < _tasks.size());
+    assert(after < _tasks.size());
+    _tasks[before]._successors.push_back(after);
+    ++_tasks[after]._predecessors;
+    return *this;
+}
+//------------------------------------------------------------------------------
+auto task_graph::is_acyclic() const -> bool {
+    std::vector<std::size_t> remaining;
+    std::vector<task_id> ready;
+    remaining.reserve(_tasks.size());
+    for(const auto index : integer_range(_tasks.size())) {
+        remaining.push_back(_tasks[index]._predecessors);
+        if(remaining.back() == 0U) {
+            ready.push_back(index);
+        }
+    }
+    std::size_t visited{0U};
+    while(not ready.empty()) {
+        const auto index{ready.back()};
+        ready.pop_back();
+        ++visited;
+        for(const auto successor : _tasks[index]._successors) {
+            if(--remaining[successor] == 0U) {
+                ready.push_back(successor);
+            }
+        }
+    }
+    return visited == _tasks.size();
+}
+//------------------------------------------------------------------------------
+auto task_graph::run(workshop& ws) -> bool {
+    if(_tasks.empty()) {
+        return true;
+    }
+    if(not is_acyclic()) {
+        return false;
+    }
+    _workshop = &ws;
+    _completed.emplace(limit_cast<std::ptrdiff_t>(_tasks.size()));
+    _error = {};
+    for(auto& task : _tasks) {
+        task._remaining.store(task._predecessors, std::memory_order_relaxed);
+        task._skipped.store(false, std::memory_order_relaxed);
+    }
+    for(auto& task : _tasks) {
+        if(task._predecessors == 0U) {
+            _enqueue(task);
+        }
+    }
+    // help with the queued work so that this does not depend on idle
+    // workers, never block since the tasks still running in other threads
+    // may enqueue successors or wait for work that only this thread can run
+    while(not _completed->try_wait()) {
+        if(not ws.help()) {
+            std::this_thread::yield();
+        }
+    }
+    _workshop = nullptr;
+    if(_error) {
+        std::rethrow_exception(std::exchange(_error, {}));
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+void task_graph::_enqueue(_task& task) noexcept {
+    try {
+        _workshop->enqueue(task);
+    } catch(...) {
+        task.do_it();
+        task.deliver();
+    }
+}
+//------------------------------------------------------------------------------
+void task_graph::_record_error(std::exception_ptr error) noexcept {
+    const std::lock_guard lock{_error_lockable};
+    if(not _error) {
+        _error = std::move(error);
+    }
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
@@ -0,0 +1,200 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin.hpp>
+import std;
+import eagine.core.types;
+import eagine.core.runtime;
+//------------------------------------------------------------------------------
+constexpr const std::array<eagine::workshop_scheduling, 2> schedulings{
+  eagine::workshop_scheduling::shared_queue,
+  eagine::workshop_scheduling::work_stealing};
+//------------------------------------------------------------------------------
+void parallel_for_each(auto& s) {
+    eagitest::case_ test{s, 1, "for"};
+    auto& rg{test.random()};
+
+    for(const auto scheduling : schedulings) {
+        eagine::workshop workers{scheduling};
+        workers.ensure_workers(3);
+
+        for(const int count : {0, 1, 17, 1000, rg.get_int(1, 10000)}) {
+            std::vector<std::atomic<int>> marks(eagine::std_size(count));
+            for(const int grain : {1, 7, 64, count, rg.get_int(1, 100)}) {
+                eagine::parallel_for(
+                  workers, eagine::integer_range(count), grain, [&](int i) {
+                      marks[eagine::std_size(i)].fetch_add(1);
+                  });
+            }
+            eagine::parallel_for(
+              workers, eagine::integer_range(count), [&](int i) {
+                  marks[eagine::std_size(i)].fetch_add(1);
+              });
+            for(const auto& mark : marks) {
+                test.check_equal(mark.load(), 6, "marked");
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void parallel_for_chunks(auto& s) {
+    eagitest::case_ test{s, 2, "for chunks"};
+
+    for(const auto scheduling : schedulings) {
+        eagine::workshop workers{scheduling};
+        workers.ensure_workers(3);
+
+        const long count{100000L};
+        std::atomic<long> sum{0L};
+        std::atomic<long> chunks{0L};
+        eagine::parallel_for(
+          workers,
+          eagine::integer_range(count),
+          1000L,
+          [&](std::ranges::iota_view<long, long> chunk) {
+              test.check(chunk.size() <= 1000U, "chunk size");
+              long partial{0L};
+              for(const auto i : chunk) {
+                  partial += i;
+              }
+              sum.fetch_add(partial);
+              chunks.fetch_add(1L);
+          });
+        test.check_equal(sum.load(), count * (count - 1L) / 2L, "sum");
+        test.check_equal(chunks.load(), 100L, "chunk count");
+    }
+}
+//------------------------------------------------------------------------------
+void parallel_reduce_sum(auto& s) {
+    eagitest::case_ test{s, 3, "reduce"};
+    auto& rg{test.random()};
+
+    for(const auto scheduling : schedulings) {
+        eagine::workshop workers{scheduling};
+        workers.ensure_workers(3);
+
+        for(const long count : {0L, 1L, 1000L, long(rg.get_int(1, 100000))}) {
+            const auto sum{eagine::parallel_reduce(
+              workers,
+              eagine::integer_range(count),
+              long(rg.get_int(1, 1000)),
+              0L,
+              [](long partial, long i) { return partial + i; },
+              std::plus<>{})};
+            test.check_equal(sum, count * (count - 1L) / 2L, "sum");
+        }
+
+        const auto text{eagine::parallel_reduce(
+          workers,
+          eagine::integer_range(26),
+          3,
+          std::string{},
+          [](std::string partial, int i) {
+              partial.push_back(char('a' + i));
+              return partial;
+          },
+          [](std::string result, const std::string& partial) {
+              return result.append(partial);
+          })};
+        test.check_equal(
+          text, std::string{"abcdefghijklmnopqrstuvwxyz"}, "order");
+    }
+}
+//------------------------------------------------------------------------------
+void parallel_task_graph(auto& s) {
+    eagitest::case_ test{s, 4, "task graph"};
+
+    for(const auto scheduling : schedulings) {
+        eagine::workshop workers{scheduling};
+        workers.ensure_workers(3);
+
+        std::atomic<int> step{0};
+        std::array<int, 4> order{};
+        eagine::task_graph graph;
+        const auto a{graph.add([&] { order[0] = step.fetch_add(1); })};
+        const auto b{graph.then(a, [&] { order[1] = step.fetch_add(1); })};
+        const auto c{graph.then(a, [&] { order[2] = step.fetch_add(1); })};
+        graph.add([&] { order[3] = step.fetch_add(1); }, {b, c});
+        test.check_equal(graph.size(), 4, "size");
+        test.check(graph.is_acyclic(), "is acyclic");
+
+        for(int run = 0; run < 3; ++run) {
+            step = 0;
+            test.check(graph.run(workers), "run");
+            test.check_equal(order[0], 0, "first");
+            test.check(order[1] > 0 and order[1] < 3, "second");
+            test.check(order[2] > 0 and order[2] < 3, "third");
+            test.check_equal(order[3], 3, "last");
+        }
+
+        bool ran{false};
+        eagine::task_graph cyclic;
+        const auto x{cyclic.add([&] { ran = true; })};
+        cyclic.precede(cyclic.then(x, [&] { ran = true; }), x);
+        test.check(not cyclic.is_acyclic(), "is not acyclic");
+        test.check(not cyclic.run(workers), "not run");
+        test.check(not ran, "cyclic not ran");
+
+        eagine::task_graph failing;
+        const auto f{failing.add([] { throw std::runtime_error{"failed"}; })};
+        failing.then(f, [&] { ran = true; });
+        failing.add([] {});
+        bool thrown{false};
+        try {
+            failing.run(workers);
+        } catch(const std::runtime_error&) {
+            thrown = true;
+        }
+        test.check(thrown, "rethrown");
+        test.check(not ran, "successor not ran");
+    }
+}
+//------------------------------------------------------------------------------
+void parallel_for_nested(auto& s) {
+    eagitest::case_ test{s, 5, "nested for"};
+
+    for(const auto scheduling : schedulings) {
+        // a single worker, busy with the outer chunks
+        eagine::workshop workers{scheduling};
+        workers.ensure_workers(1);
+
+        std::atomic<long> sum{0L};
+        eagine::parallel_for(
+          workers, eagine::integer_range(8), 1, [&](int) {
+              eagine::parallel_for(
+                workers, eagine::integer_range(100L), 3L, [&](long i) {
+                    sum.fetch_add(i);
+                });
+          });
+        test.check_equal(sum.load(), 8L * 4950L, "sum");
+
+        std::atomic<int> tasks{0};
+        eagine::parallel_for(
+          workers, eagine::integer_range(4), 1, [&](int) {
+              eagine::task_graph graph;
+              const auto first{graph.add([&] { tasks.fetch_add(1); })};
+              graph.then(first, [&] { tasks.fetch_add(1); });
+              graph.run(workers);
+          });
+        test.check_equal(tasks.load(), 8, "tasks");
+    }
+}
+//------------------------------------------------------------------------------
+// main
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagitest::suite test{argc, argv, "parallel", 5};
+    test.once(parallel_for_each);
+    test.once(parallel_for_chunks);
+    test.once(parallel_reduce_sum);
+    test.once(parallel_task_graph);
+    test.once(parallel_for_nested);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end.hpp>
@@ -18,3 +18,4 @@ export import :basic_config;
 export import :compression;
 export import :value_with_history;
 export import :workshop;
+export import :parallel;
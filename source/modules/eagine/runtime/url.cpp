@@ -18,6 +18,233 @@ import eagine.core.container;
 import :program_args;
 
 namespace eagine {
+//------------------------------------------------------------------------------
+/// @brief Offsets and lengths of the components of an URL string.
+/// @see parse_url
+/// @see url
+export struct url_components {
+    /// @brief Offset and length of a component in the URL string.
+    using range = std::pair<span_size_t, span_size_t>;
+
+    /// @brief The scheme (without the colon).
+    range scheme{};
+    /// @brief The login name.
+    range login{};
+    /// @brief The login password.
+    range passwd{};
+    /// @brief The host name or IP address.
+    range host{};
+    /// @brief The port number.
+    range port{};
+    /// @brief The path (including the leading slash).
+    range path{};
+    /// @brief The query (without the question mark).
+    range query{};
+    /// @brief The fragment (without the hash).
+    range fragment{};
+    /// @brief Indicates if the whole string is a valid URL.
+    bool parsed{false};
+
+    /// @brief Indicates if the whole string is a valid URL.
+    constexpr explicit operator bool() const noexcept {
+        return parsed;
+    }
+};
+//------------------------------------------------------------------------------
+// Splits URL strings into url_components, without any backtracking
+// except for the login and password, which can contain '@'.
+class url_parser {
+public:
+    constexpr url_parser(std::string_view str) noexcept
+      : _str{str} {}
+
+    constexpr auto parse() noexcept -> url_components {
+        url_components result;
+        std::size_t pos{_skip_while<&url_parser::_is_word>(0U)};
+        if((pos > 0U) and _is(pos, ':')) {
+            result.scheme = _range(0U, pos);
+            ++pos;
+        } else {
+            pos = 0U;
+        }
+        if(_is(pos, '/') and _is(pos + 1U, '/')) {
+            result.parsed = _parse_authority(pos + 2U, result);
+        }
+        return result.parsed ? result : url_components{};
+    }
+
+private:
+    static constexpr auto _is_word(char c) noexcept -> bool {
+        return ((c >= 'a') and (c <= 'z')) or ((c >= 'A') and (c <= 'Z')) or
+               ((c >= '0') and (c <= '9')) or (c == '_');
+    }
+
+    static constexpr auto _is_digit(char c) noexcept -> bool {
+        return (c >= '0') and (c <= '9');
+    }
+
+    static constexpr auto _is_label(char c) noexcept -> bool {
+        return _is_word(c) or (c == '-');
+    }
+
+    static constexpr auto _is_path(char c) noexcept -> bool {
+        return _is_word(c) or (c == '.') or (c == '-');
+    }
+
+    static constexpr auto _is_arg_name(char c) noexcept -> bool {
+        return _is_word(c) or (c == '.');
+    }
+
+    static constexpr auto _is_arg_value(char c) noexcept -> bool {
+        return (c != '&') and (c != '#');
+    }
+
+    static constexpr auto _is_not_colon(char c) noexcept -> bool {
+        return c != ':';
+    }
+
+    static constexpr auto _is_not_space(char c) noexcept -> bool {
+        return (c != ' ') and (c != '\t') and (c != '\n') and (c != '\v') and
+               (c != '\f') and (c != '\r');
+    }
+
+    constexpr auto _is(std::size_t pos, char c) const noexcept -> bool {
+        return (pos < _str.size()) and (_str[pos] == c);
+    }
+
+    template <auto Predicate>
+    constexpr auto _skip_while(
+      std::size_t pos,
+      std::size_t max = ~std::size_t(0U)) const noexcept -> std::size_t {
+        while((pos < _str.size()) and (max > 0U) and Predicate(_str[pos])) {
+            ++pos;
+            --max;
+        }
+        return pos;
+    }
+
+    static constexpr auto _range(std::size_t begin, std::size_t end) noexcept
+      -> url_components::range {
+        return {span_size_t(begin), span_size_t(end - begin)};
+    }
+
+    constexpr auto _parse_authority(std::size_t pos, url_components& result)
+      const noexcept -> bool {
+        // the login and password can contain almost anything, including '@',
+        // so try the positions of '@' from the last one, like a backtracking
+        // regular expression matcher with greedy quantifiers would do
+        const auto login_end{_skip_while<&url_parser::_is_not_colon>(pos)};
+        const auto last_at{_str.rfind('@')};
+        if((login_end > pos) and (last_at != std::string_view::npos) and
+           (last_at > pos)) {
+            if(_is(login_end, ':')) {
+                const auto passwd_end{
+                  _skip_while<&url_parser::_is_not_space>(login_end + 1U)};
+                for(auto at{std::min(passwd_end, last_at)}; at > login_end + 1U;
+                    --at) {
+                    if(_is(at, '@') and _parse_location(at + 1U, result)) {
+                        result.login = _range(pos, login_end);
+                        result.passwd = _range(login_end + 1U, at);
+                        return true;
+                    }
+                }
+            }
+            for(auto at{std::min(login_end, last_at)}; at > pos; --at) {
+                if(_is(at, '@') and _parse_location(at + 1U, result)) {
+                    result.login = _range(pos, at);
+                    return true;
+                }
+            }
+        }
+        return _parse_location(pos, result);
+    }
+
+    constexpr auto _parse_location(std::size_t pos, url_components& result)
+      const noexcept -> bool {
+        result.host = result.port = result.path = {};
+        result.query = result.fragment = {};
+
+        // host name labels and optional port number
+        const auto host_begin{pos};
+        while(pos < _str.size() and _is_word(_str[pos])) {
+            const auto label_end{
+              _skip_while<&url_parser::_is_label>(pos + 1U, 62U)};
+            result.host = _range(host_begin, label_end);
+            if(not(_is(label_end, '.') and (label_end + 1U < _str.size()) and
+                   _is_word(_str[label_end + 1U]))) {
+                pos = label_end;
+                break;
+            }
+            pos = label_end + 1U;
+        }
+        if((pos > host_begin) and _is(pos, ':')) {
+            const auto port_end{
+              _skip_while<&url_parser::_is_digit>(pos + 1U, 5U)};
+            if(port_end == pos + 1U) {
+                return false;
+            }
+            result.port = _range(pos + 1U, port_end);
+            pos = port_end;
+        }
+
+        // path segments and optional trailing slash
+        const auto path_begin{pos};
+        while(_is(pos, '/')) {
+            const auto segment_end{
+              _skip_while<&url_parser::_is_path>(pos + 1U)};
+            const bool trailing_slash{segment_end == pos + 1U};
+            pos = segment_end;
+            if(trailing_slash) {
+                break;
+            }
+        }
+        result.path = _range(path_begin, pos);
+
+        // query arguments
+        if(_is(pos, '?')) {
+            const auto query_begin{++pos};
+            // the first argument name can also contain dots
+            bool first{true};
+            while(true) {
+                const auto name_end{
+                  first ? _skip_while<&url_parser::_is_arg_name>(pos)
+                        : _skip_while<&url_parser::_is_word>(pos)};
+                if((name_end == pos) or not _is(name_end, '=')) {
+                    return false;
+                }
+                pos = _skip_while<&url_parser::_is_arg_value>(name_end + 1U);
+                if(not _is(pos, '&')) {
+                    break;
+                }
+                ++pos;
+                first = false;
+            }
+            result.query = _range(query_begin, pos);
+        }
+
+        // fragment
+        if(_is(pos, '#')) {
+            const auto fragment_begin{++pos};
+            pos = _skip_while<&url_parser::_is_label>(pos);
+            result.fragment = _range(fragment_begin, pos);
+        }
+        return pos == _str.size();
+    }
+
+    std::string_view _str;
+};
+//------------------------------------------------------------------------------
+/// @brief Splits the specified string into URL components.
+/// @see url
+/// @see url_components
+///
+/// The string is parsed in a single pass (except for logins containing '@'),
+/// without any memory allocations and can be evaluated at compile time.
+export [[nodiscard]] constexpr auto parse_url(std::string_view str) noexcept
+  -> url_components {
+    return url_parser{str}.parse();
+}
+//------------------------------------------------------------------------------
 export class url;
 //------------------------------------------------------------------------------
 /// @brief Value map class for storing URL query parts.
@@ -120,15 +347,18 @@ public:
     url() noexcept = default;
 
     /// @brief Construction from a string.
-    url(std::string url_str) noexcept
-      : url{std::move(url_str), std::match_results<std::string::iterator>{}} {}
+    /// @see parse_url
+    url(std::string url_str) noexcept;
 
     /// @brief Construction from an command-line argument.
     url(const program_arg& arg) noexcept
       : url{arg.get_string()} {}
 
     /// @brief Indicates if the given string is a valid url.
-    static auto is_url(const string_view) noexcept -> bool;
+    /// @see parse_url
+    static constexpr auto is_url(const string_view str) noexcept -> bool {
+        return parse_url(str.std_view()).parsed;
+    }
 
     /// @brief Encodes the given string using the URI/URL encoding.
     static auto encode_component(const string_view) noexcept -> std::string;
@@ -304,9 +534,7 @@ public:
 private:
     friend class url_query_args;
 
-    url(std::string, std::match_results<std::string::iterator>) noexcept;
-
-    using _range = std::pair<span_size_t, span_size_t>;
+    using _range = url_components::range;
 
     auto _sw(_range r) const noexcept -> string_view;
     auto _swov(_range r) const noexcept -> valid_if_not_empty<string_view>;
@@ -319,13 +547,6 @@ private:
     auto _arg_value(const string_view name) const noexcept
       -> optionally_valid<string_view>;
 
-    void _cover(
-      _range& part,
-      const std::match_results<std::string::iterator>& match,
-      const std::size_t index) const noexcept;
-
-    static auto _get_regex() noexcept -> const std::regex&;
-
     std::string _url_str;
 
     _range _scheme;
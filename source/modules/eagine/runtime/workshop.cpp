@@ -41,6 +41,11 @@ export class workshop;
 export template <typename Function>
 struct inplace_work_unit : latched_work_unit {
     inplace_work_unit(workshop& w, std::latch& l, Function function) noexcept;
+    inplace_work_unit(
+      workshop& w,
+      std::latch& l,
+      Function function,
+      span_size_t worker_hint) noexcept;
 
     auto do_it() noexcept -> bool final {
         return _function();
@@ -64,7 +69,7 @@ public:
       : _completed{limit_cast<std::ptrdiff_t>(size)} {
         _units.reserve(size);
         for(const auto i : integer_range(size)) {
-            _units.emplace_back(ws, _completed, function);
+            _units.emplace_back(ws, _completed, function, span_size(i));
         }
     }
 
@@ -83,31 +88,49 @@ private:
 export template <typename Function>
 inplace_work_batch(workshop&, const Function&) -> inplace_work_batch<Function>;
 //------------------------------------------------------------------------------
+/// @brief Enumeration of work unit scheduling strategies of a workshop.
+/// @see workshop
+export enum class workshop_scheduling : std::uint8_t {
+    /// @brief All workers take work from a single shared locked queue.
+    shared_queue,
+    /// @brief Each worker has its own queue and idle workers steal work.
+    ///
+    /// Work enqueued from a worker goes to that worker's lock-free deque,
+    /// other work goes to a shared injection queue. Idle workers first spin
+    /// and steal from the other workers and then park until more work comes.
+    work_stealing
+};
+//------------------------------------------------------------------------------
+class work_stealing_scheduler;
 export class workshop {
 private:
     std::vector<std::thread> _workers{};
     std::queue<work_unit*> _work_queue{};
     std::mutex _queue_lockable{};
     std::condition_variable _cond{};
+    std::unique_ptr<work_stealing_scheduler> _stealing{};
     bool _shutdown{false};
 
     auto _fetch() noexcept -> std::tuple<optional_reference<work_unit>, bool>;
     void _employ() noexcept;
+    void _ensure_some_workers();
 
 public:
-    workshop() noexcept = default;
+    /// @brief Constructs a workshop using the shared queue scheduling.
+    workshop() noexcept;
+
+    /// @brief Constructs a workshop using the specified scheduling.
+    workshop(workshop_scheduling);
+
     workshop(workshop&&) = delete;
     workshop(const workshop&) = delete;
     auto operator=(workshop&&) = delete;
     auto operator=(const workshop&) = delete;
 
-    ~workshop() noexcept {
-        try {
-            shutdown();
-            wait_until_closed();
-        } catch(...) {
-        }
-    }
+    ~workshop() noexcept;
+
+    /// @brief Returns the work unit scheduling strategy of this workshop.
+    auto scheduling() const noexcept -> workshop_scheduling;
 
     auto shutdown() noexcept -> workshop&;
 
@@ -124,6 +147,19 @@ public:
     auto release_worker() noexcept -> workshop&;
 
     auto enqueue(work_unit& work) -> workshop&;
+
+    /// @brief Enqueues work, preferably for the worker with the given index.
+    /// @note The hint is ignored by the shared queue scheduling and other
+    ///       workers can still take the work if the preferred one is busy.
+    auto enqueue(work_unit& work, span_size_t worker_hint) -> workshop&;
+
+    /// @brief Runs one of the enqueued work units in the calling thread.
+    /// @returns false if there was no work to run.
+    ///
+    /// Threads waiting for enqueued work to finish can use this to help
+    /// with the work instead of blocking, for example when all workers
+    /// are waiting for such work too.
+    auto help() noexcept -> bool;
 };
 //------------------------------------------------------------------------------
 template <typename Function>
@@ -136,5 +172,16 @@ inplace_work_unit<Function>::inplace_work_unit(
     w.enqueue(*this);
 }
 //------------------------------------------------------------------------------
+template <typename Function>
+inplace_work_unit<Function>::inplace_work_unit(
+  workshop& w,
+  std::latch& l,
+  Function function,
+  span_size_t worker_hint) noexcept
+  : latched_work_unit{l}
+  , _function{std::move(function)} {
+    w.enqueue(*this, worker_hint);
+}
+//------------------------------------------------------------------------------
 } // namespace eagine
 
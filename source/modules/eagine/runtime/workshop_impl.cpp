@@ -12,6 +12,412 @@ import eagine.core.types;
 
 namespace eagine {
 //------------------------------------------------------------------------------
+// work_unit_deque
+//------------------------------------------------------------------------------
+// Fixed-capacity Chase-Lev deque. The owning worker pushes and pops work
+// at the bottom end, other workers steal work from the top end.
+class work_unit_deque {
+public:
+    auto push(work_unit* work) noexcept -> bool {
+        const auto b{_bottom.load(std::memory_order_relaxed)};
+        const auto t{_top.load(std::memory_order_acquire)};
+        if(b - t >= _capacity) {
+            return false;
+        }
+        _items[std_size(b & _mask)].store(work, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    auto pop() noexcept -> work_unit* {
+        const auto b{_bottom.load(std::memory_order_relaxed) - 1};
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t{_top.load(std::memory_order_relaxed)};
+        if(t > b) {
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        auto* work{_items[std_size(b & _mask)].load(std::memory_order_relaxed)};
+        if(t == b) {
+            // the last item, race with the thieves for it
+            if(not _top.compare_exchange_strong(
+                 t,
+                 t + 1,
+                 std::memory_order_seq_cst,
+                 std::memory_order_relaxed)) {
+                work = nullptr;
+            }
+            _bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return work;
+    }
+
+    auto steal() noexcept -> work_unit* {
+        auto t{_top.load(std::memory_order_acquire)};
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto b{_bottom.load(std::memory_order_acquire)};
+        if(t >= b) {
+            return nullptr;
+        }
+        auto* work{_items[std_size(t & _mask)].load(std::memory_order_acquire)};
+        if(not _top.compare_exchange_strong(
+             t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return work;
+    }
+
+    auto is_empty() const noexcept -> bool {
+        return _bottom.load(std::memory_order_seq_cst) <=
+               _top.load(std::memory_order_seq_cst);
+    }
+
+private:
+    static constexpr const std::int64_t _capacity{1024};
+    static constexpr const std::int64_t _mask{_capacity - 1};
+
+    alignas(64) std::atomic<std::int64_t> _top{0};
+    alignas(64) std::atomic<std::int64_t> _bottom{0};
+    std::array<std::atomic<work_unit*>, std_size(_capacity)> _items{};
+};
+//------------------------------------------------------------------------------
+// locked_work_queue
+//------------------------------------------------------------------------------
+// Locked FIFO queue with a lock-free emptiness check, used as the injection
+// queue and for work with affinity hints.
+class locked_work_queue {
+public:
+    void push(work_unit* work) {
+        const std::lock_guard lock{_lockable};
+        _queue.push_back(work);
+        _size.store(_queue.size(), std::memory_order_seq_cst);
+    }
+
+    auto pop() noexcept -> work_unit* {
+        work_unit* work{nullptr};
+        pop_some({&work, 1U}, 1U);
+        return work;
+    }
+
+    // pops about one n-th of the queued work units, at most dest.size()
+    auto pop_some(std::span<work_unit*> dest, std::size_t n) noexcept
+      -> std::size_t {
+        if(is_empty()) {
+            return 0U;
+        }
+        const std::lock_guard lock{_lockable};
+        const auto count{std::min(dest.size(), (_queue.size() + n - 1U) / n)};
+        std::copy_n(_queue.begin(), count, dest.begin());
+        _queue.erase(_queue.begin(), _queue.begin() + std::ptrdiff_t(count));
+        _size.store(_queue.size(), std::memory_order_seq_cst);
+        return count;
+    }
+
+    auto is_empty() const noexcept -> bool {
+        return _size.load(std::memory_order_seq_cst) == 0U;
+    }
+
+private:
+    std::mutex _lockable;
+    std::deque<work_unit*> _queue;
+    std::atomic<std::size_t> _size{0U};
+};
+//------------------------------------------------------------------------------
+// work_stealing_scheduler
+//------------------------------------------------------------------------------
+class work_stealing_scheduler {
+public:
+    static constexpr const std::size_t no_worker{~std::size_t(0U)};
+
+    work_stealing_scheduler() noexcept = default;
+    work_stealing_scheduler(work_stealing_scheduler&&) = delete;
+    work_stealing_scheduler(const work_stealing_scheduler&) = delete;
+    auto operator=(work_stealing_scheduler&&) = delete;
+    auto operator=(const work_stealing_scheduler&) = delete;
+    ~work_stealing_scheduler() noexcept;
+
+    auto worker_count() const noexcept -> std::size_t {
+        return _count.load(std::memory_order_acquire);
+    }
+
+    auto add_worker() -> std::size_t;
+
+    void run(std::size_t index) noexcept;
+    void enqueue(work_unit& work);
+    void enqueue(work_unit& work, std::size_t worker_hint);
+    auto help() noexcept -> bool;
+    void shutdown() noexcept;
+    void wait_until_idle() noexcept;
+
+private:
+    struct _worker {
+        work_unit_deque deque;
+        locked_work_queue hinted;
+    };
+
+    struct _binding {
+        work_stealing_scheduler* scheduler{nullptr};
+        std::size_t index{no_worker};
+    };
+
+    static thread_local _binding _current;
+
+    // null for workers without own queues and for slots of workers
+    // that are being added
+    auto _own_worker(std::size_t index) const noexcept -> _worker* {
+        return index < _max_workers
+                 ? _workers[index].load(std::memory_order_acquire)
+                 : nullptr;
+    }
+
+    auto _victim_count() const noexcept -> std::size_t {
+        return std::min(worker_count(), _max_workers);
+    }
+
+    auto _find_work(std::size_t index) noexcept -> work_unit*;
+    auto _take_injected(std::size_t index) noexcept -> work_unit*;
+    auto _steal(std::size_t index) noexcept -> work_unit*;
+    auto _has_work() const noexcept -> bool;
+    void _execute(work_unit& work) noexcept;
+    void _park() noexcept;
+    void _notify_work() noexcept;
+
+    static constexpr const unsigned _spin_count{64U};
+    static constexpr const std::size_t _injected_batch{16U};
+    static constexpr const std::size_t _max_workers{256U};
+
+    // the queues of each worker are allocated when the worker is added
+    std::array<std::atomic<_worker*>, _max_workers> _workers{};
+    std::atomic<std::size_t> _count{0U};
+    locked_work_queue _injected;
+    alignas(64) std::atomic<std::size_t> _pending{0U};
+    alignas(64) std::atomic<std::uint32_t> _wake_sequence{0U};
+    std::atomic<std::size_t> _sleeping{0U};
+    std::atomic<bool> _shutdown{false};
+};
+//------------------------------------------------------------------------------
+thread_local work_stealing_scheduler::_binding
+  work_stealing_scheduler::_current{};
+//------------------------------------------------------------------------------
+work_stealing_scheduler::~work_stealing_scheduler() noexcept {
+    for(auto& worker : _workers) {
+        delete worker.load(std::memory_order_relaxed);
+    }
+}
+//------------------------------------------------------------------------------
+auto work_stealing_scheduler::add_worker() -> std::size_t {
+    // workers over the maximum have no own queues, but they still
+    // take injected work and steal work from the other workers
+    std::unique_ptr<_worker> worker;
+    if(worker_count() < _max_workers) {
+        worker = std::make_unique<_worker>();
+    }
+    const auto index{_count.fetch_add(1U, std::memory_order_acq_rel)};
+    if(index < _max_workers) {
+        _workers[index].store(worker.release(), std::memory_order_release);
+        return index;
+    }
+    return no_worker;
+}
+//------------------------------------------------------------------------------
+void work_stealing_scheduler::_notify_work() noexcept {
+    // pairs with the fence in _park, either the parking worker sees the new
+    // work or this sees the parking worker
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(_sleeping.load(std::memory_order_relaxed) > 0U) {
+        _wake_sequence.fetch_add(1U, std::memory_order_release);
+        _wake_sequence.notify_one();
+    }
+}
+//------------------------------------------------------------------------------
+void work_stealing_scheduler::enqueue(work_unit& work) {
+    _pending.fetch_add(1U, std::memory_order_relaxed);
+    const auto [scheduler, index] = _current;
+    const auto own{scheduler == this ? _own_worker(index) : nullptr};
+    if(not own or not own->deque.push(&work)) {
+        _injected.push(&work);
+    }
+    _notify_work();
+}
+//------------------------------------------------------------------------------
+void work_stealing_scheduler::enqueue(
+  work_unit& work,
+  std::size_t worker_hint) {
+    const auto count{_victim_count()};
+    const auto hinted{
+      count > 0U ? _own_worker(worker_hint % count) : nullptr};
+    if(not hinted) [[unlikely]] {
+        enqueue(work);
+        return;
+    }
+    _pending.fetch_add(1U, std::memory_order_relaxed);
+    hinted->hinted.push(&work);
+    _notify_work();
+}
+//------------------------------------------------------------------------------
+auto work_stealing_scheduler::_take_injected(std::size_t index) noexcept
+  -> work_unit* {
+    // take a fair share of the injected work at once, so that the other
+    // workers steal the rest from this worker instead of queuing on the lock
+    std::array<work_unit*, _injected_batch> batch{};
+    const auto own{_own_worker(index)};
+    const auto count{_injected.pop_some(
+      std::span<work_unit*>{batch}.first(own ? batch.size() : 1U),
+      std::max(_victim_count(), std::size_t(1U)))};
+    for(std::size_t i = 1U; i < count; ++i) {
+        if(not own->deque.push(batch[i])) {
+            try {
+                _injected.push(batch[i]);
+            } catch(...) {
+                _execute(*batch[i]);
+            }
+        }
+    }
+    return count > 0U ? batch.front() : nullptr;
+}
+//------------------------------------------------------------------------------
+auto work_stealing_scheduler::_steal(std::size_t index) noexcept
+  -> work_unit* {
+    const auto count{_victim_count()};
+    for(std::size_t i = 1U; i <= count; ++i) {
+        const auto victim{(index + i) % count};
+        if(victim == index) {
+            continue;
+        }
+        if(const auto other{_own_worker(victim)}) {
+            if(auto* work{other->deque.steal()}) {
+                return work;
+            }
+            if(auto* work{other->hinted.pop()}) {
+                return work;
+            }
+        }
+    }
+    return nullptr;
+}
+//------------------------------------------------------------------------------
+auto work_stealing_scheduler::_find_work(std::size_t index) noexcept
+  -> work_unit* {
+    if(const auto own{_own_worker(index)}) {
+        if(auto* work{own->deque.pop()}) {
+            return work;
+        }
+        if(auto* work{own->hinted.pop()}) {
+            return work;
+        }
+    }
+    if(auto* work{_take_injected(index)}) {
+        return work;
+    }
+    return _steal(index);
+}
+//------------------------------------------------------------------------------
+auto work_stealing_scheduler::_has_work() const noexcept -> bool {
+    if(not _injected.is_empty()) {
+        return true;
+    }
+    for(std::size_t i = 0U; i < _victim_count(); ++i) {
+        if(const auto worker{_own_worker(i)}) {
+            if(not worker->deque.is_empty() or not worker->hinted.is_empty()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+void work_stealing_scheduler::_execute(work_unit& work) noexcept {
+    while(not work.do_it()) {
+        // put unfinished work to the back of the injection queue so that
+        // it does not starve the other work in the local deque
+        try {
+            _injected.push(&work);
+            return;
+        } catch(...) {
+        }
+    }
+    work.deliver();
+    if(_pending.fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+        _pending.notify_all();
+    }
+}
+//------------------------------------------------------------------------------
+void work_stealing_scheduler::_park() noexcept {
+    _sleeping.fetch_add(1U, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto seen{_wake_sequence.load(std::memory_order_acquire)};
+    if(not _has_work() and not _shutdown.load(std::memory_order_acquire)) {
+        _wake_sequence.wait(seen, std::memory_order_acquire);
+    }
+    _sleeping.fetch_sub(1U, std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+void work_stealing_scheduler::run(std::size_t index) noexcept {
+    _current = {this, index};
+    unsigned idle{0U};
+    while(not _shutdown.load(std::memory_order_acquire)) {
+        if(auto* work{_find_work(index)}) {
+            _execute(*work);
+            idle = 0U;
+        } else if(idle < _spin_count) {
+            std::this_thread::yield();
+            ++idle;
+        } else {
+            _park();
+            idle = 0U;
+        }
+    }
+    _current = {};
+}
+//------------------------------------------------------------------------------
+auto work_stealing_scheduler::help() noexcept -> bool {
+    const auto [scheduler, index] = _current;
+    if(auto* work{_find_work(scheduler == this ? index : no_worker)}) {
+        _execute(*work);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+void work_stealing_scheduler::shutdown() noexcept {
+    _shutdown.store(true, std::memory_order_release);
+    _wake_sequence.fetch_add(1U, std::memory_order_release);
+    _wake_sequence.notify_all();
+}
+//------------------------------------------------------------------------------
+void work_stealing_scheduler::wait_until_idle() noexcept {
+    auto pending{_pending.load(std::memory_order_acquire)};
+    while(pending != 0U) {
+        _pending.wait(pending, std::memory_order_acquire);
+        pending = _pending.load(std::memory_order_acquire);
+    }
+}
+//------------------------------------------------------------------------------
+// workshop
+//------------------------------------------------------------------------------
+workshop::workshop() noexcept = default;
+//------------------------------------------------------------------------------
+workshop::workshop(workshop_scheduling scheduling) {
+    if(scheduling == workshop_scheduling::work_stealing) {
+        _stealing = std::make_unique<work_stealing_scheduler>();
+    }
+}
+//------------------------------------------------------------------------------
+workshop::~workshop() noexcept {
+    try {
+        shutdown();
+        wait_until_closed();
+    } catch(...) {
+    }
+}
+//------------------------------------------------------------------------------
+auto workshop::scheduling() const noexcept -> workshop_scheduling {
+    return _stealing ? workshop_scheduling::work_stealing
+                     : workshop_scheduling::shared_queue;
+}
+//------------------------------------------------------------------------------
 auto workshop::_fetch() noexcept
   -> std::tuple<optional_reference<work_unit>, bool> {
     optional_reference<work_unit> work;
@@ -47,6 +453,9 @@ void workshop::_employ() noexcept {
 }
 //------------------------------------------------------------------------------
 auto workshop::shutdown() noexcept -> workshop& {
+    if(_stealing) {
+        _stealing->shutdown();
+    }
     if(const std::lock_guard lock{_queue_lockable}; true) {
         _shutdown = true;
         _cond.notify_all();
@@ -62,13 +471,22 @@ auto workshop::wait_until_closed() noexcept -> workshop& {
 }
 //------------------------------------------------------------------------------
 auto workshop::wait_until_idle() noexcept -> workshop& {
+    if(_stealing) {
+        _stealing->wait_until_idle();
+        return *this;
+    }
     std::unique_lock lock{_queue_lockable};
     _cond.wait(lock, [this]() { return _work_queue.empty(); });
     return *this;
 }
 //------------------------------------------------------------------------------
 auto workshop::add_worker() -> workshop& {
-    _workers.emplace_back([this]() { this->_employ(); });
+    if(_stealing) {
+        const auto index{_stealing->add_worker()};
+        _workers.emplace_back([this, index]() { _stealing->run(index); });
+    } else {
+        _workers.emplace_back([this]() { this->_employ(); });
+    }
     return *this;
 }
 //------------------------------------------------------------------------------
@@ -97,16 +515,61 @@ auto workshop::release_worker() noexcept -> workshop& {
     return *this;
 }
 //------------------------------------------------------------------------------
-auto workshop::enqueue(work_unit& work) -> workshop& {
-    const std::lock_guard lock{_queue_lockable};
+void workshop::_ensure_some_workers() {
     if(_workers.empty()) [[unlikely]] {
         ensure_workers(std::max(
           span_size(std::thread::hardware_concurrency() / 2), span_size(2)));
     }
+}
+//------------------------------------------------------------------------------
+auto workshop::enqueue(work_unit& work) -> workshop& {
+    if(_stealing) {
+        if(_stealing->worker_count() == 0U) [[unlikely]] {
+            const std::lock_guard lock{_queue_lockable};
+            _ensure_some_workers();
+        }
+        _stealing->enqueue(work);
+        return *this;
+    }
+    const std::lock_guard lock{_queue_lockable};
+    _ensure_some_workers();
     _work_queue.push(&work);
     _cond.notify_one();
     return *this;
 }
 //------------------------------------------------------------------------------
+auto workshop::enqueue(work_unit& work, span_size_t worker_hint) -> workshop& {
+    if(_stealing) {
+        if(_stealing->worker_count() == 0U) [[unlikely]] {
+            const std::lock_guard lock{_queue_lockable};
+            _ensure_some_workers();
+        }
+        _stealing->enqueue(work, std_size(worker_hint));
+        return *this;
+    }
+    return enqueue(work);
+}
+//------------------------------------------------------------------------------
+auto workshop::help() noexcept -> bool {
+    if(_stealing) {
+        return _stealing->help();
+    }
+    work_unit* work{nullptr};
+    if(const std::lock_guard lock{_queue_lockable}; true) {
+        if(_work_queue.empty()) {
+            return false;
+        }
+        work = _work_queue.front();
+        _work_queue.pop();
+    }
+    if(work->do_it()) {
+        const std::lock_guard lock{_queue_lockable};
+        work->deliver();
+        _cond.notify_all();
+    } else {
+        enqueue(*work);
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
 } // namespace eagine
-
@@ -0,0 +1,158 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin.hpp>
+import std;
+import eagine.core.types;
+import eagine.core.runtime;
+//------------------------------------------------------------------------------
+constexpr const std::array<eagine::workshop_scheduling, 2> schedulings{
+  eagine::workshop_scheduling::shared_queue,
+  eagine::workshop_scheduling::work_stealing};
+//------------------------------------------------------------------------------
+// Work unit that enqueues child units recursively and can ask to be
+// re-scheduled a specified number of times before it is done.
+struct workshop_test_unit : eagine::latched_work_unit {
+    workshop_test_unit(
+      eagine::workshop& w,
+      std::latch& l,
+      std::atomic<int>& done,
+      int depth,
+      int retries) noexcept
+      : latched_work_unit{l}
+      , _workshop{w}
+      , _latch{l}
+      , _done{done}
+      , _depth{depth}
+      , _retries{retries} {}
+
+    auto do_it() noexcept -> bool final {
+        if(_retries > 0) {
+            --_retries;
+            return false;
+        }
+        if(_depth > 0) {
+            for(auto& child : _children) {
+                child = std::make_unique<workshop_test_unit>(
+                  _workshop, _latch, _done, _depth - 1, 0);
+                _workshop.enqueue(*child);
+            }
+        }
+        _done.fetch_add(1);
+        return true;
+    }
+
+    static constexpr auto count(int depth) noexcept -> int {
+        return (1 << (depth + 1)) - 1;
+    }
+
+private:
+    eagine::workshop& _workshop;
+    std::latch& _latch;
+    std::atomic<int>& _done;
+    std::array<std::unique_ptr<workshop_test_unit>, 2> _children;
+    const int _depth;
+    int _retries;
+};
+//------------------------------------------------------------------------------
+void workshop_inplace_batch(auto& s) {
+    eagitest::case_ test{s, 1, "inplace batch"};
+
+    for(const auto scheduling : schedulings) {
+        eagine::workshop workers{scheduling};
+        test.check(workers.scheduling() == scheduling, "scheduling");
+        workers.ensure_workers(4);
+
+        for(const std::size_t size : {1U, 4U, 100U, 5000U}) {
+            std::atomic<std::size_t> done{0U};
+            const auto func{[&] {
+                done.fetch_add(1U);
+                return true;
+            }};
+            {
+                eagine::inplace_work_batch batch{workers, size, func};
+            }
+            test.check_equal(done.load(), size, "all done");
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void workshop_nested(auto& s) {
+    eagitest::case_ test{s, 2, "nested"};
+
+    const int depth{9};
+    for(const auto scheduling : schedulings) {
+        eagine::workshop workers{scheduling};
+        workers.ensure_workers(3);
+
+        std::atomic<int> done{0};
+        std::latch completed{workshop_test_unit::count(depth)};
+        workshop_test_unit root{workers, completed, done, depth, 0};
+        workers.enqueue(root);
+        completed.wait();
+        workers.wait_until_idle();
+        test.check_equal(
+          done.load(), workshop_test_unit::count(depth), "all done");
+    }
+}
+//------------------------------------------------------------------------------
+void workshop_unfinished(auto& s) {
+    eagitest::case_ test{s, 3, "unfinished"};
+    auto& rg{test.random()};
+
+    for(const auto scheduling : schedulings) {
+        eagine::workshop workers{scheduling};
+        workers.ensure_workers(2);
+
+        const int count{50};
+        std::atomic<int> done{0};
+        std::latch completed{count};
+        std::vector<std::optional<workshop_test_unit>> units(count);
+        for(auto& unit : units) {
+            unit.emplace(workers, completed, done, 0, rg.get_int(0, 10));
+            workers.enqueue(*unit);
+        }
+        completed.wait();
+        test.check_equal(done.load(), count, "all done");
+    }
+}
+//------------------------------------------------------------------------------
+void workshop_worker_hint(auto& s) {
+    eagitest::case_ test{s, 4, "worker hint"};
+
+    for(const auto scheduling : schedulings) {
+        eagine::workshop workers{scheduling};
+        workers.ensure_workers(4);
+
+        const int count{200};
+        std::atomic<int> done{0};
+        std::latch completed{count};
+        std::vector<std::optional<workshop_test_unit>> units(count);
+        eagine::span_size_t hint{0};
+        for(auto& unit : units) {
+            unit.emplace(workers, completed, done, 0, 0);
+            workers.enqueue(*unit, hint++);
+        }
+        completed.wait();
+        workers.wait_until_idle();
+        test.check_equal(done.load(), count, "all done");
+    }
+}
+//------------------------------------------------------------------------------
+// main
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagitest::suite test{argc, argv, "workshop", 4};
+    test.once(workshop_inplace_batch);
+    test.once(workshop_nested);
+    test.once(workshop_unfinished);
+    test.once(workshop_worker_hint);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end.hpp>
@@ -232,9 +232,18 @@ export struct compound_interface : interface<compound_interface> {
       span<std::string> dest) -> span_size_t = 0;
 };
 //------------------------------------------------------------------------------
-struct value_tree_stream_parser : interface<value_tree_stream_parser> {
+/// @brief Interface for incremental parsers of value tree data streams.
+/// @ingroup valtree
+/// @see value_tree_stream_input
+export struct value_tree_stream_parser : interface<value_tree_stream_parser> {
+    /// @brief Called once before the first chunk of data is parsed.
     virtual auto begin() noexcept -> bool = 0;
+
+    /// @brief Parses the next chunk of stream data.
+    /// @see finish
     virtual auto parse_data(memory::const_block data) noexcept -> bool = 0;
+
+    /// @brief Called once after the last chunk of data was parsed.
     virtual auto finish() noexcept -> bool = 0;
 };
 //------------------------------------------------------------------------------
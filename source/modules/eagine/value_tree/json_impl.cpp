@@ -863,6 +863,13 @@ public:
             _current = skip(_current, _offs);
             _done += _offs;
             _offs = 0;
+        } else if(_offs > 0) {
+            // drop the already parsed prefix, keep only the pending tail
+            const auto rest{sz - _offs};
+            std::copy_n(_previous.data() + _offs, rest, _previous.data());
+            _previous.resize(rest);
+            _done += _offs;
+            _offs = 0;
         }
         if(not _current.empty()) {
             append_to(_current, _previous);
@@ -901,7 +908,11 @@ private:
     span_size_t _offs{0};
 };
 //------------------------------------------------------------------------------
-// TODO: actual progressive parsing of the individual chunks
+// The rapidjson reader state is kept across the parse_data calls and each
+// incoming chunk is parsed in-place as long as there is at least the maximum
+// token size of input available. Only the unparsed tail is carried over into
+// the next call, so the retained input is bounded by the maximum token size
+// plus the size of the last chunk, regardless of the length of the stream.
 class json_value_tree_stream_parser
   : public value_tree_stream_parser
   , public rapidjson::